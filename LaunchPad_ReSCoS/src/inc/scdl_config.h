@@ -0,0 +1,80 @@
+/*
+ * scdl_config.h
+ *
+ *  Scheduler configuration for the MSP430 LaunchPad.
+ */
+
+/*! @file */
+
+#ifndef SCDL_CONFIG_H_
+#define SCDL_CONFIG_H_
+
+/** maximum number of tasks */
+#define SCDL_MAX_NUM_TASKS		(12)
+
+/** tick period in us, task periods are counted in ticks */
+#define SCDL_TICK_US			(1000UL)
+
+/** endless loop on failed asserts */
+#define SCDL_ASSERTS_ON
+
+/** record the longest interrupts disabled time, see ulScdlGetMaxIrqOff */
+//#define SCDL_MEASURE_IRQ_OFF
+
+/** paint the stack and record its peak use and each task's depth, see scdl_stack.h */
+//#define SCDL_MEASURE_STACK
+
+/** count wake ups, sleep and task run times, see vScdlGetActivity */
+//#define SCDL_MEASURE_ACTIVITY
+
+/** header with tracing hooks, define the SCDL_HOOK_... macros of scheduler.h here */
+//#define SCDL_HOOKS_INCLUDE		"inc/trace.h"
+
+/** enter LPM0 while no task is ready */
+//#define SCDL_IDLE_SLEEP
+
+/** tasks marked by vTaskSetUrgent preempt the others, uses the port 2 vector */
+//#define SCDL_URGENT_TASKS
+
+/** earliest deadline first instead of task ID order, see vTaskSetDeadline */
+//#define SCDL_EDF
+
+/** priorities by period (rate monotonic) or vTaskSetDeadline instead of the creation order */
+//#define SCDL_AUTO_PRIO
+
+/** release successor tasks on completion, see vTaskChain */
+//#define SCDL_TASK_CHAINS
+
+/** operating modes with their own task set and periods, see vSetMode */
+//#define SCDL_MODES
+
+/** software timers of scdl_timer.c, serviced by a task running vTaskScdlTimers */
+//#define SCDL_TIMERS
+
+/** fixed-block memory pools of scdl_pool.c */
+//#define SCDL_POOLS
+
+/** tear-free ISR to task data of scdl_snapshot.c */
+//#define SCDL_SNAPSHOTS
+
+/** publish/subscribe topics of scdl_topic.c */
+//#define SCDL_TOPICS
+
+/** deferred initialization and boot times of scdl_boot.c */
+//#define SCDL_BOOT_STAGES
+
+/** task set fixed at build time, see SCDL_TASK_TABLE in scheduler.h */
+#define SCDL_STATIC_TASKS
+/** periods in flash too, vTaskSetPeriod is not available then */
+//#define SCDL_CONST_PERIODS
+
+/** tasks in priority order: ID, function, period in ticks */
+#define SCDL_TASK_TABLE(TASK)																\
+	TASK(TID_TASK1,		Task1,				SCDL_MS_TO_TICKS(1000))							\
+	TASK(TID_TASK2,		Task2,				SCDL_MS_TO_TICKS(250))							\
+	TASK(TID_VCOM,		vTaskVCOMBuffered,	SCDL_MS_TO_TICKS(50))
+
+/** SMCLK, clock of the tick timer, set up in msp_init */
+#define SCDL_PORT_SMCLK_HZ		(8000000UL)
+
+#endif /* SCDL_CONFIG_H_ */
@@ -14,24 +14,19 @@
 
 #include "inc/scheduler.h"
 #include "inc/vcom.h"
+#include "scdl_port.h"
 
 
-/* local tasks */
-static void Task1(void);
-static void Task2(void);
 /* init */
 static void msp_init(void);
-static void vInitSystickTimer(void);
 /* handler for received bytes -> must be set with "setByteReceivedHandler(...)" defined in vcom */
 static void ByteReceived(unsigned char b);
 
-/* task ids can be used to manipulate tasks, set to SCDL_NA to prevent faults */
-taskID_t tidTask2 = SCDL_NA;
-
 /*! **********************************************************************************
  * @fn		main
  *
  * @brief	minimal example for presenting how the scheduler works on the MSP-LaunchPad
+ * 			the tasks are defined at build time by SCDL_TASK_TABLE in scdl_config.h
  * 			Task1 toggles LED1 with period of 1000ms
  * 			Task2 toggles LED2 with period of 250ms
  * 			vTaskVCOMBuffered handles bytes sent on debug uart
@@ -47,16 +42,15 @@ int main(void)
 {
 	/* init wdt and osc */
 	msp_init();
-	/* init timer to generate a 1ms interrupt */
-	vInitSystickTimer();
+	/* spread the first releases before the first tick, all tasks would be released together every second */
+	vTaskSetPhase(TID_TASK2, 1);
+	vTaskSetPhase(TID_VCOM, 2);
+	/* init timer to generate the tick interrupt */
+	vScdlPortTickInit();
 	/* enable interrupts */
 	__bis_SR_register(GIE);
 
 
-	/* create some tasks */
-	tidCreateTask(Task1, 1000);
-	tidTask2 = tidCreateTask(Task2, 250);
-	tidCreateTask(vTaskVCOMBuffered, 50);
 	/* set an event handler for receiving bytes */
 	setByteReceivedHandler(ByteReceived);
 
@@ -88,19 +82,19 @@ static void ByteReceived(unsigned char b)
 	switch(b)
 	{
 	case '1':
-		vTaskSetState(tidTask2, OFF);
+		vTaskSetState(TID_TASK2, OFF);
 		ucVCOM_LogString("OFF\n",4);
 		break;
 	case '2':
-		vTaskSetState(tidTask2, READY);
+		vTaskSetState(TID_TASK2, READY);
 		ucVCOM_LogString("READY\n",6);
 		break;
 	case '3':
-		vTaskInvokeDelayed(tidTask2, 2000);
+		vTaskInvokeDelayed(TID_TASK2, SCDL_MS_TO_TICKS(2000));
 		ucVCOM_LogString("DELAY\n",6);
 		break;
 	case '4':
-		vTaskSetPeriod(tidTask2, 500);
+		vTaskSetPeriod(TID_TASK2, SCDL_MS_TO_TICKS(500));
 		ucVCOM_LogString("PERIOD\n",7);
 		break;
 	}
@@ -115,20 +109,3 @@ void msp_init(void)
 	DCOCTL  = CALDCO_8MHZ;
 	BCSCTL1 = CALBC1_8MHZ;
 }
-
-void vInitSystickTimer(void)
-{
-  	//compare interrupt
-	TACCTL0 |= CCIE;
-	//set timer compare to 1000d -> 1/8MHz * 8 * 1000 = 1ms
-	TACCR0 = 1000;
-	//configure timer A with subsystemclock and up-mode
-	TACTL = TASSEL_2 | MC_1 | ID0 | ID1;
-}
-
-#pragma vector=TIMER0_A0_VECTOR
-__interrupt void Timer0_A0 (void)
-{
-	/* function must be called every ms */
-	vScdlTick1ms();
-}
@@ -0,0 +1,45 @@
+/******************************************************************************
+ *
+ * qemu_ccs.cmd - CCS linker configuration for the benchmark firmware, memory
+ *                map of the LM3S6965 modelled by QEMU's lm3s6965evb machine.
+ *
+ *****************************************************************************/
+
+--retain=g_pfnVectors
+
+/* --heap_size=0                                                             */
+/* --stack_size=1024                                                         */
+/* --library=rtsv7M3_T_le_eabi.lib                                           */
+
+#define APP_BASE 0x00000000
+#define RAM_BASE 0x20000000
+
+/* System memory map */
+
+MEMORY
+{
+    /* Application stored in and executes from internal flash */
+    FLASH (RX) : origin = APP_BASE, length = 0x00040000
+    /* Application uses internal RAM for data */
+    SRAM (RWX) : origin = 0x20000000, length = 0x00010000
+}
+
+/* Section allocation in memory */
+
+SECTIONS
+{
+    .intvecs:   > APP_BASE
+    .text   :   > FLASH
+    .const  :   > FLASH
+    .cinit  :   > FLASH
+    .pinit  :   > FLASH
+    .init_array : > FLASH
+
+    .vtable :   > RAM_BASE
+    .data   :   > SRAM
+    .bss    :   > SRAM
+    .sysmem :   > SRAM
+    .stack  :   > SRAM
+}
+
+__STACK_TOP = __stack + 1024;
@@ -0,0 +1,26 @@
+/*
+ * scdl_config.h
+ *
+ *  Scheduler configuration of the QEMU benchmark firmware.
+ */
+
+/*! @file */
+
+#ifndef SCDL_CONFIG_H_
+#define SCDL_CONFIG_H_
+
+/** maximum number of tasks */
+#define SCDL_MAX_NUM_TASKS		(12)
+
+/** tick period in us, task periods are counted in ticks */
+#define SCDL_TICK_US			(1000UL)
+
+/** the idle hook drives the ticks, the SysTick is the free running benchmark counter */
+#define SCDL_IDLE_SLEEP
+void vBenchIdle(void);
+#define SCDL_PORT_IDLE_SLEEP()	{ vBenchIdle(); _enable_interrupts(); }
+
+/** internal oscillator after reset, the results are scaled by a nop loop anyway */
+#define SCDL_PORT_CPU_HZ		(12000000UL)
+
+#endif /* SCDL_CONFIG_H_ */
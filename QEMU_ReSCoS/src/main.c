@@ -0,0 +1,325 @@
+/*
+ * main.c
+ *
+ *  Benchmark firmware for QEMU's lm3s6965evb (Cortex-M3). Runs the scheduler
+ *  hot paths of the cm3 build and prints "name,tasks,cycles" lines like the
+ *  host benchmark over semihosting, then exits QEMU.
+ *
+ *  QEMU has no cycle counter, the SysTick runs free instead. Its counts are
+ *  scaled by a block of BENCH_NOPS nops, so results are in nop cycles: with
+ *  -icount they are executed instructions and deterministic, on hardware they
+ *  are CPU cycles. The debouncer of Stellaris_ReSCoS/src/debounce.c, which
+ *  the project builds as well, is compared to the counter of ButtonsPoll in
+ *  cycles per input and sample, the second column is the number of inputs.
+ *
+ *  	qemu-system-arm -M lm3s6965evb -nographic -semihosting \
+ *  		-icount shift=7,align=off -kernel QEMU_ReSCoS.out
+ */
+
+#include <setjmp.h>
+
+/* low level */
+#include "inc/hw_types.h"
+#include "inc/hw_nvic.h"
+/* driverlib */
+#include "driverlib/systick.h"
+/* project */
+#include "inc/scheduler.h"
+#include "inc/debounce.h"
+#include "scdl_port.h"
+
+/* ARM semihosting */
+#define SEMIHOST_SYS_WRITE0		(0x04)
+#define SEMIHOST_SYS_EXIT		(0x18)
+#define SEMIHOST_EXIT_OK		(0x20026)
+
+/** ticks per scheduler run */
+#define BENCH_TICKS				(1000)
+/** loops of the short benchmarks */
+#define BENCH_LOOPS				(1000)
+/** nops in vBenchNops, see semihost.asm */
+#define BENCH_NOPS				(1024)
+/** calibration runs, the fastest counts */
+#define BENCH_CALIBRATE			(16)
+/** bouncing input samples of the debouncer benchmark */
+#define BENCH_DBNC_SAMPLES		(256)
+#define BENCH_DBNC_WORDS		(2)
+/** depth of the ButtonsPoll counter */
+#define BENCH_DBNC_DEPTH		(4)
+
+/* the SysTick counts down over 24 bits */
+#define BENCH_COUNTER_MASK		(0x00FFFFFFUL)
+#define BENCH_READ()			(HWREG(NVIC_ST_CURRENT))
+#define BENCH_ELAPSED(s,e)		(((s) - (e)) & BENCH_COUNTER_MASK)
+
+unsigned long ulBenchSemihost(unsigned long ulOp, const void *pvArg);
+void vBenchNops(void);
+
+static jmp_buf g_tBenchExit;
+static unsigned long g_ulBenchTicks;
+static unsigned long g_ulBenchRuns;
+/** counts of a back to back read, and of vBenchNops */
+static unsigned long g_ulBenchReadCounts;
+static unsigned long g_ulBenchNopCounts;
+
+static unsigned long g_aulBenchDbnc[BENCH_DBNC_SAMPLES][BENCH_DBNC_WORDS];
+static unsigned long g_ulBenchSeed = 1;
+/* state and counter of ButtonsPoll */
+static unsigned char g_ucBenchButtons;
+static unsigned char g_ucBenchClockA;
+static unsigned char g_ucBenchClockB;
+
+static void vBenchPrint(const char *pcName, unsigned char ucTasks, unsigned long ulCounts, unsigned long ulOps)
+{
+	char acLine[48];
+	char acDigits[12];
+	unsigned long long ullValue;
+	unsigned char i = 0, n;
+
+	/* counts to nop cycles with one decimal */
+	ullValue = (unsigned long long)ulCounts * BENCH_NOPS * 10 / ((unsigned long long)g_ulBenchNopCounts * ulOps);
+
+	while(*pcName)
+		acLine[i++] = *pcName++;
+	acLine[i++] = ',';
+	if(ucTasks >= 10)
+		acLine[i++] = '0' + ucTasks / 10;
+	acLine[i++] = '0' + ucTasks % 10;
+	acLine[i++] = ',';
+
+	n = 0;
+	do
+	{
+		acDigits[n++] = '0' + (char)(ullValue % 10);
+		ullValue /= 10;
+	} while(ullValue || n < 2);
+	while(n > 1)
+		acLine[i++] = acDigits[--n];
+	acLine[i++] = '.';
+	acLine[i++] = acDigits[0];
+	acLine[i++] = '\n';
+	acLine[i] = 0;
+
+	ulBenchSemihost(SEMIHOST_SYS_WRITE0, acLine);
+}
+
+/* read overhead and scale */
+static void vBenchCalibrate(void)
+{
+	unsigned long ulStart, ulCounts;
+	unsigned char i;
+
+	g_ulBenchReadCounts = BENCH_COUNTER_MASK;
+	g_ulBenchNopCounts = BENCH_COUNTER_MASK;
+
+	for(i = 0; i < BENCH_CALIBRATE; i++)
+	{
+		ulStart = BENCH_READ();
+		ulCounts = BENCH_ELAPSED(ulStart, BENCH_READ());
+		if(ulCounts < g_ulBenchReadCounts)
+			g_ulBenchReadCounts = ulCounts;
+	}
+
+	for(i = 0; i < BENCH_CALIBRATE; i++)
+	{
+		ulStart = BENCH_READ();
+		vBenchNops();
+		ulCounts = BENCH_ELAPSED(ulStart, BENCH_READ());
+		if(ulCounts < g_ulBenchNopCounts)
+			g_ulBenchNopCounts = ulCounts;
+	}
+	g_ulBenchNopCounts -= g_ulBenchReadCounts;
+}
+
+/*
+ * idle sleep: the next tick is due at once, the whole run is timed like on the host
+ */
+void vBenchIdle(void)
+{
+	vScdlTick();
+
+	if(++g_ulBenchTicks >= BENCH_TICKS)
+		longjmp(g_tBenchExit, 1);
+}
+
+static void vBenchTask(void)
+{
+	g_ulBenchRuns++;
+}
+
+/* run ucTasks empty tasks of period ulPeriod for BENCH_TICKS ticks, returns the counts */
+static unsigned long ulBenchRun(unsigned char ucTasks, unsigned long ulPeriod)
+{
+	unsigned long ulStart;
+	unsigned char i;
+
+	vResetScheduler();
+	for(i = 0; i < ucTasks; i++)
+		tidCreateTask(vBenchTask, ulPeriod);
+
+	g_ulBenchTicks = 0;
+	g_ulBenchRuns = 0;
+
+	ulStart = BENCH_READ();
+	if(!setjmp(g_tBenchExit))
+		vStartScheduler();
+
+	return BENCH_ELAPSED(ulStart, BENCH_READ()) - g_ulBenchReadCounts;
+}
+
+/* same results as the host benchmark, see scdl_bench.c */
+static void vBenchScheduler(unsigned char ucTasks)
+{
+	/* all tasks released and run every tick */
+	unsigned long ulRelease = ulBenchRun(ucTasks, 1);
+	/* nothing due, only the release check */
+	unsigned long ulIdle = ulBenchRun(ucTasks, SCDL_MAX_TASK_PERIOD);
+
+	vBenchPrint("tick_release", ucTasks, ulRelease, BENCH_TICKS);
+	vBenchPrint("tick_idle", ucTasks, ulIdle, BENCH_TICKS);
+	/* what each task run adds */
+	vBenchPrint("dispatch", ucTasks, ulRelease - ulIdle, (unsigned long)BENCH_TICKS * ucTasks);
+}
+
+static void vBenchCreate(unsigned char ucTasks)
+{
+	unsigned long ulStart, ulCounts = 0;
+	unsigned short l;
+	unsigned char i;
+
+	for(l = 0; l < BENCH_LOOPS / SCDL_MAX_NUM_TASKS; l++)
+	{
+		vResetScheduler();
+		ulStart = BENCH_READ();
+		for(i = 0; i < ucTasks; i++)
+			tidCreateTask(vBenchTask, i + 1);
+		ulCounts += BENCH_ELAPSED(ulStart, BENCH_READ()) - g_ulBenchReadCounts;
+	}
+
+	vBenchPrint("create", ucTasks, ulCounts, (unsigned long)l * ucTasks);
+}
+
+static void vBenchSemaphores(void)
+{
+	volatile sema_t tSema = 0;
+	unsigned long ulStart, ulCounts;
+	unsigned short l;
+
+	ulStart = BENCH_READ();
+	for(l = 0; l < BENCH_LOOPS; l++)
+	{
+		SEMAPHORE_GIVE(tSema);
+		bSemaTake((sema_t *)&tSema);
+	}
+	ulCounts = BENCH_ELAPSED(ulStart, BENCH_READ()) - g_ulBenchReadCounts;
+	vBenchPrint("sema_give_take", 0, ulCounts, BENCH_LOOPS);
+
+	ulStart = BENCH_READ();
+	for(l = 0; l < BENCH_LOOPS; l++)
+	{
+		SEMAPHORE_CNT_GIVE(tSema);
+		bSemaCntTake((sema_t *)&tSema);
+	}
+	ulCounts = BENCH_ELAPSED(ulStart, BENCH_READ()) - g_ulBenchReadCounts;
+	vBenchPrint("sema_cnt_give_take", 0, ulCounts, BENCH_LOOPS);
+}
+
+/* the vertical counter of ButtonsPoll without the GPIO read */
+static unsigned char ucBenchButtonsPoll(unsigned char ucData)
+{
+	unsigned char ucDelta;
+
+	ucDelta = ucData ^ g_ucBenchButtons;
+
+	g_ucBenchClockA ^= g_ucBenchClockB;
+	g_ucBenchClockB = ~g_ucBenchClockB;
+
+	g_ucBenchClockA &= ucDelta;
+	g_ucBenchClockB &= ucDelta;
+
+	g_ucBenchButtons &= g_ucBenchClockA | g_ucBenchClockB;
+	g_ucBenchButtons |= (~(g_ucBenchClockA | g_ucBenchClockB)) & ucData;
+
+	return ucDelta ^ (g_ucBenchClockA | g_ucBenchClockB);
+}
+
+/* about every 8th input toggles per sample, a busy bouncing input port */
+static void vBenchDbncSamples(void)
+{
+	unsigned long ulPrev;
+	unsigned short s;
+	unsigned char w;
+
+	for(s = 0; s < BENCH_DBNC_SAMPLES; s++)
+	{
+		for(w = 0; w < BENCH_DBNC_WORDS; w++)
+		{
+			g_ulBenchSeed = g_ulBenchSeed * 1103515245UL + 12345UL;
+			ulPrev = (s > 0) ? g_aulBenchDbnc[s - 1][w] : 0;
+			g_aulBenchDbnc[s][w] = ulPrev ^ (g_ulBenchSeed & (g_ulBenchSeed >> 7) & (g_ulBenchSeed >> 13));
+		}
+	}
+}
+
+static void vBenchDebounce(void)
+{
+	struct typDebouncer tDbnc;
+	struct typDbncWord atWords[BENCH_DBNC_WORDS];
+	volatile unsigned char ucDelta;
+	unsigned long ulStart, ulCounts;
+	unsigned short s;
+	unsigned char w;
+
+	vBenchDbncSamples();
+
+	g_ucBenchButtons = 0;
+	g_ucBenchClockA = 0;
+	g_ucBenchClockB = 0;
+	ulStart = BENCH_READ();
+	for(s = 0; s < BENCH_DBNC_SAMPLES; s++)
+		ucDelta = ucBenchButtonsPoll((unsigned char)g_aulBenchDbnc[s][0]);
+	ulCounts = BENCH_ELAPSED(ulStart, BENCH_READ()) - g_ulBenchReadCounts;
+	vBenchPrint("buttons_poll", 8, ulCounts, BENCH_DBNC_SAMPLES * 8UL);
+	(void)ucDelta;
+
+	for(w = 1; w <= BENCH_DBNC_WORDS; w++)
+	{
+		vDbncInit(&tDbnc, atWords, w, BENCH_DBNC_DEPTH, 0);
+		ulStart = BENCH_READ();
+		for(s = 0; s < BENCH_DBNC_SAMPLES; s++)
+		{
+			if(ucDbncUpdate(&tDbnc, g_aulBenchDbnc[s]))
+				ulDbncTakeEdges(&tDbnc, 0, 0);
+		}
+		ulCounts = BENCH_ELAPSED(ulStart, BENCH_READ()) - g_ulBenchReadCounts;
+		vBenchPrint("dbnc_update", w * DBNC_INPUTS_PER_WORD, ulCounts,
+					(unsigned long)BENCH_DBNC_SAMPLES * w * DBNC_INPUTS_PER_WORD);
+	}
+}
+
+int main(void)
+{
+	static const unsigned char aucTasks[] = { 1, 4, 8, SCDL_MAX_NUM_TASKS };
+	unsigned char i;
+
+	/* free running counter, no interrupt */
+	SysTickPeriodSet(BENCH_COUNTER_MASK + 1);
+	SysTickEnable();
+
+	vBenchCalibrate();
+
+	ulBenchSemihost(SEMIHOST_SYS_WRITE0, "name,tasks,cycles\n");
+	for(i = 0; i < sizeof(aucTasks); i++)
+	{
+		vBenchScheduler(aucTasks[i]);
+		vBenchCreate(aucTasks[i]);
+	}
+	vBenchSemaphores();
+	vBenchDebounce();
+
+	ulBenchSemihost(SEMIHOST_SYS_EXIT, (const void *)SEMIHOST_EXIT_OK);
+
+	while(1)
+	{
+	}
+}
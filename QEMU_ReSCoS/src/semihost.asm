@@ -0,0 +1,32 @@
+;*****************************************************************************
+;
+; semihost.asm - semihosting call and calibration loop of the benchmark.
+;
+;*****************************************************************************
+
+        .thumb
+        .text
+
+;
+; unsigned long ulBenchSemihost(unsigned long ulOp, const void *pvArg)
+; op in r0, argument in r1, the debugger (QEMU -semihosting) returns in r0
+;
+        .global ulBenchSemihost
+ulBenchSemihost: .asmfunc
+        bkpt    #0xab
+        bx      lr
+        .endasmfunc
+
+;
+; void vBenchNops(void)
+; BENCH_NOPS nops, the unit the results are given in
+;
+        .global vBenchNops
+vBenchNops: .asmfunc
+        .loop   1024
+        nop
+        .endloop
+        bx      lr
+        .endasmfunc
+
+        .end
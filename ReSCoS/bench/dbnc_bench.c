@@ -0,0 +1,239 @@
+/**************************************************************************************************
+  Filename:       dbnc_bench.c
+  Author:         $Author: Menz $
+
+  Description:    Host benchmark of the bit-sliced debouncer of Stellaris_ReSCoS/src/debounce.c
+                  against the vertical counter of ButtonsPoll in buttons.c, in ns per input and
+                  sample. Both see the same bouncing inputs at the same depth, the debounced states
+                  of the 8 inputs ButtonsPoll handles are compared on every sample and the exit
+                  code is 1 if they differ. QEMU_ReSCoS reports the same in Cortex-M3 cycles. See
+                  README.md for the build.
+
+**************************************************************************************************/
+
+
+/*! @file dbnc_bench.c */
+
+
+#include <stdio.h>
+#include <time.h>
+
+#include "inc/scheduler.h"
+#include "inc/debounce.h"
+#include "scdl_port.h"
+
+/** samples per input stream, a power of 2 */
+#define DBNC_BENCH_SAMPLES		(1024)
+/** most words of a run */
+#define DBNC_BENCH_MAX_WORDS	(8)
+/** passes over the samples per run */
+#define DBNC_BENCH_LOOPS		(200)
+/** runs per result, the fastest counts */
+#define DBNC_BENCH_REPEAT		(31)
+/** ButtonsPoll accepts a new state after 4 differing samples */
+#define DBNC_BENCH_DEPTH		(4)
+
+static unsigned long g_aulSamples[DBNC_BENCH_SAMPLES][DBNC_BENCH_MAX_WORDS];
+static unsigned long g_ulSeed = 1;
+
+/* the debounced state and the counter of ButtonsPoll */
+static unsigned char g_ucButtonStates = 0;
+static unsigned char g_ucSwitchClockA = 0;
+static unsigned char g_ucSwitchClockB = 0;
+
+unsigned long ulScdlPortCycles(void)
+{
+	struct timespec tNow;
+
+	clock_gettime(CLOCK_MONOTONIC, &tNow);
+	return (unsigned long)tNow.tv_sec * 1000000000UL + (unsigned long)tNow.tv_nsec;
+}
+
+/* no scheduler run here */
+void vBenchIdle(void)
+{
+}
+
+static unsigned long ulBenchRand(void)
+{
+	g_ulSeed = g_ulSeed * 1103515245UL + 12345UL;
+	return (g_ulSeed >> 16) & 0x7FFF;
+}
+
+/*
+ * the vertical counter of ButtonsPoll without the GPIO read, ucData is the raw
+ * port, returns the changed inputs
+ */
+static unsigned char ucButtonsPoll(unsigned char ucData)
+{
+	unsigned char ucDelta;
+
+	ucDelta = ucData ^ g_ucButtonStates;
+
+	g_ucSwitchClockA ^= g_ucSwitchClockB;
+	g_ucSwitchClockB = ~g_ucSwitchClockB;
+
+	g_ucSwitchClockA &= ucDelta;
+	g_ucSwitchClockB &= ucDelta;
+
+	g_ucButtonStates &= g_ucSwitchClockA | g_ucSwitchClockB;
+	g_ucButtonStates |= (~(g_ucSwitchClockA | g_ucSwitchClockB)) & ucData;
+
+	return ucDelta ^ (g_ucSwitchClockA | g_ucSwitchClockB);
+}
+
+static void vButtonsReset(void)
+{
+	g_ucButtonStates = 0;
+	g_ucSwitchClockA = 0;
+	g_ucSwitchClockB = 0;
+}
+
+/*
+ * inputs held for a random time, every change bounces for a few samples.
+ * usChanges is the chance of a change per 1000 samples of an input.
+ */
+static void vBenchSamples(unsigned short usChanges)
+{
+	unsigned long ulLevel, ulBounce;
+	unsigned short s;
+	unsigned char w, b;
+
+	for(w = 0; w < DBNC_BENCH_MAX_WORDS; w++)
+	{
+		for(b = 0; b < DBNC_INPUTS_PER_WORD; b++)
+		{
+			ulLevel = ulBenchRand() & 1;
+			ulBounce = 0;
+			for(s = 0; s < DBNC_BENCH_SAMPLES; s++)
+			{
+				if(!ulBounce && ulBenchRand() % 1000 < usChanges)
+				{
+					/* a change starts with up to 7 samples of bouncing */
+					ulBounce = 1 + ulBenchRand() % 7;
+					ulLevel ^= 1;
+				}
+				if(ulBounce)
+				{
+					ulBounce--;
+					g_aulSamples[s][w] = (g_aulSamples[s][w] & ~(1UL << b)) |
+										 ((ulBenchRand() & 1UL) << b);
+				}
+				else
+				{
+					g_aulSamples[s][w] = (g_aulSamples[s][w] & ~(1UL << b)) | (ulLevel << b);
+				}
+			}
+		}
+	}
+}
+
+/* ns per input and sample of ucDbncUpdate with ucWords words */
+static double dBenchDebouncer(unsigned char ucWords)
+{
+	struct typDebouncer tDbnc;
+	struct typDbncWord atWords[DBNC_BENCH_MAX_WORDS];
+	unsigned long ulStart, ulNs, ulMin = ~0UL;
+	unsigned short l, s;
+	unsigned char r;
+
+	for(r = 0; r < DBNC_BENCH_REPEAT; r++)
+	{
+		vDbncInit(&tDbnc, atWords, ucWords, DBNC_BENCH_DEPTH, 0);
+
+		ulStart = ulScdlPortCycles();
+		for(l = 0; l < DBNC_BENCH_LOOPS; l++)
+		{
+			for(s = 0; s < DBNC_BENCH_SAMPLES; s++)
+			{
+				if(ucDbncUpdate(&tDbnc, g_aulSamples[s]))
+				{
+					/* the edges are taken by the dispatch task */
+					ulDbncTakeEdges(&tDbnc, 0, 0);
+				}
+			}
+		}
+		ulNs = ulScdlPortCycles() - ulStart;
+		if(ulNs < ulMin)
+			ulMin = ulNs;
+	}
+
+	return (double)ulMin / ((double)DBNC_BENCH_LOOPS * DBNC_BENCH_SAMPLES * ucWords * DBNC_INPUTS_PER_WORD);
+}
+
+/* ns per input and sample of the ButtonsPoll counter */
+static double dBenchButtons(void)
+{
+	volatile unsigned char ucDelta;
+	unsigned long ulStart, ulNs, ulMin = ~0UL;
+	unsigned short l, s;
+	unsigned char r;
+
+	for(r = 0; r < DBNC_BENCH_REPEAT; r++)
+	{
+		vButtonsReset();
+
+		ulStart = ulScdlPortCycles();
+		for(l = 0; l < DBNC_BENCH_LOOPS; l++)
+		{
+			for(s = 0; s < DBNC_BENCH_SAMPLES; s++)
+				ucDelta = ucButtonsPoll((unsigned char)g_aulSamples[s][0]);
+		}
+		ulNs = ulScdlPortCycles() - ulStart;
+		if(ulNs < ulMin)
+			ulMin = ulNs;
+	}
+	(void)ucDelta;
+
+	return (double)ulMin / ((double)DBNC_BENCH_LOOPS * DBNC_BENCH_SAMPLES * 8);
+}
+
+/* both debounced states of the 8 ButtonsPoll inputs must agree, returns the mismatches */
+static unsigned long ulBenchCompare(void)
+{
+	struct typDebouncer tDbnc;
+	struct typDbncWord tWord;
+	unsigned long ulMismatches = 0;
+	unsigned short s;
+
+	vDbncInit(&tDbnc, &tWord, 1, DBNC_BENCH_DEPTH, 0);
+	vButtonsReset();
+
+	for(s = 0; s < DBNC_BENCH_SAMPLES; s++)
+	{
+		ucDbncUpdate(&tDbnc, g_aulSamples[s]);
+		ucButtonsPoll((unsigned char)g_aulSamples[s][0]);
+		if((unsigned char)ulDbncGetState(&tDbnc, 0) != g_ucButtonStates)
+			ulMismatches++;
+	}
+
+	return ulMismatches;
+}
+
+int main(void)
+{
+	static const unsigned short ausChanges[] = { 0, 5, 50 };
+	static const unsigned char aucWords[] = { 1, 2, DBNC_BENCH_MAX_WORDS };
+	unsigned long ulMismatches = 0;
+	unsigned char i, w;
+
+	printf("name,changes_per_1000,inputs,ns\n");
+	for(i = 0; i < sizeof(ausChanges) / sizeof(ausChanges[0]); i++)
+	{
+		vBenchSamples(ausChanges[i]);
+		ulMismatches += ulBenchCompare();
+
+		printf("buttons_poll,%u,8,%.3f\n", ausChanges[i], dBenchButtons());
+		for(w = 0; w < sizeof(aucWords); w++)
+			printf("dbnc_update,%u,%u,%.3f\n", ausChanges[i], aucWords[w] * DBNC_INPUTS_PER_WORD,
+					dBenchDebouncer(aucWords[w]));
+	}
+
+	if(ulMismatches)
+	{
+		fprintf(stderr, "%lu samples with different debounced states\n", ulMismatches);
+		return 1;
+	}
+
+	return 0;
+}
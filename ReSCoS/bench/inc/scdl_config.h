@@ -0,0 +1,40 @@
+/*
+ * scdl_config.h
+ *
+ *  Scheduler settings of the benchmark, further options can be given on the
+ *  compiler command line, e.g. -DSCDL_EDF.
+ */
+
+#ifndef SCDL_CONFIG_H_
+#define SCDL_CONFIG_H_
+
+#define SCDL_MAX_NUM_TASKS		(12)
+
+/** tick period in us, task periods are counted in ticks */
+#ifndef SCDL_TICK_US
+#define SCDL_TICK_US			(1000UL)
+#endif
+
+/** the idle hook drives the ticks, see vBenchIdle */
+#define SCDL_IDLE_SLEEP
+
+/** task set of scdl_startup.c with -DSCDL_STATIC_TASKS, the one of the LaunchPad example */
+#ifdef SCDL_STATIC_TASKS
+#define SCDL_TASK_TABLE(TASK)																\
+	TASK(TID_STARTUP_1,	vTaskStartup1,		SCDL_MS_TO_TICKS(1000))							\
+	TASK(TID_STARTUP_2,	vTaskStartup2,		SCDL_MS_TO_TICKS(250))							\
+	TASK(TID_STARTUP_3,	vTaskStartup3,		SCDL_MS_TO_TICKS(50))
+#endif
+
+/** -DBENCH_HOOKS_INLINE or -DBENCH_HOOKS_CALL set all hooks, see scdl_hooks.h */
+#if defined(BENCH_HOOKS_INLINE) || defined(BENCH_HOOKS_CALL)
+#define SCDL_HOOKS_INCLUDE				"scdl_hooks.h"
+#define SCDL_HOOK_TASK_START(h,id)		vBenchHookTask(id)
+#define SCDL_HOOK_TASK_STOP(h,id)		vBenchHookTask(id)
+#define SCDL_HOOK_IDLE_ENTER(h)			vBenchHook()
+#define SCDL_HOOK_IDLE_EXIT(h)			vBenchHook()
+#define SCDL_HOOK_TICK(h)				vBenchHook()
+#define SCDL_HOOK_TASK_STATE(h,id,s)	vBenchHookTask(id)
+#endif
+
+#endif /* SCDL_CONFIG_H_ */
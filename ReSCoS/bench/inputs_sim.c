@@ -0,0 +1,402 @@
+/**************************************************************************************************
+  Filename:       inputs_sim.c
+  Author:         $Author: Menz $
+
+  Description:    Host simulation of the interrupt driven buttons of Stellaris_ReSCoS/src/inputs.c.
+                  The TivaWare headers in bench/tiva are backed by a mock GPIO port: two low
+                  active buttons are pressed and released at random in virtual time, every change
+                  bounces. Edges latch the interrupt status as on the target, the interrupt runs
+                  while unmasked. Every driver call takes time, so edges also hit the sample task
+                  while it re-arms the interrupt. It reports wake ups and task time against the
+                  former 25 ms polling task and exits with 1 if a change was missed, reported
+                  twice or the buttons did not settle. See README.md for the build.
+
+**************************************************************************************************/
+
+
+/*! @file inputs_sim.c */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "inc/hw_memmap.h"
+#include "inc/hw_ints.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/gpio.h"
+#include "boards/ek-lm4f120xl/drivers/buttons.h"
+#include "inc/scheduler.h"
+#include "inc/inputs.h"
+#include "scdl_port.h"
+#include "scdl_sim.h"
+
+#define SIM_NEVER			(~0ULL)
+#define SIM_NUM_PINS		(2)
+/** shortest time between two changes of a button, ms */
+#define SIM_MIN_GAP_MS		(200)
+/** no changes in the last second, so all inputs settle */
+#define SIM_QUIET_NS		(1000000000ULL)
+/** period of the former polling task */
+#define SIM_POLL_PERIOD		SCDL_MS_TO_TICKS(25)
+
+/*!
+ * one button of the mock port
+ */
+struct typSimPin
+{
+	/** pin mask on the port and input number of the debouncer */
+	unsigned char ucMask;
+	unsigned char ucInput;
+	/** 1 while pressed once the bouncing ends */
+	unsigned char bPressed;
+	/** 1 from a change to its last bounce, bounces left */
+	unsigned char bBouncing;
+	unsigned char ucBounces;
+	/** next change of the pin level */
+	unsigned long long ullNextNs;
+	/** end of the bouncing of the last change */
+	unsigned long long ullSettledNs;
+	/** changes, callbacks and the last reported state */
+	unsigned long ulChanges;
+	unsigned long ulReported;
+	unsigned char bReported;
+};
+
+/*!
+ * GPIO port F and its interrupt
+ */
+struct typSimPort
+{
+	/** pin levels, buttons are low active */
+	unsigned char ucLevel;
+	/** pins with an edge interrupt, raw status and mask */
+	unsigned char ucEdges;
+	unsigned char ucRaw;
+	unsigned char ucMask;
+	/** 1 once the interrupt is enabled in the NVIC, 1 while it runs */
+	unsigned char bNvic;
+	unsigned char bInIsr;
+	unsigned long ulEdges;
+	unsigned long ulIsrs;
+	unsigned long ulCalls;
+	/** interrupts masked again by the sample task, an edge hit the re-arm */
+	unsigned long ulRaces;
+};
+
+static struct typSimPin g_atSimPins[SIM_NUM_PINS] =
+{
+	{ .ucMask = RIGHT_BUTTON, .ucInput = 0 },
+	{ .ucMask = LEFT_BUTTON, .ucInput = 4 }
+};
+static struct typSimPort g_tSimPort = { .ucLevel = ALL_BUTTONS };
+
+static unsigned long long g_ullSimEndNs;
+static unsigned long long g_ullTaskNs = 0;
+static unsigned long long g_ullLatencySum = 0;
+static unsigned long long g_ullLatencyMax = 0;
+static unsigned long g_ulSeed = 1;
+static unsigned long g_ulRuns = 0;
+static unsigned long g_ulErrors = 0;
+static taskID_t g_tidSimSample = SCDL_NA;
+
+/* settings */
+static unsigned char g_bPoll = 0;
+static double g_dSeconds = 60.0;
+static unsigned long g_ulMaxGapMs = 1000;
+static unsigned long g_ulMaxBounces = 8;
+static unsigned long g_ulBounceUs = 1000;
+static unsigned long g_ulCallNs = 2000;
+
+/* the debouncer of the polling task */
+static struct typDebouncer g_tSimPoll;
+static struct typDbncWord g_tSimPollWord;
+static tDbncCallback g_apfnSimPoll[DBNC_INPUTS_PER_WORD];
+
+static unsigned long ulSimRand(void)
+{
+	g_ulSeed = g_ulSeed * 1103515245UL + 12345UL;
+	return (g_ulSeed >> 16) & 0x7FFF;
+}
+
+/* virtual time, ns */
+unsigned long ulScdlPortCycles(void)
+{
+	return (unsigned long)g_ullSimNs;
+}
+
+/* the next press or release of a button */
+static void vSimPlanChange(struct typSimPin *ptPin)
+{
+	ptPin->ullNextNs = g_ullSimNs + (SIM_MIN_GAP_MS + ulSimRand() % (g_ulMaxGapMs + 1)) * 1000000ULL;
+	if(ptPin->ullNextNs >= g_ullSimEndNs - SIM_QUIET_NS)
+		ptPin->ullNextNs = SIM_NEVER;
+}
+
+/* a level change of the pin, bouncing or the settled level */
+static void vSimPinChange(struct typSimPin *ptPin)
+{
+	unsigned char ucLevel = g_tSimPort.ucLevel;
+
+	if(!ptPin->bBouncing)
+	{
+		/* the user presses or releases, the contact starts to bounce */
+		ptPin->bBouncing = 1;
+		ptPin->bPressed ^= 1;
+		ptPin->ulChanges++;
+		ptPin->ucBounces = ulSimRand() % (g_ulMaxBounces + 1);
+	}
+
+	if(ptPin->ucBounces)
+	{
+		ptPin->ucBounces--;
+		ucLevel ^= ptPin->ucMask;
+		ptPin->ullNextNs = g_ullSimNs + 10000ULL + (unsigned long long)(ulSimRand() % (g_ulBounceUs + 1)) * 1000ULL;
+	}
+	else
+	{
+		/* settled, low while pressed */
+		ucLevel = ptPin->bPressed ? (ucLevel & ~ptPin->ucMask) : (ucLevel | ptPin->ucMask);
+		ptPin->bBouncing = 0;
+		ptPin->ullSettledNs = g_ullSimNs;
+		vSimPlanChange(ptPin);
+	}
+
+	if(ucLevel != g_tSimPort.ucLevel)
+	{
+		g_tSimPort.ulEdges++;
+		g_tSimPort.ucRaw |= (ucLevel ^ g_tSimPort.ucLevel) & g_tSimPort.ucEdges;
+		g_tSimPort.ucLevel = ucLevel;
+	}
+}
+
+static unsigned long ulSimIrq(void)
+{
+	unsigned long ulRuns = 0;
+
+	while(g_tSimPort.bNvic && (g_tSimPort.ucRaw & g_tSimPort.ucMask))
+	{
+		g_tSimPort.ulIsrs++;
+		ulRuns++;
+		g_tSimPort.bInIsr = 1;
+		GPIOPortFIntHandler();
+		g_tSimPort.bInIsr = 0;
+	}
+	return ulRuns;
+}
+
+/* process pin changes up to ullTo, with bWake stop after an interrupt */
+static unsigned char bSimAdvance(unsigned long long ullTo, unsigned char bWake)
+{
+	struct typSimPin *ptNext;
+	unsigned char i;
+
+	for(;;)
+	{
+		ptNext = &g_atSimPins[0];
+		for(i = 1; i < SIM_NUM_PINS; i++)
+		{
+			if(g_atSimPins[i].ullNextNs < ptNext->ullNextNs)
+				ptNext = &g_atSimPins[i];
+		}
+		if(ptNext->ullNextNs > ullTo)
+			break;
+
+		g_ullSimNs = ptNext->ullNextNs;
+		vSimPinChange(ptNext);
+		if(ulSimIrq() && bWake)
+			return 1;
+	}
+	g_ullSimNs = ullTo;
+	return 0;
+}
+
+/* a driver call of a task takes g_ulCallNs, interrupts hit it meanwhile */
+static void vSimCall(void)
+{
+	g_tSimPort.ulCalls++;
+	vSimRun(g_ulCallNs);
+}
+
+long GPIOPinRead(unsigned long ulPort, unsigned char ucPins)
+{
+	(void)ulPort;
+	vSimCall();
+	return g_tSimPort.ucLevel & ucPins;
+}
+
+void GPIOIntTypeSet(unsigned long ulPort, unsigned char ucPins, unsigned long ulIntType)
+{
+	(void)ulPort;
+	if(ulIntType == GPIO_BOTH_EDGES)
+		g_tSimPort.ucEdges |= ucPins;
+}
+
+void GPIOPinIntEnable(unsigned long ulPort, unsigned char ucPins)
+{
+	(void)ulPort;
+	vSimCall();
+	g_tSimPort.ucMask |= ucPins;
+	/* a latched edge interrupts right away */
+	ulSimIrq();
+}
+
+void GPIOPinIntDisable(unsigned long ulPort, unsigned char ucPins)
+{
+	(void)ulPort;
+	if(!g_tSimPort.bInIsr)
+		g_tSimPort.ulRaces++;
+	g_tSimPort.ucMask &= ~ucPins;
+}
+
+void GPIOPinIntClear(unsigned long ulPort, unsigned char ucPins)
+{
+	(void)ulPort;
+	vSimCall();
+	g_tSimPort.ucRaw &= ~ucPins;
+}
+
+void IntEnable(unsigned long ulInterrupt)
+{
+	if(ulInterrupt == INT_GPIOF)
+		g_tSimPort.bNvic = 1;
+	ulSimIrq();
+}
+
+/* debounced edge of a button, must match the last change and alternate */
+static void vSimCallback(unsigned short usInput, unsigned char ucState)
+{
+	struct typSimPin *ptPin;
+	unsigned long long ullLatency;
+	unsigned char i;
+
+	for(i = 0; i < SIM_NUM_PINS; i++)
+	{
+		ptPin = &g_atSimPins[i];
+		if(ptPin->ucInput != usInput)
+			continue;
+
+		if(ucState != ptPin->bPressed || ucState == ptPin->bReported || ptPin->bBouncing)
+			g_ulErrors++;
+		ptPin->bReported = ucState;
+		ptPin->ulReported++;
+
+		ullLatency = g_ullSimNs - ptPin->ullSettledNs;
+		g_ullLatencySum += ullLatency;
+		if(ullLatency > g_ullLatencyMax)
+			g_ullLatencyMax = ullLatency;
+		return;
+	}
+	g_ulErrors++;
+}
+
+static void vTaskSimSample(void)
+{
+	unsigned long long ullStart = g_ullSimNs;
+
+	g_ulRuns++;
+	vTaskInputSample();
+	g_ullTaskNs += g_ullSimNs - ullStart;
+}
+
+/* the task replaced by inputs.c, sampling every 25 ms like ButtonsPoll */
+static void vTaskSimPoll(void)
+{
+	unsigned long long ullStart = g_ullSimNs;
+	unsigned long ulRaw;
+
+	g_ulRuns++;
+	ulRaw = ~GPIOPinRead(BUTTONS_GPIO_BASE, ALL_BUTTONS) & ALL_BUTTONS;
+	ucDbncUpdate(&g_tSimPoll, &ulRaw);
+	g_ullTaskNs += g_ullSimNs - ullStart;
+}
+
+static void vTaskSimPollEvents(void)
+{
+	vDbncDispatch(&g_tSimPoll);
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned long ulChanges, ulReported, ulPressed, ulState;
+	taskID_t tidEvents;
+	unsigned char i;
+	int a;
+
+	for(a = 1; a < argc; a++)
+	{
+		if(!strcmp(argv[a], "-p"))
+			g_bPoll = 1;
+		else if(!strcmp(argv[a], "-s") && a + 1 < argc)
+			g_dSeconds = atof(argv[++a]);
+		else if(!strcmp(argv[a], "-g") && a + 1 < argc)
+			g_ulMaxGapMs = strtoul(argv[++a], 0, 10);
+		else if(!strcmp(argv[a], "-b") && a + 1 < argc)
+			g_ulMaxBounces = strtoul(argv[++a], 0, 10);
+		else if(!strcmp(argv[a], "-u") && a + 1 < argc)
+			g_ulBounceUs = strtoul(argv[++a], 0, 10);
+		else if(!strcmp(argv[a], "-c") && a + 1 < argc)
+			g_ulCallNs = strtoul(argv[++a], 0, 10);
+		else
+			break;
+	}
+	if(a != argc || g_dSeconds < 2.0 || g_ulMaxBounces > 254)
+	{
+		fprintf(stderr, "usage: %s [-p] [-s seconds] [-g max_gap_ms] [-b max_bounces] [-u max_bounce_us]\n"
+						"          [-c driver_call_ns]\n", argv[0]);
+		return 2;
+	}
+
+	g_ullSimEndNs = (unsigned long long)(g_dSeconds * 1e9);
+	vSimReset(g_ullSimEndNs, 0);
+	vSimSetAdvance(bSimAdvance);
+	for(i = 0; i < SIM_NUM_PINS; i++)
+		vSimPlanChange(&g_atSimPins[i]);
+
+	if(g_bPoll)
+	{
+		tidCreateTask(vTaskSimPoll, SIM_POLL_PERIOD);
+		tidEvents = tidCreateTask(vTaskSimPollEvents, SCDL_INF_PERIOD);
+		vDbncInit(&g_tSimPoll, &g_tSimPollWord, 1, INPUTS_DEBOUNCE_DEPTH, 0);
+		vDbncSetCallbacks(&g_tSimPoll, g_apfnSimPoll, tidEvents);
+		for(i = 0; i < SIM_NUM_PINS; i++)
+			vDbncSetCallback(&g_tSimPoll, g_atSimPins[i].ucInput, vSimCallback);
+	}
+	else
+	{
+		/* as in main.c */
+		g_tidSimSample = tidCreateTask(vTaskSimSample, INPUTS_SAMPLE_PERIOD);
+		tidEvents = tidCreateTask(vTaskInputEvents, SCDL_INF_PERIOD);
+		vInputsInit(g_tidSimSample, tidEvents);
+		for(i = 0; i < SIM_NUM_PINS; i++)
+			vInputsSetCallback(g_atSimPins[i].ucInput, vSimCallback);
+	}
+
+	vSimStart();
+
+	ulChanges = 0;
+	ulReported = 0;
+	ulPressed = 0;
+	for(i = 0; i < SIM_NUM_PINS; i++)
+	{
+		ulChanges += g_atSimPins[i].ulChanges;
+		ulReported += g_atSimPins[i].ulReported;
+		if(g_atSimPins[i].bPressed)
+			ulPressed |= g_atSimPins[i].ucMask;
+	}
+	ulState = g_bPoll ? ulDbncGetState(&g_tSimPoll, 0) : ulInputsGetState();
+
+	printf("mode,seconds,changes,edges,isrs,races,wakeups,task_us_per_s,latency_avg_ms,latency_max_ms\n");
+	printf("%s,%.0f,%lu,%lu,%lu,%lu,%lu,%.2f,%.3f,%.3f\n", g_bPoll ? "poll" : "edge", g_dSeconds, ulChanges,
+			g_tSimPort.ulEdges, g_tSimPort.ulIsrs, g_tSimPort.ulRaces, g_ulRuns, g_ullTaskNs / 1e3 / g_dSeconds,
+			ulReported ? g_ullLatencySum / 1e6 / ulReported : 0.0, g_ullLatencyMax / 1e6);
+
+	/* every change reported once, the inputs settled and the sample task asleep */
+	if(g_ulErrors || ulReported != ulChanges || ulState != ulPressed
+			|| (!g_bPoll && g_tScdlDefault.atTask[g_tidSimSample].eTaskState != OFF))
+	{
+		printf("missed or wrong button changes\n");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,20 @@
+/*
+ * scdl_config.h
+ *
+ *  Scheduler settings of the benchmarks built with the posix port, every
+ *  instance runs in its own thread. Further options can be given on the
+ *  compiler command line.
+ */
+
+#ifndef SCDL_CONFIG_H_
+#define SCDL_CONFIG_H_
+
+#define SCDL_MAX_NUM_TASKS		(12)
+
+/** the idle instances wait for the tick */
+#define SCDL_IDLE_SLEEP
+
+#define SCDL_MULTI_INSTANCE
+#define SCDL_WORK_STEALING
+
+#endif /* SCDL_CONFIG_H_ */
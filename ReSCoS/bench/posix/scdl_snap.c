@@ -0,0 +1,241 @@
+/**************************************************************************************************
+  Filename:       scdl_snap.c
+  Author:         $Author: Menz $
+
+  Description:    Multi-threaded torture test of the snapshots of scdl_snapshot.h on the posix
+                  port, built with SCDL_SNAPSHOTS. A writer thread stands for the ISR and publishes
+                  words that are all equal, reader threads check every copy they take. The writer
+                  holds the port lock while it writes, as an ISR cannot run while a task has
+                  interrupts disabled. The readers copy through the snapshot, in a critical
+                  section, and without protection as a control that must tear. The time of an
+                  uncontended read is compared with a copy in a critical section. Results are
+                  written as csv lines "method,bytes,read_ns" and "method,readers,reads,writes,
+                  torn,retries,locked". The exit code is 1 on a torn copy of the snapshot or the
+                  critical section. See README.md for the build.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_snap.c */
+
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "inc/scheduler.h"
+#include "inc/scdl_critical.h"
+#include "inc/scdl_snapshot.h"
+#include "scdl_port.h"
+
+#ifndef SCDL_SNAPSHOTS
+#error scdl_snap needs -DSCDL_SNAPSHOTS
+#endif
+
+/** words of the shared data */
+#define SNAP_WORDS			(8)
+/** most reader threads, uncontended reads timed */
+#define SNAP_MAX_READERS	(8)
+#define SNAP_READS			(2000000UL)
+
+/*!
+ * the shared data, consistent if all words are equal
+ */
+struct typSnapData
+{
+	unsigned long aulWord[SNAP_WORDS];
+};
+
+/*!
+ * counters of one reader thread
+ */
+struct typSnapReader
+{
+	unsigned long ulReads;
+	unsigned long ulTorn;
+};
+
+enum etypSnapMethod { SNAP_SNAPSHOT, SNAP_CRITICAL, SNAP_NONE };
+
+static const char * const g_apcSnapMethods[] = { "snapshot", "critical", "none" };
+
+static struct typSnapData g_tSnapShared;
+static struct typScdlSnapshot g_tSnap;
+static enum etypSnapMethod g_eSnapMethod;
+static volatile int g_iSnapStop;
+static unsigned long g_ulSnapWrites;
+
+static unsigned char bSnapTorn(const struct typSnapData *ptData)
+{
+	unsigned char i;
+
+	for(i = 1; i < SNAP_WORDS; i++)
+	{
+		if(ptData->aulWord[i] != ptData->aulWord[0])
+			return 1;
+	}
+
+	return 0;
+}
+
+/* the ISR: cannot run while a task is in a critical section, never waits for a reader */
+static void *pvSnapWriter(void *pvArg)
+{
+	struct typSnapData tData;
+	scdlIrqState_t tIrqState;
+	unsigned char i;
+
+	(void)pvArg;
+	while(!g_iSnapStop)
+	{
+		g_ulSnapWrites++;
+		for(i = 0; i < SNAP_WORDS; i++)
+			tData.aulWord[i] = g_ulSnapWrites;
+
+		SCDL_ENTER_CRITICAL(tIrqState);
+		if(g_eSnapMethod == SNAP_SNAPSHOT)
+		{
+			vScdlSnapshotWrite(&g_tSnap, &tData);
+		}
+		else
+		{
+			for(i = 0; i < SNAP_WORDS; i++)
+				((volatile unsigned long *)g_tSnapShared.aulWord)[i] = tData.aulWord[i];
+		}
+		SCDL_EXIT_CRITICAL(tIrqState);
+	}
+
+	return 0;
+}
+
+/* one copy of the shared data with the method of the run */
+static void vSnapCopy(struct typSnapData *ptData)
+{
+	scdlIrqState_t tIrqState;
+	unsigned char i;
+
+	switch(g_eSnapMethod)
+	{
+	case SNAP_SNAPSHOT:
+		vScdlSnapshotRead(&g_tSnap, ptData);
+		break;
+	case SNAP_CRITICAL:
+		SCDL_ENTER_CRITICAL(tIrqState);
+		memcpy(ptData, &g_tSnapShared, sizeof(*ptData));
+		SCDL_EXIT_CRITICAL(tIrqState);
+		break;
+	default:
+		for(i = 0; i < SNAP_WORDS; i++)
+			ptData->aulWord[i] = ((volatile unsigned long *)g_tSnapShared.aulWord)[i];
+		break;
+	}
+}
+
+static void *pvSnapReader(void *pvReader)
+{
+	struct typSnapReader *ptReader = pvReader;
+	struct typSnapData tData;
+
+	while(!g_iSnapStop)
+	{
+		vSnapCopy(&tData);
+		ptReader->ulReads++;
+		if(bSnapTorn(&tData))
+			ptReader->ulTorn++;
+	}
+
+	return 0;
+}
+
+/* ns of one uncontended copy */
+static double dSnapTime(enum etypSnapMethod eMethod)
+{
+	struct typSnapData tData;
+	unsigned long i, ulStart;
+
+	g_eSnapMethod = eMethod;
+	ulStart = ulScdlPortCycles();
+	for(i = 0; i < SNAP_READS; i++)
+		vSnapCopy(&tData);
+
+	return (double)(ulScdlPortCycles() - ulStart) / SNAP_READS;
+}
+
+/* readers and the writer for dSeconds, returns the torn copies */
+static unsigned long ulSnapTorture(enum etypSnapMethod eMethod, unsigned char ucReaders, double dSeconds)
+{
+	struct typSnapReader atReaders[SNAP_MAX_READERS];
+	pthread_t atThreads[SNAP_MAX_READERS], tWriter;
+	struct timespec tSleep;
+	unsigned long ulReads = 0, ulTorn = 0;
+	unsigned char i;
+
+	memset(&g_tSnapShared, 0, sizeof(g_tSnapShared));
+	vScdlSnapshotInit(&g_tSnap, &g_tSnapShared, sizeof(g_tSnapShared));
+	memset(atReaders, 0, sizeof(atReaders));
+	g_eSnapMethod = eMethod;
+	g_ulSnapWrites = 0;
+	g_iSnapStop = 0;
+
+	pthread_create(&tWriter, 0, pvSnapWriter, 0);
+	for(i = 0; i < ucReaders; i++)
+		pthread_create(&atThreads[i], 0, pvSnapReader, &atReaders[i]);
+
+	tSleep.tv_sec = (time_t)dSeconds;
+	tSleep.tv_nsec = (long)((dSeconds - tSleep.tv_sec) * 1e9);
+	nanosleep(&tSleep, 0);
+	g_iSnapStop = 1;
+
+	pthread_join(tWriter, 0);
+	for(i = 0; i < ucReaders; i++)
+	{
+		pthread_join(atThreads[i], 0);
+		ulReads += atReaders[i].ulReads;
+		ulTorn += atReaders[i].ulTorn;
+	}
+
+	printf("%s,%u,%lu,%lu,%lu,%u,%u\n", g_apcSnapMethods[eMethod], ucReaders, ulReads, g_ulSnapWrites, ulTorn,
+			(eMethod == SNAP_SNAPSHOT) ? usScdlSnapshotGetRetries(&g_tSnap) : 0,
+			(eMethod == SNAP_SNAPSHOT) ? usScdlSnapshotGetLocked(&g_tSnap) : 0);
+
+	return ulTorn;
+}
+
+int main(int argc, char *argv[])
+{
+	double dSeconds = 2.0;
+	unsigned long ulTorn;
+	int a, iReaders = 3;
+
+	for(a = 1; a < argc; a++)
+	{
+		if(!strcmp(argv[a], "-s") && a + 1 < argc)
+			dSeconds = atof(argv[++a]);
+		else if(!strcmp(argv[a], "-r") && a + 1 < argc)
+			iReaders = atoi(argv[++a]);
+		else
+			break;
+	}
+	if(a != argc || iReaders < 1 || iReaders > SNAP_MAX_READERS || dSeconds <= 0)
+	{
+		fprintf(stderr, "usage: %s [-s seconds] [-r readers 1..%u]\n", argv[0], SNAP_MAX_READERS);
+		return 2;
+	}
+
+	vScdlSnapshotInit(&g_tSnap, &g_tSnapShared, sizeof(g_tSnapShared));
+	printf("method,bytes,read_ns\n");
+	printf("snapshot,%u,%.1f\n", (unsigned int)sizeof(g_tSnapShared), dSnapTime(SNAP_SNAPSHOT));
+	printf("critical,%u,%.1f\n", (unsigned int)sizeof(g_tSnapShared), dSnapTime(SNAP_CRITICAL));
+
+	printf("method,readers,reads,writes,torn,retries,locked\n");
+	ulTorn = ulSnapTorture(SNAP_SNAPSHOT, (unsigned char)iReaders, dSeconds);
+	ulTorn += ulSnapTorture(SNAP_CRITICAL, (unsigned char)iReaders, dSeconds);
+	/* the control shows that the test can see torn copies */
+	ulSnapTorture(SNAP_NONE, (unsigned char)iReaders, dSeconds);
+
+	return ulTorn ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+/**************************************************************************************************
+  Filename:       scdl_threads.c
+  Author:         $Author: Menz $
+
+  Description:    Host benchmark of the throughput of a CPU-bound task set on 1 to THREADS_MAX
+                  scheduler instances, each run in a thread of the posix port. The tasks are
+                  either spread over the instances or all created on the first one, which the
+                  others steal from. Each configuration runs in a child process for
+                  THREADS_SECONDS, results are written as csv lines
+                  "mode,threads,runs_per_s". See README.md for the build.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_threads.c */
+
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "inc/scheduler.h"
+#include "scdl_port.h"
+
+#ifndef SCDL_WORK_STEALING
+#error build with bench/posix/inc/scdl_config.h and the posix port
+#endif
+
+/** most instances and threads */
+#define THREADS_MAX			(8)
+/** CPU-bound tasks, released every tick */
+#define THREADS_TASKS		(8)
+/** loop iterations of one task run, a few 100 us */
+#define THREADS_WORK		(100000UL)
+/** measurement window */
+#define THREADS_SECONDS		(2)
+
+static struct typScheduler g_atThreadsScdl[THREADS_MAX];
+static volatile unsigned long g_ulThreadsRuns = 0;
+static unsigned char g_ucThreads;
+static unsigned char g_bThreadsSteal;
+
+static void vTaskThreadsWork(void)
+{
+	volatile unsigned long i;
+
+	for(i = 0; i < THREADS_WORK; i++)
+		;
+	__sync_fetch_and_add(&g_ulThreadsRuns, 1);
+}
+
+/* first run starts the window, the second one ends the child */
+static void vTaskThreadsMeasure(void)
+{
+	static unsigned long ulStart, ulRuns;
+	static unsigned char bStarted = 0;
+
+	if(!bStarted)
+	{
+		bStarted = 1;
+		ulStart = ulScdlPortCycles();
+		ulRuns = g_ulThreadsRuns;
+		return;
+	}
+
+	printf("%s,%u,%.1f\n", g_bThreadsSteal ? "steal" : "partition", g_ucThreads,
+			(g_ulThreadsRuns - ulRuns) * 1e9 / (ulScdlPortCycles() - ulStart));
+	fflush(stdout);
+	_exit(0);
+}
+
+/* one configuration, does not return */
+static void vThreadsRun(void)
+{
+	scdlHandle_t ahScdl[THREADS_MAX];
+	unsigned char i;
+
+	for(i = 0; i < g_ucThreads; i++)
+	{
+		ahScdl[i] = &g_atThreadsScdl[i];
+		vScdlInit(ahScdl[i]);
+	}
+
+	/* the measurement first, it has the highest priority */
+	tidScdlCreateTask(ahScdl[0], vTaskThreadsMeasure, SCDL_MS_TO_TICKS(THREADS_SECONDS * 1000));
+	for(i = 0; i < THREADS_TASKS; i++)
+		tidScdlCreateTask(ahScdl[g_bThreadsSteal ? 0 : i % g_ucThreads], vTaskThreadsWork, 1);
+	if(g_bThreadsSteal)
+		vScdlSetStealable(ahScdl[0], 1);
+
+	vScdlPortTickInit();
+	vScdlPortRunInstances(ahScdl, g_ucThreads);
+}
+
+int main(void)
+{
+	static const unsigned char aucThreads[] = { 1, 2, 4, THREADS_MAX };
+	unsigned char i;
+	int iStatus;
+	pid_t tChild;
+
+	printf("mode,threads,runs_per_s\n");
+	fflush(stdout);
+	fprintf(stderr, "%ld cpus online\n", sysconf(_SC_NPROCESSORS_ONLN));
+
+	for(g_bThreadsSteal = 0; g_bThreadsSteal < 2; g_bThreadsSteal++)
+	{
+		for(i = 0; i < sizeof(aucThreads); i++)
+		{
+			g_ucThreads = aucThreads[i];
+
+			tChild = fork();
+			if(tChild < 0)
+				return 1;
+			if(!tChild)
+				vThreadsRun();
+
+			if(waitpid(tChild, &iStatus, 0) != tChild || !WIFEXITED(iStatus) || WEXITSTATUS(iStatus))
+				return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,301 @@
+/**************************************************************************************************
+  Filename:       scdl_bench.c
+  Author:         $Author: Menz $
+
+  Description:    Host micro-benchmarks of the scheduler: tick handler, dispatch per task
+                  switch, task creation and semaphores for 1 to SCDL_MAX_NUM_TASKS tasks.
+                  Results are written as csv lines "name,tasks,ns" to stdout. With -b the
+                  results are compared to a stored run and the exit code is 1 if any of them
+                  got slower by more than the threshold (-t, percent, default 15). Every
+                  result is a whole batch timed with one pair of clock reads. See README.md
+                  for the build, also with all hooks set.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_bench.c */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "inc/scheduler.h"
+#include "scdl_port.h"
+#include "scdl_hooks.h"
+#include "scdl_sim.h"
+
+/** ticks per scheduler run */
+#define BENCH_TICKS			(20000UL)
+/** loops of the short benchmarks */
+#define BENCH_LOOPS			(200000UL)
+/**
+ * rounds over all benchmarks, the fastest run counts. Spreading the runs of a
+ * benchmark over the whole time lets the minimum skip phases of a slow host.
+ */
+#define BENCH_REPEAT		(101)
+/** a regression must still show after this many passes of BENCH_REPEAT rounds */
+#define BENCH_PASSES		(3)
+#define BENCH_MAX_RESULTS	(64)
+/** smaller changes are clock noise, never a regression */
+#define BENCH_MIN_DELTA_NS	(1.0)
+
+struct typBenchResult
+{
+	char acName[32];
+	unsigned char ucTasks;
+	double dNs;
+};
+
+static struct typBenchResult g_atBenchResults[BENCH_MAX_RESULTS];
+static unsigned char g_ucBenchNumResults = 0;
+
+static unsigned long g_ulBenchRuns;
+
+static unsigned long ulBenchNs(void)
+{
+	struct timespec tNow;
+
+	clock_gettime(CLOCK_MONOTONIC, &tNow);
+	return (unsigned long)tNow.tv_sec * 1000000000UL + (unsigned long)tNow.tv_nsec;
+}
+
+unsigned long ulScdlPortCycles(void)
+{
+	return ulBenchNs();
+}
+
+#ifdef BENCH_HOOKS_CALL
+/* out-of-line hooks, the empty asm keeps the calls */
+void __attribute__((noinline)) vBenchHookTask(unsigned char ucTask)
+{
+	(void)ucTask;
+	__asm__ volatile("");
+}
+
+void __attribute__((noinline)) vBenchHook(void)
+{
+	__asm__ volatile("");
+}
+#endif
+
+static void vBenchTask(void)
+{
+	g_ulBenchRuns++;
+}
+
+/* result of a benchmark, added on the first round */
+static struct typBenchResult *ptBenchResult(const char *pcName, unsigned char ucTasks)
+{
+	struct typBenchResult *ptResult;
+	unsigned char i;
+
+	for(i = 0; i < g_ucBenchNumResults; i++)
+	{
+		if(!strcmp(g_atBenchResults[i].acName, pcName) && g_atBenchResults[i].ucTasks == ucTasks)
+			return &g_atBenchResults[i];
+	}
+
+	/* the table fits all benchmarks, the last entry is reused if not */
+	if(g_ucBenchNumResults < BENCH_MAX_RESULTS)
+		g_ucBenchNumResults++;
+	ptResult = &g_atBenchResults[g_ucBenchNumResults - 1];
+	strncpy(ptResult->acName, pcName, sizeof(ptResult->acName) - 1);
+	ptResult->ucTasks = ucTasks;
+	ptResult->dNs = 1e30;
+
+	return ptResult;
+}
+
+/* keep the fastest run */
+static struct typBenchResult *ptBenchAdd(const char *pcName, unsigned char ucTasks, double dNs)
+{
+	struct typBenchResult *ptResult = ptBenchResult(pcName, ucTasks);
+
+	if(dNs < ptResult->dNs)
+		ptResult->dNs = dNs;
+
+	return ptResult;
+}
+
+/*
+ * run ucTasks empty tasks of period ulPeriod for BENCH_TICKS ticks,
+ * returns the time per tick including the task runs. The idle sleep ticks at
+ * once, a clock read costs about as much as a tick, so single ticks are not timed.
+ */
+static double dBenchRun(unsigned char ucTasks, unsigned long ulPeriod)
+{
+	unsigned long ulStart;
+	unsigned char i;
+
+	vSimReset(SIM_TICKS_NS(BENCH_TICKS), 0);
+	for(i = 0; i < ucTasks; i++)
+		tidCreateTask(vBenchTask, ulPeriod);
+
+	g_ulBenchRuns = 0;
+
+	ulStart = ulBenchNs();
+	vSimStart();
+
+	return (double)(ulBenchNs() - ulStart) / BENCH_TICKS;
+}
+
+/*
+ * tick_idle: time per tick with nothing due, the tick and a pass of the idle loop.
+ * tick_release: time per tick with all tasks released and run every tick.
+ * dispatch: what each task run adds to the tick, release, start and completion.
+ */
+static void vBenchScheduler(unsigned char ucTasks)
+{
+	struct typBenchResult *ptTick, *ptIdle;
+
+	/* all tasks released every tick */
+	ptTick = ptBenchAdd("tick_release", ucTasks, dBenchRun(ucTasks, 1));
+	/* nothing due, only the release check */
+	ptIdle = ptBenchAdd("tick_idle", ucTasks, dBenchRun(ucTasks, SCDL_MAX_TASK_PERIOD));
+
+	/* from the fastest runs so far */
+	ptBenchResult("dispatch", ucTasks)->dNs = (ptTick->dNs - ptIdle->dNs) / ucTasks;
+}
+
+static void vBenchCreate(unsigned char ucTasks)
+{
+	unsigned long ulStart;
+	unsigned long l;
+	unsigned char i;
+
+	/* the reset is a few stores, timed along with the tasks */
+	ulStart = ulBenchNs();
+	for(l = 0; l < BENCH_LOOPS / SCDL_MAX_NUM_TASKS; l++)
+	{
+		vResetScheduler();
+		for(i = 0; i < ucTasks; i++)
+			tidCreateTask(vBenchTask, i + 1);
+	}
+
+	ptBenchAdd("create", ucTasks, (double)(ulBenchNs() - ulStart) / (l * ucTasks));
+}
+
+static void vBenchSemaphores(void)
+{
+	volatile sema_t tSema = 0;
+	unsigned long ulStart;
+	unsigned long l;
+
+	ulStart = ulBenchNs();
+	for(l = 0; l < BENCH_LOOPS; l++)
+	{
+		SEMAPHORE_GIVE(tSema);
+		bSemaTake((sema_t *)&tSema);
+	}
+	ptBenchAdd("sema_give_take", 0, (double)(ulBenchNs() - ulStart) / BENCH_LOOPS);
+
+	ulStart = ulBenchNs();
+	for(l = 0; l < BENCH_LOOPS; l++)
+	{
+		SEMAPHORE_CNT_GIVE(tSema);
+		bSemaCntTake((sema_t *)&tSema);
+	}
+	ptBenchAdd("sema_cnt_give_take", 0, (double)(ulBenchNs() - ulStart) / BENCH_LOOPS);
+}
+
+/* one pass over all benchmarks, the results keep the fastest run of all passes */
+static void vBenchPass(void)
+{
+	static const unsigned char aucTasks[] = { 1, 4, 8, SCDL_MAX_NUM_TASKS };
+	unsigned char i, r;
+
+	for(r = 0; r < BENCH_REPEAT; r++)
+	{
+		for(i = 0; i < sizeof(aucTasks); i++)
+		{
+			vBenchScheduler(aucTasks[i]);
+			vBenchCreate(aucTasks[i]);
+		}
+		vBenchSemaphores();
+	}
+}
+
+/* compare to a stored run, returns the number of regressions, bPrint lists all results */
+static int iBenchCompare(const char *pcFile, double dThreshold, unsigned char bPrint)
+{
+	FILE *ptFile = fopen(pcFile, "r");
+	char acLine[128];
+	char acName[32];
+	unsigned int uiTasks;
+	double dBase, dChange;
+	unsigned char bRegression;
+	int iRegressions = 0;
+	unsigned char i;
+
+	if(!ptFile)
+	{
+		fprintf(stderr, "cannot open %s\n", pcFile);
+		return -1;
+	}
+
+	while(fgets(acLine, sizeof(acLine), ptFile))
+	{
+		if(sscanf(acLine, "%31[^,],%u,%lf", acName, &uiTasks, &dBase) != 3 || dBase <= 0)
+			continue;
+
+		for(i = 0; i < g_ucBenchNumResults; i++)
+		{
+			if(strcmp(g_atBenchResults[i].acName, acName) || g_atBenchResults[i].ucTasks != uiTasks)
+				continue;
+
+			dChange = (g_atBenchResults[i].dNs - dBase) * 100.0 / dBase;
+			bRegression = (dChange > dThreshold && g_atBenchResults[i].dNs - dBase > BENCH_MIN_DELTA_NS);
+			if(bPrint)
+				fprintf(stderr, "%-20s %2u %9.1f -> %9.1f ns %+6.1f%%%s\n", acName, uiTasks, dBase,
+						g_atBenchResults[i].dNs, dChange, bRegression ? "  REGRESSION" : "");
+			if(bRegression)
+				iRegressions++;
+		}
+	}
+
+	fclose(ptFile);
+	return iRegressions;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *pcBaseline = 0;
+	double dThreshold = 15.0;
+	int iRegressions;
+	unsigned char i;
+	int a;
+
+	for(a = 1; a < argc; a++)
+	{
+		if(!strcmp(argv[a], "-b") && a + 1 < argc)
+			pcBaseline = argv[++a];
+		else if(!strcmp(argv[a], "-t") && a + 1 < argc)
+			dThreshold = atof(argv[++a]);
+		else
+		{
+			fprintf(stderr, "usage: %s [-b baseline.csv] [-t percent]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	vBenchPass();
+	/* a slow phase of the host can last seconds, more passes give it a chance to end */
+	for(i = 1; pcBaseline && i < BENCH_PASSES && iBenchCompare(pcBaseline, dThreshold, 0) > 0; i++)
+		vBenchPass();
+
+	printf("name,tasks,ns\n");
+	for(i = 0; i < g_ucBenchNumResults; i++)
+		printf("%s,%u,%.1f\n", g_atBenchResults[i].acName, g_atBenchResults[i].ucTasks, g_atBenchResults[i].dNs);
+
+	if(!pcBaseline)
+		return 0;
+
+	iRegressions = iBenchCompare(pcBaseline, dThreshold, 1);
+	if(iRegressions < 0)
+		return 2;
+
+	fprintf(stderr, "%d regression(s) above %.1f%%\n", iRegressions, dThreshold);
+	return iRegressions ? 1 : 0;
+}
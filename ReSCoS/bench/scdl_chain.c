@@ -0,0 +1,238 @@
+/**************************************************************************************************
+  Filename:       scdl_chain.c
+  Author:         $Author: Menz $
+
+  Description:    Host simulation of the end-to-end latency of a sample -> filter -> transmit
+                  pipeline, built with SCDL_TASK_CHAINS. The stages run in virtual time, ticks
+                  interrupt them. They are either chained, or periodic tasks polling the output of
+                  the stage before, with the same phase and over all phases of filter and transmit.
+                  The latency is taken from the start of the sample to the end of the transmission,
+                  with and without a 2 ms task every 7 ms in between. A join of two sensors must
+                  start the fusion once per pair of samples. Results are written as csv lines
+                  "variant,samples,latency_avg_ms,latency_max_ms". See README.md for the build.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_chain.c */
+
+
+#include <stdio.h>
+
+#include "inc/scheduler.h"
+#include "scdl_port.h"
+#include "scdl_sim.h"
+
+#ifndef SCDL_TASK_CHAINS
+#error scdl_chain needs -DSCDL_TASK_CHAINS
+#endif
+
+/** simulated time per variant */
+#define CHAIN_SIM_NS		(60ULL * 1000000000ULL)
+/** period of the pipeline and run times of the stages and of the other task */
+#define CHAIN_PERIOD_MS		(10)
+#define CHAIN_SAMPLE_NS		(200000UL)
+#define CHAIN_FILTER_NS		(500000UL)
+#define CHAIN_TRANSMIT_NS	(300000UL)
+#define CHAIN_OTHER_NS		(2000000UL)
+#define CHAIN_OTHER_MS		(7)
+
+/* start of the sample handed on by the stages, set when the stage has one */
+static unsigned long long g_ullChainFilterIn;
+static unsigned long long g_ullChainTransmitIn;
+static unsigned char g_bChainFilterHas;
+static unsigned char g_bChainTransmitHas;
+static unsigned long g_ulChainSamples;
+static unsigned long long g_ullChainSumNs;
+static unsigned long long g_ullChainMaxNs;
+
+/* join of two sensors */
+static unsigned long g_ulChainSensA;
+static unsigned long g_ulChainSensB;
+static unsigned long g_ulChainFusions;
+static unsigned long g_ulChainFusionsWrong;
+
+/* virtual time, ns */
+unsigned long ulScdlPortCycles(void)
+{
+	return (unsigned long)g_ullSimNs;
+}
+
+static void vTaskChainSample(void)
+{
+	unsigned long long ullStart = g_ullSimNs;
+
+	vSimRun(CHAIN_SAMPLE_NS);
+	g_ullChainFilterIn = ullStart;
+	g_bChainFilterHas = 1;
+}
+
+/* the polling stages find nothing to do at most runs */
+static void vTaskChainFilter(void)
+{
+	unsigned long long ullStart;
+
+	if(!g_bChainFilterHas)
+		return;
+	g_bChainFilterHas = 0;
+	ullStart = g_ullChainFilterIn;
+
+	vSimRun(CHAIN_FILTER_NS);
+	g_ullChainTransmitIn = ullStart;
+	g_bChainTransmitHas = 1;
+}
+
+static void vTaskChainTransmit(void)
+{
+	unsigned long long ullLatency;
+
+	if(!g_bChainTransmitHas)
+		return;
+	g_bChainTransmitHas = 0;
+
+	vSimRun(CHAIN_TRANSMIT_NS);
+	ullLatency = g_ullSimNs - g_ullChainTransmitIn;
+	g_ullChainSumNs += ullLatency;
+	if(ullLatency > g_ullChainMaxNs)
+		g_ullChainMaxNs = ullLatency;
+	g_ulChainSamples++;
+}
+
+static void vTaskChainOther(void)
+{
+	vSimRun(CHAIN_OTHER_NS);
+}
+
+static void vTaskChainSensA(void)
+{
+	vSimRun(100000);
+	g_ulChainSensA++;
+}
+
+static void vTaskChainSensB(void)
+{
+	vSimRun(150000);
+	g_ulChainSensB++;
+}
+
+/* both sensors delivered exactly one more sample */
+static void vTaskChainFusion(void)
+{
+	g_ulChainFusions++;
+	if(g_ulChainSensA != g_ulChainFusions || g_ulChainSensB != g_ulChainFusions)
+		g_ulChainFusionsWrong++;
+}
+
+/* empty default instance and statistics */
+static void vChainReset(unsigned long long ullSimNs)
+{
+	vSimReset(ullSimNs, 0);
+	g_bChainFilterHas = 0;
+	g_bChainTransmitHas = 0;
+	g_ulChainSamples = 0;
+	g_ullChainSumNs = 0;
+	g_ullChainMaxNs = 0;
+}
+
+/* one run of the pipeline, chained or polling with the phases of filter and transmit */
+static void vChainRun(unsigned char bChained, unsigned long ulFilterPhase, unsigned long ulTransmitPhase,
+		unsigned char bOther)
+{
+	taskID_t tidSample, tidFilter, tidTransmit;
+
+	vChainReset(CHAIN_SIM_NS);
+	if(bOther)
+		tidCreateTask(vTaskChainOther, SCDL_MS_TO_TICKS(CHAIN_OTHER_MS));
+
+	tidSample = tidCreateTask(vTaskChainSample, SCDL_MS_TO_TICKS(CHAIN_PERIOD_MS));
+	if(bChained)
+	{
+		tidFilter = tidCreateTask(vTaskChainFilter, SCDL_INF_PERIOD);
+		tidTransmit = tidCreateTask(vTaskChainTransmit, SCDL_INF_PERIOD);
+		vTaskSetState(tidFilter, OFF);
+		vTaskSetState(tidTransmit, OFF);
+		vTaskChain(tidSample, tidFilter);
+		vTaskChain(tidFilter, tidTransmit);
+	}
+	else
+	{
+		tidFilter = tidCreateTask(vTaskChainFilter, SCDL_MS_TO_TICKS(CHAIN_PERIOD_MS));
+		tidTransmit = tidCreateTask(vTaskChainTransmit, SCDL_MS_TO_TICKS(CHAIN_PERIOD_MS));
+		vTaskSetPhase(tidFilter, ulFilterPhase);
+		vTaskSetPhase(tidTransmit, ulTransmitPhase);
+	}
+
+	vSimStart();
+}
+
+static void vChainPrint(const char *pcName)
+{
+	printf("%s,%lu,%.3f,%.3f\n", pcName, g_ulChainSamples,
+			g_ulChainSamples ? g_ullChainSumNs / 1e6 / g_ulChainSamples : 0.0, g_ullChainMaxNs / 1e6);
+}
+
+/* the polling pipeline over all phases of filter and transmit */
+static void vChainSweep(void)
+{
+	unsigned long ulFilter, ulTransmit, ulSamples = 0;
+	unsigned long long ullSumNs = 0, ullMaxNs = 0;
+
+	for(ulFilter = 0; ulFilter < SCDL_MS_TO_TICKS(CHAIN_PERIOD_MS); ulFilter++)
+	{
+		for(ulTransmit = 0; ulTransmit < SCDL_MS_TO_TICKS(CHAIN_PERIOD_MS); ulTransmit++)
+		{
+			vChainRun(0, ulFilter, ulTransmit, 0);
+			ulSamples += g_ulChainSamples;
+			ullSumNs += g_ullChainSumNs;
+			if(g_ullChainMaxNs > ullMaxNs)
+				ullMaxNs = g_ullChainMaxNs;
+		}
+	}
+
+	g_ulChainSamples = ulSamples;
+	g_ullChainSumNs = ullSumNs;
+	g_ullChainMaxNs = ullMaxNs;
+	vChainPrint("polling_all_phases");
+}
+
+/* two sensors 3 ticks apart joined by the fusion */
+static void vChainJoin(void)
+{
+	taskID_t tidA, tidB, tidFusion;
+
+	vChainReset(1000000000ULL);
+	g_ulChainSensA = 0;
+	g_ulChainSensB = 0;
+	g_ulChainFusions = 0;
+	g_ulChainFusionsWrong = 0;
+
+	tidA = tidCreateTask(vTaskChainSensA, SCDL_MS_TO_TICKS(CHAIN_PERIOD_MS));
+	tidB = tidCreateTask(vTaskChainSensB, SCDL_MS_TO_TICKS(CHAIN_PERIOD_MS));
+	tidFusion = tidCreateTask(vTaskChainFusion, SCDL_INF_PERIOD);
+	vTaskSetState(tidFusion, OFF);
+	vTaskSetPhase(tidB, 3);
+	vTaskChain(tidA, tidFusion);
+	vTaskChain(tidB, tidFusion);
+
+	vSimStart();
+}
+
+int main(void)
+{
+	printf("variant,samples,latency_avg_ms,latency_max_ms\n");
+	vChainRun(1, 0, 0, 0);
+	vChainPrint("chained");
+	vChainRun(1, 0, 0, 1);
+	vChainPrint("chained_other_task");
+	vChainRun(0, 0, 0, 0);
+	vChainPrint("polling_same_phase");
+	vChainRun(0, 0, 0, 1);
+	vChainPrint("polling_other_task");
+	vChainSweep();
+
+	vChainJoin();
+	printf("join,%lu,%lu,%lu\n", g_ulChainSensA, g_ulChainFusions, g_ulChainFusionsWrong);
+
+	/* a join must start once per pair, after both */
+	return (g_ulChainFusionsWrong || g_ulChainFusions + 1 < g_ulChainSensA) ? 1 : 0;
+}
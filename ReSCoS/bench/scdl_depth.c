@@ -0,0 +1,158 @@
+/**************************************************************************************************
+  Filename:       scdl_depth.c
+  Author:         $Author: Menz $
+
+  Description:    Host test of the stack measurement, built with SCDL_MEASURE_STACK. The port of
+                  the benchmark watches the lowest 64 KiB of the main stack. Tasks put buffers of
+                  known sizes on the stack, one of them growing from run to run and one of them
+                  interrupted by a tick at its deepest point. Every task's peak must cover its
+                  buffers, including the interrupt's, and exceed them by no more than DEPTH_SLACK
+                  bytes of frames. The stack used by main before vStartScheduler must not count
+                  for the first task. Results are written as csv lines "task,used_bytes,
+                  peak_bytes". The exit code is 1 on a wrong peak. See README.md for the build.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_depth.c */
+
+
+#include <stdio.h>
+
+#include "inc/scheduler.h"
+#include "inc/scdl_stack.h"
+#include "scdl_port.h"
+#include "scdl_sim.h"
+
+#ifndef SCDL_MEASURE_STACK
+#error scdl_depth needs -DSCDL_MEASURE_STACK
+#endif
+
+/** ticks of the test */
+#define DEPTH_TICKS			(3000UL)
+/** frames of the task, the buffer function and the measuring margin */
+#define DEPTH_SLACK			(512)
+/** buffer of the growing task grows by this much per run up to DEPTH_GROW_MAX */
+#define DEPTH_GROW_STEP		(16)
+#define DEPTH_GROW_MAX		(6000)
+/** buffer of the interrupted task and of the interrupt */
+#define DEPTH_IRQ_TASK		(512)
+#define DEPTH_IRQ			(1024)
+
+/*!
+ * one test task
+ */
+struct typDepthTask
+{
+	const char *pcName;
+	/** deepest buffers in bytes, including a nested interrupt */
+	unsigned long ulUsed;
+	taskID_t tid;
+};
+
+static unsigned long g_ulDepthGrow;
+static struct typDepthTask g_atDepth[5];
+
+/* no time is measured here */
+unsigned long ulScdlPortCycles(void)
+{
+	return 0;
+}
+
+/* ulBytes on the stack, all written, pfnDeep is called at the deepest point */
+static void __attribute__((noinline)) vDepthUse(unsigned long ulBytes, void (*pfnDeep)(void))
+{
+	volatile unsigned char *pucBuf = __builtin_alloca(ulBytes);
+	unsigned long i;
+
+	for(i = 0; i < ulBytes; i++)
+		pucBuf[i] = (unsigned char)i;
+	if(pfnDeep)
+		pfnDeep();
+	/* keeps the buffer alive up to here */
+	pucBuf[0] = pucBuf[ulBytes - 1];
+}
+
+/* the tick interrupt hitting a task, the interrupt uses stack of its own */
+static void vDepthIrq(void)
+{
+	vDepthUse(DEPTH_IRQ, vSimTick);
+}
+
+static void vTaskDepthNone(void)
+{
+}
+
+static void vTaskDepth1k(void)
+{
+	vDepthUse(1024, 0);
+}
+
+static void vTaskDepth4k(void)
+{
+	vDepthUse(4096, 0);
+}
+
+static void vTaskDepthGrow(void)
+{
+	if(g_ulDepthGrow < DEPTH_GROW_MAX)
+		g_ulDepthGrow += DEPTH_GROW_STEP;
+	vDepthUse(g_ulDepthGrow, 0);
+}
+
+static void vTaskDepthIrq(void)
+{
+	vDepthUse(DEPTH_IRQ_TASK, vDepthIrq);
+}
+
+int main(void)
+{
+	static void (* const apfnTasks[])(void) =
+	{
+		vTaskDepthNone, vTaskDepth1k, vTaskDepth4k, vTaskDepthGrow, vTaskDepthIrq
+	};
+	static const char * const apcNames[] = { "none", "1k", "4k", "grow", "irq" };
+	static const unsigned long aulUsed[] = { 0, 1024, 4096, DEPTH_GROW_MAX, DEPTH_IRQ_TASK + DEPTH_IRQ };
+	unsigned long ulPeak, ulMax, ulErrors;
+	unsigned char i;
+
+	/* the initialization is part of the overall peak */
+	vScdlStackPaint();
+
+	vSimReset(SIM_TICKS_NS(DEPTH_TICKS), 0);
+	for(i = 0; i < sizeof(g_atDepth) / sizeof(g_atDepth[0]); i++)
+	{
+		g_atDepth[i].pcName = apcNames[i];
+		g_atDepth[i].ulUsed = aulUsed[i];
+		g_atDepth[i].tid = tidCreateTask(apfnTasks[i], i + 1);
+	}
+
+	vSimStart();
+
+	ulMax = 0;
+	ulErrors = 0;
+	printf("task,used_bytes,peak_bytes\n");
+	for(i = 0; i < sizeof(g_atDepth) / sizeof(g_atDepth[0]); i++)
+	{
+		ulPeak = usScdlTaskGetStackPeak(g_atDepth[i].tid);
+		if(ulPeak < g_atDepth[i].ulUsed || ulPeak > g_atDepth[i].ulUsed + DEPTH_SLACK)
+			ulErrors++;
+		if(g_atDepth[i].ulUsed > ulMax)
+			ulMax = g_atDepth[i].ulUsed;
+		printf("%s,%lu,%lu\n", g_atDepth[i].pcName, g_atDepth[i].ulUsed, ulPeak);
+	}
+
+	/* the whole stack holds main and the scheduler above the deepest task */
+	ulPeak = ulScdlStackGetPeak();
+	if(ulPeak < ulMax || ulPeak > ulScdlStackGetSize())
+		ulErrors++;
+	printf("stack,%lu,%lu\n", ulScdlStackGetSize(), ulPeak);
+
+	if(ulErrors)
+	{
+		fprintf(stderr, "%lu wrong stack peaks\n", ulErrors);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,208 @@
+/**************************************************************************************************
+  Filename:       scdl_edf.c
+  Author:         $Author: Menz $
+
+  Description:    Host simulation of the deadline misses of random task sets, built once with the
+                  fixed priorities of the creation order and once with SCDL_EDF. Every task has a
+                  period of 10 to 100 ticks, its deadline is its period and its run time is a share
+                  of the utilization asked for. The tasks run in virtual time, every tick of run
+                  time is one vScdlTick. With SCDL_EDF the ready heap is checked after every tick.
+                  Results are written as csv lines "policy,utilization,sets,jobs,missed,
+                  missed_pct". See README.md for the build.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_edf.c */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "inc/scheduler.h"
+#include "scdl_port.h"
+#include "scdl_sim.h"
+
+/** task sets per utilization and ticks per set */
+#define EDF_SETS			(200)
+#define EDF_TICKS			(20000UL)
+/** tasks per set */
+#define EDF_MIN_TASKS		(3)
+#define EDF_MAX_TASKS		(8)
+/** range of the periods in ticks */
+#define EDF_MIN_PERIOD		(10)
+#define EDF_MAX_PERIOD		(100)
+
+#ifdef SCDL_EDF
+#define EDF_POLICY			"edf"
+#else
+#define EDF_POLICY			"fixed"
+#endif
+
+static unsigned char g_ucEdfTasks;
+static unsigned long g_aulEdfPeriod[EDF_MAX_TASKS];
+static unsigned long g_aulEdfRun[EDF_MAX_TASKS];
+/* tick of the last release */
+static unsigned long g_aulEdfRelease[EDF_MAX_TASKS];
+static unsigned long g_ulEdfNow;
+static unsigned long g_ulEdfJobs;
+static unsigned long g_ulEdfMissed;
+static unsigned long g_ulEdfHeapErrors;
+
+/* virtual time, no cycles */
+unsigned long ulScdlPortCycles(void)
+{
+	return 0;
+}
+
+#ifdef SCDL_EDF
+/* the heap holds the READY tasks, each at its ucHeapPos, no child due before its parent */
+static void vEdfCheckHeap(void)
+{
+	struct typScheduler *ptScdl = &g_tScdlDefault;
+	taskID_t tidParent, tidChild;
+	unsigned char i, ucReady = 0;
+
+	for(i = 0; i < g_ucEdfTasks; i++)
+	{
+		if(ptScdl->atTask[i].eTaskState != READY)
+			continue;
+		ucReady++;
+		if(ptScdl->atidReadyHeap[ptScdl->atTask[i].ucHeapPos] != i)
+			g_ulEdfHeapErrors++;
+	}
+	if(ucReady != ptScdl->ucNumReady)
+		g_ulEdfHeapErrors++;
+
+	for(i = 1; i < ucReady; i++)
+	{
+		tidParent = ptScdl->atidReadyHeap[(i - 1) / 2];
+		tidChild = ptScdl->atidReadyHeap[i];
+		if(!SCDL_TIME_REACHED(ptScdl->atTask[tidChild].ulDeadline, ptScdl->atTask[tidParent].ulDeadline))
+			g_ulEdfHeapErrors++;
+	}
+}
+#endif
+
+/* one tick, records the releases */
+static void vEdfTick(void)
+{
+	enum etypTaskStates aeBefore[EDF_MAX_TASKS];
+	unsigned char i;
+
+	for(i = 0; i < g_ucEdfTasks; i++)
+		aeBefore[i] = g_tScdlDefault.atTask[i].eTaskState;
+
+	vScdlTick();
+	g_ulEdfNow++;
+
+	/* released, the tick may also have started it */
+	for(i = 0; i < g_ucEdfTasks; i++)
+	{
+		if(aeBefore[i] == BLOCKED && g_tScdlDefault.atTask[i].eTaskState != BLOCKED)
+			g_aulEdfRelease[i] = g_ulEdfNow;
+	}
+
+#ifdef SCDL_EDF
+	vEdfCheckHeap();
+#endif
+}
+
+/* a job takes its run time in ticks and has to end within its period */
+static void vEdfJob(unsigned char i)
+{
+	unsigned long ulRelease = g_aulEdfRelease[i];
+
+	vSimRun(g_aulEdfRun[i] * SIM_TICK_NS);
+
+	g_ulEdfJobs++;
+	if(g_ulEdfNow - ulRelease > g_aulEdfPeriod[i])
+		g_ulEdfMissed++;
+}
+
+#define EDF_TASK(i)		static void vEdfTask##i(void) { vEdfJob(i); }
+EDF_TASK(0) EDF_TASK(1) EDF_TASK(2) EDF_TASK(3) EDF_TASK(4) EDF_TASK(5) EDF_TASK(6) EDF_TASK(7)
+static void (* const g_apfnEdfTasks[EDF_MAX_TASKS])(void) =
+{
+	vEdfTask0, vEdfTask1, vEdfTask2, vEdfTask3, vEdfTask4, vEdfTask5, vEdfTask6, vEdfTask7
+};
+
+/* one task set from g_aulEdfPeriod and g_aulEdfRun for EDF_TICKS ticks */
+static void vEdfSet(void)
+{
+	unsigned char i;
+
+	vSimReset(SIM_TICKS_NS(EDF_TICKS), vEdfTick);
+	/* created READY, the first tick starts the tasks */
+	for(i = 0; i < g_ucEdfTasks; i++)
+	{
+		tidCreateTask(g_apfnEdfTasks[i], g_aulEdfPeriod[i]);
+		g_aulEdfRelease[i] = 1;
+	}
+
+	g_ulEdfNow = 0;
+	g_ulEdfJobs = 0;
+	g_ulEdfMissed = 0;
+	vSimStart();
+}
+
+/* the same random sets for both policies at utilization dUtil */
+static void vEdfRun(double dUtil)
+{
+	double adWeight[EDF_MAX_TASKS], dSum;
+	unsigned long ulJobs = 0, ulMissed = 0;
+	unsigned int uiSet;
+	unsigned char i;
+
+	srand(42);
+	for(uiSet = 0; uiSet < EDF_SETS; uiSet++)
+	{
+		g_ucEdfTasks = EDF_MIN_TASKS + rand() % (EDF_MAX_TASKS - EDF_MIN_TASKS + 1);
+		dSum = 0;
+		for(i = 0; i < g_ucEdfTasks; i++)
+		{
+			g_aulEdfPeriod[i] = EDF_MIN_PERIOD + rand() % (EDF_MAX_PERIOD - EDF_MIN_PERIOD + 1);
+			adWeight[i] = 0.2 + (rand() % 100) / 100.0;
+			dSum += adWeight[i];
+		}
+		for(i = 0; i < g_ucEdfTasks; i++)
+		{
+			g_aulEdfRun[i] = (unsigned long)(adWeight[i] / dSum * dUtil * g_aulEdfPeriod[i] + 0.5);
+			if(!g_aulEdfRun[i])
+				g_aulEdfRun[i] = 1;
+		}
+
+		vEdfSet();
+		ulJobs += g_ulEdfJobs;
+		ulMissed += g_ulEdfMissed;
+	}
+
+	printf("%s,%.2f,%u,%lu,%lu,%.2f\n", EDF_POLICY, dUtil, EDF_SETS, ulJobs, ulMissed,
+			ulJobs ? 100.0 * ulMissed / ulJobs : 0.0);
+}
+
+int main(int argc, char *argv[])
+{
+	static const double adUtil[] = { 0.5, 0.7, 0.8, 0.9, 0.95, 1.0 };
+	int a;
+
+	printf("policy,utilization,sets,jobs,missed,missed_pct\n");
+	if(argc > 1)
+	{
+		for(a = 1; a < argc; a++)
+			vEdfRun(atof(argv[a]));
+	}
+	else
+	{
+		for(a = 0; a < (int)(sizeof(adUtil) / sizeof(adUtil[0])); a++)
+			vEdfRun(adUtil[a]);
+	}
+
+	if(g_ulEdfHeapErrors)
+	{
+		fprintf(stderr, "%lu errors in the ready heap\n", g_ulEdfHeapErrors);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,209 @@
+/**************************************************************************************************
+  Filename:       scdl_energy.c
+  Author:         $Author: Menz $
+
+  Description:    Wake-up and energy estimation of a task set. The scheduler runs on the host
+                  in virtual time with the task set given as "period_ms:run_us" arguments,
+                  SCDL_MEASURE_ACTIVITY records ticks, wake ups, sleep and task run times.
+                  Alternatively the counters of struct typScdlActivity read on a target are
+                  passed with -r, the task time as sum of aulTaskCycles in ms. For every
+                  power profile the active and sleep time and the charge are estimated for
+                  the ticked scheduler and for a tickless one that only wakes up when a task
+                  is released. See README.md for the build.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_energy.c */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "inc/scheduler.h"
+#include "scdl_port.h"
+#include "scdl_sim.h"
+
+#ifndef SCDL_MEASURE_ACTIVITY
+#error scdl_energy needs -DSCDL_MEASURE_ACTIVITY
+#endif
+
+
+/*!
+ * power profile of a MCU, typical data sheet values at the given supply and clock
+ */
+struct typPowerProfile
+{
+	const char *pcName;
+	unsigned short usSupplyMv;
+	/** current while running and while in the idle sleep of the port */
+	unsigned long ulActiveUa;
+	unsigned long ulSleepUa;
+	/** time from the interrupt to the first instruction, at active current */
+	unsigned short usWakeupNs;
+	/** run time of the tick ISR including the scheduler */
+	unsigned short usTickNs;
+};
+
+/* approximate, run times given on the command line must have been measured at these clocks */
+static const struct typPowerProfile g_atPowerProfiles[] =
+{
+	/* LaunchPad: 8 MHz DCO, LPM0 as in the msp430 port */
+	{ "msp430g2553_8mhz_lpm0", 3000, 2600, 300, 1500, 25000 },
+	/* same with LPM3 and the tick from ACLK */
+	{ "msp430g2553_8mhz_lpm3", 3000, 2600, 1, 1500, 25000 },
+	/* Stellaris LaunchPad: 16 MHz crystal without PLL, wfi as in the cm3 port */
+	{ "lm4f120_16mhz_sleep", 3300, 12000, 7000, 500, 10000 },
+	/* same with deep sleep */
+	{ "lm4f120_16mhz_deepsleep", 3300, 12000, 1500, 5000, 10000 },
+};
+#define NUM_POWER_PROFILES	(sizeof(g_atPowerProfiles) / sizeof(g_atPowerProfiles[0]))
+
+/*!
+ * what the estimation needs, from the simulation or a target
+ */
+struct typActivitySummary
+{
+	unsigned long long ullTicks;
+	/** wake ups of the ticked scheduler, and those a tickless one would still need */
+	unsigned long long ullWakeups;
+	unsigned long long ullReleaseWakeups;
+	/** run time of all tasks */
+	unsigned long long ullTaskNs;
+};
+
+static unsigned long g_aulSimRunNs[SCDL_MAX_NUM_TASKS];
+
+/* virtual time, ns */
+unsigned long ulScdlPortCycles(void)
+{
+	return (unsigned long)g_ullSimNs;
+}
+
+#define SIM_TASK(i)		static void vSimTask##i(void) { vSimRun(g_aulSimRunNs[i]); }
+SIM_TASK(0) SIM_TASK(1) SIM_TASK(2) SIM_TASK(3) SIM_TASK(4) SIM_TASK(5)
+SIM_TASK(6) SIM_TASK(7) SIM_TASK(8) SIM_TASK(9) SIM_TASK(10) SIM_TASK(11)
+static void (* const g_apfnSimTasks[SCDL_MAX_NUM_TASKS])(void) =
+{
+	vSimTask0, vSimTask1, vSimTask2, vSimTask3, vSimTask4, vSimTask5,
+	vSimTask6, vSimTask7, vSimTask8, vSimTask9, vSimTask10, vSimTask11
+};
+
+static void vSimulate(char **ppcTasks, unsigned char ucNumTasks, double dSeconds, struct typActivitySummary *ptSummary)
+{
+	struct typScdlActivity tActivity;
+	unsigned long ulPeriodMs, ulRunUs;
+	unsigned char i;
+
+	vSimReset((unsigned long long)(dSeconds * 1e9), 0);
+
+	for(i = 0; i < ucNumTasks; i++)
+	{
+		if(sscanf(ppcTasks[i], "%lu:%lu", &ulPeriodMs, &ulRunUs) != 2 || !ulPeriodMs)
+		{
+			fprintf(stderr, "bad task %s, expected period_ms:run_us\n", ppcTasks[i]);
+			exit(2);
+		}
+		g_aulSimRunNs[i] = ulRunUs * 1000;
+		tidCreateTask(g_apfnSimTasks[i], SCDL_MS_TO_TICKS(ulPeriodMs));
+	}
+
+	vSimStart();
+
+	vScdlGetActivity(&tActivity);
+
+	ptSummary->ullTicks = tActivity.ulTicks;
+	ptSummary->ullWakeups = tActivity.ulWakeups;
+	ptSummary->ullReleaseWakeups = tActivity.ulReleaseWakeups;
+	ptSummary->ullTaskNs = 0;
+	for(i = 0; i < ucNumTasks; i++)
+	{
+		ptSummary->ullTaskNs += tActivity.aulTaskCycles[i];
+		printf("task %u: %lu runs, %.3f ms\n", i, tActivity.aulTaskRuns[i], tActivity.aulTaskCycles[i] / 1e6);
+	}
+}
+
+/* charge in uC of dSeconds with the given active time */
+static double dCharge(const struct typPowerProfile *ptProfile, double dSeconds, double dActive)
+{
+	if(dActive > dSeconds)
+		dActive = dSeconds;
+
+	return dActive * ptProfile->ulActiveUa + (dSeconds - dActive) * ptProfile->ulSleepUa;
+}
+
+static void vEstimate(const struct typActivitySummary *ptSummary)
+{
+	const struct typPowerProfile *ptProfile;
+	double dSeconds = ptSummary->ullTicks * (SCDL_TICK_US / 1e6);
+	double dTask = ptSummary->ullTaskNs / 1e9;
+	double dTicked, dTickless, dQTicked, dQTickless;
+	/* ticks while a task ran cost the ISR in both cases */
+	unsigned long long ullBusyTicks = ptSummary->ullTicks - ptSummary->ullWakeups;
+	unsigned char i;
+
+	printf("%.3f s, %llu ticks, %llu wake ups (%llu with a release), tasks active %.3f ms\n",
+			dSeconds, ptSummary->ullTicks, ptSummary->ullWakeups, ptSummary->ullReleaseWakeups, dTask * 1e3);
+	printf("profile,mode,wakeups_per_s,active_ms_per_s,avg_ua,mj_per_hour\n");
+
+	for(i = 0; i < NUM_POWER_PROFILES; i++)
+	{
+		ptProfile = &g_atPowerProfiles[i];
+
+		dTicked = dTask + ptSummary->ullTicks * (ptProfile->usTickNs / 1e9)
+				+ ptSummary->ullWakeups * (ptProfile->usWakeupNs / 1e9);
+		dTickless = dTask + (ullBusyTicks + ptSummary->ullReleaseWakeups) * (ptProfile->usTickNs / 1e9)
+				+ ptSummary->ullReleaseWakeups * (ptProfile->usWakeupNs / 1e9);
+
+		dQTicked = dCharge(ptProfile, dSeconds, dTicked);
+		dQTickless = dCharge(ptProfile, dSeconds, dTickless);
+
+		printf("%s,ticked,%.1f,%.3f,%.1f,%.2f\n", ptProfile->pcName, ptSummary->ullWakeups / dSeconds,
+				dTicked * 1e3 / dSeconds, dQTicked / dSeconds, dQTicked / dSeconds * ptProfile->usSupplyMv * 3.6e-3);
+		printf("%s,tickless,%.1f,%.3f,%.1f,%.2f\n", ptProfile->pcName, ptSummary->ullReleaseWakeups / dSeconds,
+				dTickless * 1e3 / dSeconds, dQTickless / dSeconds, dQTickless / dSeconds * ptProfile->usSupplyMv * 3.6e-3);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	struct typActivitySummary tSummary;
+	double dSeconds = 10.0;
+	unsigned long ulTicks, ulWakeups, ulReleases;
+	double dActiveMs;
+	unsigned char bRecorded = 0;
+	int a;
+
+	for(a = 1; a < argc && argv[a][0] == '-'; a++)
+	{
+		if(!strcmp(argv[a], "-s") && a + 1 < argc)
+			dSeconds = atof(argv[++a]);
+		else if(!strcmp(argv[a], "-r") && a + 1 < argc
+				&& sscanf(argv[++a], "%lu,%lu,%lu,%lf", &ulTicks, &ulWakeups, &ulReleases, &dActiveMs) == 4)
+			bRecorded = 1;
+		else
+			break;
+	}
+
+	if((!bRecorded && (a >= argc || argc - a > SCDL_MAX_NUM_TASKS)) || (bRecorded && a != argc))
+	{
+		fprintf(stderr, "usage: %s [-s seconds] period_ms:run_us ...\n"
+						"       %s -r ticks,wakeups,release_wakeups,task_ms\n", argv[0], argv[0]);
+		return 2;
+	}
+
+	if(bRecorded)
+	{
+		tSummary.ullTicks = ulTicks;
+		tSummary.ullWakeups = ulWakeups;
+		tSummary.ullReleaseWakeups = ulReleases;
+		tSummary.ullTaskNs = (unsigned long long)(dActiveMs * 1e6);
+	}
+	else
+		vSimulate(&argv[a], (unsigned char)(argc - a), dSeconds, &tSummary);
+
+	vEstimate(&tSummary);
+
+	return 0;
+}
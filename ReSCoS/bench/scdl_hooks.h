@@ -0,0 +1,22 @@
+/*
+ * scdl_hooks.h
+ *
+ *  Hooks of the benchmark, see scdl_config.h. With BENCH_HOOKS_INLINE they are
+ *  empty inline functions, with BENCH_HOOKS_CALL calls of the functions in
+ *  scdl_bench.c, which the compiler cannot remove.
+ */
+
+/*! @file */
+
+#ifndef SCDL_HOOKS_H_
+#define SCDL_HOOKS_H_
+
+#ifdef BENCH_HOOKS_CALL
+void vBenchHookTask(unsigned char ucTask);
+void vBenchHook(void);
+#else
+static inline void vBenchHookTask(unsigned char ucTask) { (void)ucTask; }
+static inline void vBenchHook(void) { }
+#endif
+
+#endif /* SCDL_HOOKS_H_ */
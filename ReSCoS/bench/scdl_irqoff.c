@@ -0,0 +1,168 @@
+/**************************************************************************************************
+  Filename:       scdl_irqoff.c
+  Author:         $Author: Menz $
+
+  Description:    Host benchmark of the worst-case masked window, built with SCDL_MEASURE_IRQ_OFF
+                  and the options of the configuration to compare. For 1 to SCDL_MAX_NUM_TASKS
+                  tasks it reports the longest critical section of the scheduler and the longest
+                  tick, both run with interrupts masked on a target. Results are written as csv
+                  lines "config,load,tasks,irq_off_ns,tick_ns" and contain one clock read. See
+                  README.md for the build.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_irqoff.c */
+
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "inc/scheduler.h"
+#include "scdl_port.h"
+#include "scdl_sim.h"
+
+#ifndef SCDL_MEASURE_IRQ_OFF
+#error build with -DSCDL_MEASURE_IRQ_OFF
+#endif
+
+/** ticks per scheduler run */
+#define IRQOFF_TICKS		(200UL)
+/**
+ * runs per result. A run preempted by the host shows a long window, so the
+ * smallest maximum of all runs counts.
+ */
+#define IRQOFF_REPEAT		(101)
+
+/* what the tasks do */
+enum eIrqOffLoad
+{
+	/* nothing, all tasks are released every tick */
+	IRQOFF_EMPTY,
+	/* each task makes the next one ready, so the scheduler API is called from tasks */
+	IRQOFF_API,
+	IRQOFF_NUM_LOADS
+};
+
+static const char * const g_apcIrqOffLoads[IRQOFF_NUM_LOADS] = { "empty", "api" };
+
+static unsigned char g_ucIrqOffTasks;
+static enum eIrqOffLoad g_eIrqOffLoad;
+
+unsigned long ulScdlPortCycles(void)
+{
+	struct timespec tNow;
+
+	clock_gettime(CLOCK_MONOTONIC, &tNow);
+	return (unsigned long)tNow.tv_sec * 1000000000UL + (unsigned long)tNow.tv_nsec;
+}
+
+/* smallest time between two clock reads, contained in every result */
+static unsigned long ulIrqOffClockNs(void)
+{
+	unsigned long ulStart, ulNs, ulMin = ~0UL;
+	unsigned short i;
+
+	for(i = 0; i < 1000; i++)
+	{
+		ulStart = ulScdlPortCycles();
+		ulNs = ulScdlPortCycles() - ulStart;
+		if(ulNs < ulMin)
+			ulMin = ulNs;
+	}
+
+	return ulMin;
+}
+
+static void vIrqOffTask(void)
+{
+	taskID_t tidNext;
+
+	if(g_eIrqOffLoad != IRQOFF_API)
+		return;
+
+	/* the next task, it is released by the tick anyway */
+	tidNext = g_tScdlDefault.tidActiveTask + 1;
+	if(tidNext < g_ucIrqOffTasks)
+		vTaskSetState(tidNext, READY);
+}
+
+/* one run of IRQOFF_TICKS ticks, returns the longest critical section, pulTick the longest tick */
+static unsigned long ulIrqOffRun(unsigned char ucTasks, unsigned long *pulTick)
+{
+	unsigned char i;
+
+	vSimReset(SIM_TICKS_NS(IRQOFF_TICKS), 0);
+	g_ucIrqOffTasks = ucTasks;
+	for(i = 0; i < ucTasks; i++)
+		tidCreateTask(vIrqOffTask, 1);
+
+	vScdlResetIrqOffStats();
+	vSimStart();
+
+	*pulTick = ulScdlGetMaxTickDuration();
+	return ulScdlGetMaxIrqOff();
+}
+
+/* the scheduler options of this build */
+static void vIrqOffConfig(char *pcConfig, unsigned int uiSize)
+{
+	pcConfig[0] = 0;
+#ifdef SCDL_EDF
+	strncat(pcConfig, "edf ", uiSize - strlen(pcConfig) - 1);
+#endif
+#ifdef SCDL_AUTO_PRIO
+	strncat(pcConfig, "auto_prio ", uiSize - strlen(pcConfig) - 1);
+#endif
+#ifdef SCDL_TASK_CHAINS
+	strncat(pcConfig, "chains ", uiSize - strlen(pcConfig) - 1);
+#endif
+#ifdef SCDL_MODES
+	strncat(pcConfig, "modes ", uiSize - strlen(pcConfig) - 1);
+#endif
+#ifdef SCDL_TIMERS
+	strncat(pcConfig, "timers ", uiSize - strlen(pcConfig) - 1);
+#endif
+#ifdef SCDL_URGENT_TASKS
+	strncat(pcConfig, "urgent ", uiSize - strlen(pcConfig) - 1);
+#endif
+	if(!pcConfig[0])
+		strncat(pcConfig, "default", uiSize - 1);
+	else
+		pcConfig[strlen(pcConfig) - 1] = 0;
+}
+
+int main(void)
+{
+	static const unsigned char aucTasks[] = { 1, 4, 8, SCDL_MAX_NUM_TASKS };
+	char acConfig[64];
+	unsigned long ulIrqOff, ulTick;
+	unsigned long ulIrqOffMin, ulTickMin;
+	unsigned char i, r;
+
+	vIrqOffConfig(acConfig, sizeof(acConfig));
+	fprintf(stderr, "results include one clock read of %lu ns\n", ulIrqOffClockNs());
+
+	printf("config,load,tasks,irq_off_ns,tick_ns\n");
+	for(g_eIrqOffLoad = IRQOFF_EMPTY; g_eIrqOffLoad < IRQOFF_NUM_LOADS; g_eIrqOffLoad++)
+	{
+		for(i = 0; i < sizeof(aucTasks); i++)
+		{
+			ulIrqOffMin = ~0UL;
+			ulTickMin = ~0UL;
+			for(r = 0; r < IRQOFF_REPEAT; r++)
+			{
+				ulIrqOff = ulIrqOffRun(aucTasks[i], &ulTick);
+				if(ulIrqOff < ulIrqOffMin)
+					ulIrqOffMin = ulIrqOff;
+				if(ulTick < ulTickMin)
+					ulTickMin = ulTick;
+			}
+			printf("%s,%s,%u,%lu,%lu\n", acConfig, g_apcIrqOffLoads[g_eIrqOffLoad], aucTasks[i],
+					ulIrqOffMin, ulTickMin);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,248 @@
+/**************************************************************************************************
+  Filename:       scdl_modes.c
+  Author:         $Author: Menz $
+
+  Description:    Host test of the operating modes, built with SCDL_MODES. Five tasks run in
+                  virtual time with random run times, ticks interrupt them. Two modes select
+                  different tasks, one task is in both with a period of its own per mode, and an
+                  event task is set READY by the ISR at random. The ISR and two tasks request
+                  random modes, one of them creates a task outside both modes while one of them
+                  is in effect. After every switch tick no task outside the new mode may start or
+                  be READY, periodic tasks entering the mode must be released on the switch tick,
+                  and the shared task must keep the period of the mode. A reset instance must be
+                  back in all tasks mode. Results are written as csv lines "name,count". The exit
+                  code is 1 on a violation. See README.md for the build.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_modes.c */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "inc/scheduler.h"
+#include "scdl_port.h"
+#include "scdl_sim.h"
+
+#ifndef SCDL_MODES
+#error scdl_modes needs -DSCDL_MODES
+#endif
+
+/** simulated time */
+#define MODES_SIM_NS		(600ULL * 1000000000ULL)
+
+/* the test tasks, created in this order, the late one by task A in mode 1 or 2 */
+enum etypModesTasks { MODES_A, MODES_B, MODES_C, MODES_EVENT, MODES_SHARED, MODES_LATE, MODES_NUM_TASKS };
+
+static const unsigned long g_aulModesPeriods[MODES_NUM_TASKS] = { 5, 7, 3, SCDL_INF_PERIOD, 20, 4 };
+/* the shared task runs every 10 ticks in mode 1 and every 2 in mode 2 */
+static const unsigned long g_aulModes1Periods[SCDL_MAX_NUM_TASKS] = { 0, 0, 0, 0, 10 };
+static const unsigned long g_aulModes2Periods[SCDL_MAX_NUM_TASKS] = { 0, 0, 0, 0, 2 };
+static const struct typScdlMode g_tModes1 =
+{
+	SCDL_TASK_BIT(MODES_A) | SCDL_TASK_BIT(MODES_B) | SCDL_TASK_BIT(MODES_SHARED), g_aulModes1Periods
+};
+static const struct typScdlMode g_tModes2 =
+{
+	SCDL_TASK_BIT(MODES_C) | SCDL_TASK_BIT(MODES_EVENT) | SCDL_TASK_BIT(MODES_SHARED), g_aulModes2Periods
+};
+static const struct typScdlMode * const g_aptModes[] = { &g_tModes1, &g_tModes2, SCDL_MODE_ALL };
+
+/* mode in effect, tick of its switch and the last start of the shared task in it */
+static const struct typScdlMode *g_ptModesMode = SCDL_MODE_ALL;
+static scdlTicks_t g_ulModesSwitch;
+static scdlTicks_t g_ulModesSharedLast;
+static unsigned char g_bModesSharedRan;
+
+static unsigned long g_ulModesStarts;
+static unsigned long g_ulModesSwitches;
+static unsigned long g_ulModesRequests;
+static unsigned long g_ulModesEntered;
+static unsigned long g_ulModesOutside;
+static unsigned long g_ulModesNotReleased;
+static unsigned long g_ulModesWrongPeriod;
+static unsigned long g_ulModesAfterReset;
+
+/* virtual time, ns */
+unsigned long ulScdlPortCycles(void)
+{
+	return (unsigned long)g_ullSimNs;
+}
+
+static scdlTaskMask_t tModesMask(const struct typScdlMode *ptMode)
+{
+	return ptMode ? ptMode->tTasks : SCDL_ALL_TASKS;
+}
+
+static unsigned long ulModesPeriod(const struct typScdlMode *ptMode, unsigned char ucTask)
+{
+	if(ptMode && ptMode->pulPeriods && ptMode->pulPeriods[ucTask])
+		return ptMode->pulPeriods[ucTask];
+
+	return g_aulModesPeriods[ucTask];
+}
+
+/* the states right after a switch tick */
+static void vModesCheckSwitch(const struct typScdlMode *ptOld)
+{
+	enum etypTaskStates eState;
+	unsigned char i;
+
+	for(i = 0; i < g_tScdlDefault.ucNumTasks; i++)
+	{
+		eState = g_tScdlDefault.atTask[i].eTaskState;
+		if(!(tModesMask(g_ptModesMode) & SCDL_TASK_BIT(i)))
+		{
+			/* only the task running at the switch may still be active */
+			if(eState == READY)
+				g_ulModesOutside++;
+		}
+		else if(!(tModesMask(ptOld) & SCDL_TASK_BIT(i)) && ulModesPeriod(g_ptModesMode, i) != SCDL_INF_PERIOD)
+		{
+			g_ulModesEntered++;
+			if(eState != READY && eState != ACTIVE)
+				g_ulModesNotReleased++;
+		}
+	}
+}
+
+/* tick interrupt, it requests modes and events at random */
+static void vModesTick(void)
+{
+	const struct typScdlMode *ptOld = g_ptModesMode;
+
+	if(rand() % 50 == 0)
+	{
+		vSetMode(g_aptModes[rand() % 3]);
+		g_ulModesRequests++;
+	}
+
+	vScdlTick();
+
+	if(ptGetMode() != ptOld)
+	{
+		g_ptModesMode = ptGetMode();
+		g_ulModesSwitch = ulScdlGetTicks();
+		g_bModesSharedRan = 0;
+		g_ulModesSwitches++;
+		vModesCheckSwitch(ptOld);
+	}
+
+	/* an event for the event task, ignored outside its mode */
+	if(rand() % 97 == 0)
+		vTaskSetState(MODES_EVENT, READY);
+}
+
+/* every start must be in the mode in effect */
+static void vModesStart(unsigned char ucTask)
+{
+	g_ulModesStarts++;
+	if(!(tModesMask(g_ptModesMode) & SCDL_TASK_BIT(ucTask)))
+		g_ulModesOutside++;
+}
+
+/* a task requesting a random mode now and then */
+static void vModesRequest(void)
+{
+	if(rand() % 40 == 0)
+	{
+		vSetMode(g_aptModes[rand() % 3]);
+		g_ulModesRequests++;
+	}
+}
+
+static void vTaskModesLate(void)
+{
+	vModesStart(MODES_LATE);
+	vSimRun(300000);
+}
+
+static void vTaskModesA(void)
+{
+	vModesStart(MODES_A);
+	vSimRun(rand() % 3000000);
+	vModesRequest();
+
+	/* a new task must not be released outside the mode, not even until the next tick */
+	if(g_tScdlDefault.ucNumTasks == MODES_LATE && g_ptModesMode != SCDL_MODE_ALL)
+	{
+		tidCreateTask(vTaskModesLate, g_aulModesPeriods[MODES_LATE]);
+		if(g_tScdlDefault.atTask[MODES_LATE].eTaskState == READY)
+			g_ulModesOutside++;
+	}
+}
+
+static void vTaskModesB(void)
+{
+	vModesStart(MODES_B);
+	vSimRun(rand() % 1500000);
+}
+
+static void vTaskModesC(void)
+{
+	vModesStart(MODES_C);
+	vSimRun(rand() % 800000);
+	vModesRequest();
+}
+
+static void vTaskModesEvent(void)
+{
+	vModesStart(MODES_EVENT);
+	vSimRun(200000);
+}
+
+/* starts in one mode are at least its period apart */
+static void vTaskModesShared(void)
+{
+	scdlTicks_t ulNow = ulScdlGetTicks();
+
+	vModesStart(MODES_SHARED);
+	if(g_bModesSharedRan && ulNow - g_ulModesSharedLast < ulModesPeriod(g_ptModesMode, MODES_SHARED))
+		g_ulModesWrongPeriod++;
+	/* the first start in a mode may follow one of the mode before */
+	g_bModesSharedRan = (ulNow != g_ulModesSwitch);
+	g_ulModesSharedLast = ulNow;
+
+	vSimRun(100000);
+}
+
+int main(int argc, char *argv[])
+{
+	static void (* const apfnTasks[MODES_LATE])(void) =
+	{
+		vTaskModesA, vTaskModesB, vTaskModesC, vTaskModesEvent, vTaskModesShared
+	};
+	unsigned long ulViolations;
+	unsigned char i;
+
+	srand(argc > 1 ? (unsigned int)atoi(argv[1]) : 1);
+
+	vSimReset(MODES_SIM_NS, vModesTick);
+	for(i = 0; i < MODES_LATE; i++)
+		tidCreateTask(apfnTasks[i], g_aulModesPeriods[i]);
+
+	vSimStart();
+
+	/* a reset instance is in all tasks mode and forgets a pending request */
+	vSetMode(&g_tModes1);
+	vSimReset(MODES_SIM_NS, 0);
+	vScdlTick();
+	if(ptGetMode() != SCDL_MODE_ALL)
+		g_ulModesAfterReset++;
+
+	printf("name,count\n");
+	printf("starts,%lu\n", g_ulModesStarts);
+	printf("requests,%lu\n", g_ulModesRequests);
+	printf("switches,%lu\n", g_ulModesSwitches);
+	printf("tasks_entering,%lu\n", g_ulModesEntered);
+	printf("outside_mode,%lu\n", g_ulModesOutside);
+	printf("not_released_on_switch,%lu\n", g_ulModesNotReleased);
+	printf("wrong_period,%lu\n", g_ulModesWrongPeriod);
+	printf("mode_after_reset,%lu\n", g_ulModesAfterReset);
+
+	ulViolations = g_ulModesOutside + g_ulModesNotReleased + g_ulModesWrongPeriod + g_ulModesAfterReset;
+
+	return ulViolations ? 1 : 0;
+}
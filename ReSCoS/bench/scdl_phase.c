@@ -0,0 +1,179 @@
+/**************************************************************************************************
+  Filename:       scdl_phase.c
+  Author:         $Author: Menz $
+
+  Description:    Peak load of a task set before and after vScdlAutoPhase, built with
+                  SCDL_AUTO_PHASE. The task set is given as "period_ms:run_us" arguments. For
+                  both the peak number of releases on one tick is taken from ucScdlPeakReleases
+                  over the hyperperiod, then the scheduler runs two hyperperiods in virtual time
+                  and records the releases per tick and the worst response time of each task,
+                  from its release to its end. See README.md for the build.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_phase.c */
+
+
+#include <stdio.h>
+
+#include "inc/scheduler.h"
+#include "scdl_port.h"
+#include "scdl_sim.h"
+
+#ifndef SCDL_AUTO_PHASE
+#error scdl_phase needs -DSCDL_AUTO_PHASE
+#endif
+
+/** longest hyperperiod simulated */
+#define SIM_MAX_HYPER		(10000000UL)
+
+
+static unsigned char g_ucSimTasks;
+static unsigned long g_aulSimPeriodMs[SCDL_MAX_NUM_TASKS];
+static unsigned long g_aulSimRunNs[SCDL_MAX_NUM_TASKS];
+/* last release, worst response */
+static unsigned long long g_aullSimRelease[SCDL_MAX_NUM_TASKS];
+static unsigned long long g_aullSimResponse[SCDL_MAX_NUM_TASKS];
+static unsigned char g_ucSimPeak;
+
+/* virtual time, ns */
+unsigned long ulScdlPortCycles(void)
+{
+	return (unsigned long)g_ullSimNs;
+}
+
+/* tick interrupt, records the releases */
+static void vSimPhaseTick(void)
+{
+	enum etypTaskStates aeBefore[SCDL_MAX_NUM_TASKS];
+	unsigned char i, ucReleases = 0;
+
+	for(i = 0; i < g_ucSimTasks; i++)
+		aeBefore[i] = g_tScdlDefault.atTask[i].eTaskState;
+
+	vScdlTick();
+
+	for(i = 0; i < g_ucSimTasks; i++)
+	{
+		/* created READY, released by the first tick */
+		if((aeBefore[i] == BLOCKED || (aeBefore[i] == READY && g_tScdlDefault.ulSystemTicks == 1))
+				&& g_tScdlDefault.atTask[i].eTaskState != BLOCKED)
+		{
+			g_aullSimRelease[i] = g_ullSimNs;
+			ucReleases++;
+		}
+	}
+	if(ucReleases > g_ucSimPeak)
+		g_ucSimPeak = ucReleases;
+}
+
+static void vSimTask(unsigned char i)
+{
+	unsigned long long ullRelease = g_aullSimRelease[i];
+
+	vSimRun(g_aulSimRunNs[i]);
+	if(g_ullSimNs - ullRelease > g_aullSimResponse[i])
+		g_aullSimResponse[i] = g_ullSimNs - ullRelease;
+}
+
+#define SIM_TASK(i)		static void vSimTask##i(void) { vSimTask(i); }
+SIM_TASK(0) SIM_TASK(1) SIM_TASK(2) SIM_TASK(3) SIM_TASK(4) SIM_TASK(5)
+SIM_TASK(6) SIM_TASK(7) SIM_TASK(8) SIM_TASK(9) SIM_TASK(10) SIM_TASK(11)
+static void (* const g_apfnSimTasks[SCDL_MAX_NUM_TASKS])(void) =
+{
+	vSimTask0, vSimTask1, vSimTask2, vSimTask3, vSimTask4, vSimTask5,
+	vSimTask6, vSimTask7, vSimTask8, vSimTask9, vSimTask10, vSimTask11
+};
+
+static unsigned long ulSimGcd(unsigned long a, unsigned long b)
+{
+	unsigned long t;
+
+	while(b)
+	{
+		t = a % b;
+		a = b;
+		b = t;
+	}
+
+	return a;
+}
+
+/* one run of two hyperperiods, phases chosen with bAuto, returns the peak of ucScdlPeakReleases */
+static unsigned char ucSimulate(unsigned char bAuto, unsigned long ulHyper)
+{
+	unsigned long aulPhase[SCDL_MAX_NUM_TASKS];
+	unsigned char ucPeak, i;
+
+	vSimReset(2 * ulHyper * SIM_TICK_NS + SIM_TICK_NS, vSimPhaseTick);
+	for(i = 0; i < g_ucSimTasks; i++)
+	{
+		tidCreateTask(g_apfnSimTasks[i], SCDL_MS_TO_TICKS(g_aulSimPeriodMs[i]));
+		g_aullSimResponse[i] = 0;
+	}
+
+	if(bAuto)
+		vScdlAutoPhase(SCDL_DEFAULT);
+	ucPeak = ucScdlPeakReleases(SCDL_DEFAULT, ulHyper);
+	for(i = 0; i < g_ucSimTasks; i++)
+	{
+		/* a phased task is BLOCKED until tick phase + 1 */
+		aulPhase[i] = (g_tScdlDefault.atTask[i].eTaskState == READY) ? 0 : g_tScdlDefault.atTask[i].ulNextStartTime - 1;
+	}
+
+	g_ucSimPeak = 0;
+	vSimStart();
+
+	for(i = 0; i < g_ucSimTasks; i++)
+	{
+		printf("%s,%u,%lu,%lu,%.3f,%.1f\n", bAuto ? "auto" : "none", i, g_aulSimPeriodMs[i],
+				g_aulSimRunNs[i] / 1000, SCDL_TICKS_TO_US(aulPhase[i]) / 1e3, g_aullSimResponse[i] / 1e3);
+	}
+
+	return ucPeak;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned long ulPeriodMs, ulRunUs, ulTicks, ulHyper = 1;
+	unsigned char ucPeakNone, ucPeakSimNone, ucPeakAuto;
+	int a;
+
+	if(argc < 2 || argc - 1 > SCDL_MAX_NUM_TASKS)
+	{
+		fprintf(stderr, "usage: %s period_ms:run_us ...\n", argv[0]);
+		return 2;
+	}
+
+	for(a = 1; a < argc; a++)
+	{
+		if(sscanf(argv[a], "%lu:%lu", &ulPeriodMs, &ulRunUs) != 2 || SCDL_MS_TO_TICKS(ulPeriodMs) == 0)
+		{
+			fprintf(stderr, "bad task %s, expected period_ms:run_us\n", argv[a]);
+			return 2;
+		}
+		g_aulSimPeriodMs[g_ucSimTasks] = ulPeriodMs;
+		g_aulSimRunNs[g_ucSimTasks++] = ulRunUs * 1000;
+
+		/* the hyperperiod is the lcm of all periods */
+		ulTicks = SCDL_MS_TO_TICKS(ulPeriodMs);
+		ulHyper = ulHyper / ulSimGcd(ulHyper, ulTicks) * ulTicks;
+		if(ulHyper > SIM_MAX_HYPER)
+		{
+			fprintf(stderr, "hyperperiod above %lu ticks\n", SIM_MAX_HYPER);
+			return 2;
+		}
+	}
+
+	printf("phases,task,period_ms,run_us,phase_ms,response_max_us\n");
+	ucPeakNone = ucSimulate(0, ulHyper);
+	ucPeakSimNone = g_ucSimPeak;
+	ucPeakAuto = ucSimulate(1, ulHyper);
+
+	printf("phases,peak_releases,peak_simulated\n");
+	printf("none,%u,%u\n", ucPeakNone, ucPeakSimNone);
+	printf("auto,%u,%u\n", ucPeakAuto, g_ucSimPeak);
+
+	return 0;
+}
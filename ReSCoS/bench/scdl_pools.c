@@ -0,0 +1,273 @@
+/**************************************************************************************************
+  Filename:       scdl_pools.c
+  Author:         $Author: Menz $
+
+  Description:    Host benchmark of the fixed-block pools of scdl_pool.h against malloc, built with
+                  SCDL_POOLS. The cost of a free followed by an allocation is timed on a working
+                  set of half the blocks, then a stress test keeps a budget of live buffers of 8 to
+                  256 bytes for millions of random allocations and frees. For malloc the address
+                  span of the live buffers shows the fragmentation, the pools must hand out every
+                  block again afterwards. Results are written as csv lines "name,ns" and
+                  "allocator,storage_bytes,peak_live_bytes,peak_span_bytes,failed". The exit code
+                  is 1 if a pool loses a block. See README.md for the build.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_pools.c */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "inc/scheduler.h"
+#include "inc/scdl_pool.h"
+#include "scdl_port.h"
+
+#ifndef SCDL_POOLS
+#error scdl_pools needs -DSCDL_POOLS
+#endif
+
+/** blocks of the timed pool, half of them are in use */
+#define POOLS_BLOCKS		(256)
+#define POOLS_BLOCK_SIZE	(64)
+#define POOLS_OPS			(20000000UL)
+/** stress test: operations, buffer slots, live bytes and sizes */
+#define POOLS_STRESS_OPS	(5000000UL)
+#define POOLS_SLOTS			(2048)
+#define POOLS_BUDGET		(40UL * 1024)
+#define POOLS_MIN_SIZE		(8)
+#define POOLS_MAX_SIZE		(256)
+/** blocks of the stress pools of 16, 64 and 256 bytes, enough for the budget */
+#define POOLS_SMALL_BLOCKS	(64)
+#define POOLS_MID_BLOCKS	(128)
+#define POOLS_BIG_BLOCKS	(288)
+
+SCDL_POOL_STORAGE(g_apvPoolsMem, POOLS_BLOCK_SIZE, POOLS_BLOCKS);
+/* the stress pools by size class */
+SCDL_POOL_STORAGE(g_apvPoolsSmall, 16, POOLS_SMALL_BLOCKS);
+SCDL_POOL_STORAGE(g_apvPoolsMid, 64, POOLS_MID_BLOCKS);
+SCDL_POOL_STORAGE(g_apvPoolsBig, 256, POOLS_BIG_BLOCKS);
+
+static struct typScdlPool g_tPoolsTimed;
+static struct typScdlPool g_atPoolsClass[3];
+static void *g_apvPoolsLive[POOLS_SLOTS];
+static unsigned short g_ausPoolsSize[POOLS_SLOTS];
+static unsigned long g_ulPoolsRand = 1;
+
+unsigned long ulScdlPortCycles(void)
+{
+	struct timespec tNow;
+
+	clock_gettime(CLOCK_MONOTONIC, &tNow);
+	return (unsigned long)tNow.tv_sec * 1000000000UL + (unsigned long)tNow.tv_nsec;
+}
+
+/* no scheduler run here */
+void vBenchIdle(void)
+{
+}
+
+/* same sequence on every host, unlike rand */
+static unsigned long ulPoolsRand(void)
+{
+	g_ulPoolsRand = g_ulPoolsRand * 1103515245UL + 12345UL;
+	return (g_ulPoolsRand >> 16) & 0x7FFF;
+}
+
+/* ns per free and allocation, a random buffer of the working set is replaced each time */
+static double dPoolsTimePool(void)
+{
+	unsigned long i, k, ulStart;
+
+	vScdlPoolInit(&g_tPoolsTimed, g_apvPoolsMem, POOLS_BLOCK_SIZE, POOLS_BLOCKS);
+	for(i = 0; i < POOLS_BLOCKS / 2; i++)
+		g_apvPoolsLive[i] = pvScdlPoolAlloc(&g_tPoolsTimed);
+
+	ulStart = ulScdlPortCycles();
+	for(i = 0; i < POOLS_OPS; i++)
+	{
+		k = ulPoolsRand() % (POOLS_BLOCKS / 2);
+		vScdlPoolFree(&g_tPoolsTimed, g_apvPoolsLive[k]);
+		g_apvPoolsLive[k] = pvScdlPoolAlloc(&g_tPoolsTimed);
+	}
+	ulStart = ulScdlPortCycles() - ulStart;
+
+	for(i = 0; i < POOLS_BLOCKS / 2; i++)
+	{
+		vScdlPoolFree(&g_tPoolsTimed, g_apvPoolsLive[i]);
+		g_apvPoolsLive[i] = 0;
+	}
+
+	return (double)ulStart / POOLS_OPS;
+}
+
+/* the same for malloc, with the block size or random sizes */
+static double dPoolsTimeMalloc(unsigned char bRandom)
+{
+	unsigned long i, k, ulStart;
+
+	for(i = 0; i < POOLS_BLOCKS / 2; i++)
+		g_apvPoolsLive[i] = malloc(POOLS_BLOCK_SIZE);
+
+	ulStart = ulScdlPortCycles();
+	for(i = 0; i < POOLS_OPS; i++)
+	{
+		k = ulPoolsRand() % (POOLS_BLOCKS / 2);
+		free(g_apvPoolsLive[k]);
+		g_apvPoolsLive[k] = malloc(bRandom ? POOLS_MIN_SIZE + ulPoolsRand() % (POOLS_MAX_SIZE - POOLS_MIN_SIZE + 1)
+				: POOLS_BLOCK_SIZE);
+	}
+	ulStart = ulScdlPortCycles() - ulStart;
+
+	for(i = 0; i < POOLS_BLOCKS / 2; i++)
+	{
+		free(g_apvPoolsLive[i]);
+		g_apvPoolsLive[i] = 0;
+	}
+
+	return (double)ulStart / POOLS_OPS;
+}
+
+/* pool of the size class of usSize */
+static struct typScdlPool *ptPoolsClass(unsigned short usSize)
+{
+	if(usSize <= 16)
+		return &g_atPoolsClass[0];
+	if(usSize <= 64)
+		return &g_atPoolsClass[1];
+	return &g_atPoolsClass[2];
+}
+
+/*
+ * random allocations and frees below POOLS_BUDGET live bytes, from malloc or from the
+ * pools of the size classes. The span from the lowest to the highest live byte is the
+ * memory the heap has to provide.
+ */
+static void vPoolsStress(unsigned char bPools)
+{
+	unsigned long i, k, ulLive = 0, ulPeakLive = 0, ulSpan, ulPeakSpan = 0, ulFailed = 0;
+	uintptr_t uiLow, uiHigh;
+
+	for(i = 0; i < POOLS_STRESS_OPS; i++)
+	{
+		k = ulPoolsRand() % POOLS_SLOTS;
+		if(g_apvPoolsLive[k])
+		{
+			if(bPools)
+				vScdlPoolFree(ptPoolsClass(g_ausPoolsSize[k]), g_apvPoolsLive[k]);
+			else
+				free(g_apvPoolsLive[k]);
+			g_apvPoolsLive[k] = 0;
+			ulLive -= g_ausPoolsSize[k];
+		}
+		else if(ulLive < POOLS_BUDGET)
+		{
+			g_ausPoolsSize[k] = POOLS_MIN_SIZE + ulPoolsRand() % (POOLS_MAX_SIZE - POOLS_MIN_SIZE + 1);
+			g_apvPoolsLive[k] = bPools ? pvScdlPoolAlloc(ptPoolsClass(g_ausPoolsSize[k])) : malloc(g_ausPoolsSize[k]);
+			if(!g_apvPoolsLive[k])
+			{
+				ulFailed++;
+				continue;
+			}
+			ulLive += g_ausPoolsSize[k];
+			if(ulLive > ulPeakLive)
+				ulPeakLive = ulLive;
+		}
+
+		if(bPools || (i & 1023))
+			continue;
+
+		uiLow = UINTPTR_MAX;
+		uiHigh = 0;
+		for(k = 0; k < POOLS_SLOTS; k++)
+		{
+			if(!g_apvPoolsLive[k])
+				continue;
+			if((uintptr_t)g_apvPoolsLive[k] < uiLow)
+				uiLow = (uintptr_t)g_apvPoolsLive[k];
+			if((uintptr_t)g_apvPoolsLive[k] + g_ausPoolsSize[k] > uiHigh)
+				uiHigh = (uintptr_t)g_apvPoolsLive[k] + g_ausPoolsSize[k];
+		}
+		ulSpan = (uiHigh > uiLow) ? (unsigned long)(uiHigh - uiLow) : 0;
+		if(ulSpan > ulPeakSpan)
+			ulPeakSpan = ulSpan;
+	}
+
+	for(k = 0; k < POOLS_SLOTS; k++)
+	{
+		if(!g_apvPoolsLive[k])
+			continue;
+		if(bPools)
+			vScdlPoolFree(ptPoolsClass(g_ausPoolsSize[k]), g_apvPoolsLive[k]);
+		else
+			free(g_apvPoolsLive[k]);
+		g_apvPoolsLive[k] = 0;
+	}
+
+	if(bPools)
+	{
+		printf("pools,%u,%lu,%u,%lu\n", (unsigned int)(sizeof(g_apvPoolsSmall) + sizeof(g_apvPoolsMid) + sizeof(g_apvPoolsBig)),
+				ulPeakLive, (unsigned int)(sizeof(g_apvPoolsSmall) + sizeof(g_apvPoolsMid) + sizeof(g_apvPoolsBig)), ulFailed);
+	}
+	else
+	{
+		printf("malloc,0,%lu,%lu,%lu\n", ulPeakLive, ulPeakSpan, ulFailed);
+	}
+}
+
+/* all blocks of a pool must be free and allocatable after the stress test */
+static unsigned long ulPoolsCheck(struct typScdlPool *ptPool, unsigned short usBlocks)
+{
+	unsigned long ulErrors = 0;
+	unsigned short i;
+
+	if(usScdlPoolGetUsed(ptPool))
+		ulErrors++;
+	for(i = 0; i < usBlocks; i++)
+	{
+		g_apvPoolsLive[i] = pvScdlPoolAlloc(ptPool);
+		if(!g_apvPoolsLive[i])
+			ulErrors++;
+	}
+	for(i = 0; i < usBlocks; i++)
+	{
+		if(g_apvPoolsLive[i])
+			vScdlPoolFree(ptPool, g_apvPoolsLive[i]);
+		g_apvPoolsLive[i] = 0;
+	}
+
+	return ulErrors;
+}
+
+int main(void)
+{
+	unsigned long ulErrors;
+
+	printf("name,ns\n");
+	printf("pool_free_alloc,%.1f\n", dPoolsTimePool());
+	printf("malloc_free_alloc,%.1f\n", dPoolsTimeMalloc(0));
+	printf("malloc_free_alloc_random,%.1f\n", dPoolsTimeMalloc(1));
+
+	vScdlPoolInit(&g_atPoolsClass[0], g_apvPoolsSmall, 16, POOLS_SMALL_BLOCKS);
+	vScdlPoolInit(&g_atPoolsClass[1], g_apvPoolsMid, 64, POOLS_MID_BLOCKS);
+	vScdlPoolInit(&g_atPoolsClass[2], g_apvPoolsBig, 256, POOLS_BIG_BLOCKS);
+
+	printf("allocator,storage_bytes,peak_live_bytes,peak_span_bytes,failed\n");
+	vPoolsStress(0);
+	vPoolsStress(1);
+
+	ulErrors = ulPoolsCheck(&g_tPoolsTimed, POOLS_BLOCKS);
+	ulErrors += ulPoolsCheck(&g_atPoolsClass[0], POOLS_SMALL_BLOCKS);
+	ulErrors += ulPoolsCheck(&g_atPoolsClass[1], POOLS_MID_BLOCKS);
+	ulErrors += ulPoolsCheck(&g_atPoolsClass[2], POOLS_BIG_BLOCKS);
+	if(ulErrors)
+	{
+		fprintf(stderr, "%lu blocks lost\n", ulErrors);
+		return 1;
+	}
+
+	return 0;
+}
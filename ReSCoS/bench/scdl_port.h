@@ -0,0 +1,41 @@
+/*
+ * scdl_port.h
+ *
+ *  Port of the benchmark. There are no interrupts, the idle sleep calls the
+ *  tick directly, so only the scheduler's own code is measured.
+ */
+
+/*! @file */
+
+#ifndef SCDL_PORT_H_
+#define SCDL_PORT_H_
+
+#include "inc/scdl_config.h"
+
+#define SCDL_PORT_DISABLE_INTERRUPTS()	{ }
+#define SCDL_PORT_ENABLE_INTERRUPTS()	{ }
+
+typedef unsigned int scdlIrqState_t;
+#define SCDL_PORT_ENTER_CRITICAL(s)		{ (s) = 0; }
+#define SCDL_PORT_EXIT_CRITICAL(s)		{ (void)(s); }
+#define SCDL_PORT_IRQ_WAS_ENABLED(s)	((s) == 0)
+#define SCDL_PORT_PEND_URGENT()			{ }
+#define SCDL_PORT_IDLE_SLEEP()			vBenchIdle()
+
+/** resolution of ulScdlPortCycles, nanoseconds */
+#define SCDL_PORT_CYCLES_PER_MS			(1000000UL)
+
+#ifdef SCDL_MEASURE_STACK
+/* the lowest SCDL_PORT_STACK_SIZE bytes of the host's main stack are watched */
+#ifndef SCDL_PORT_STACK_SIZE
+#define SCDL_PORT_STACK_SIZE			(0x10000UL)
+#endif
+extern void *__libc_stack_end;
+#define SCDL_PORT_STACK_TOP				((unsigned char *)__libc_stack_end)
+#define SCDL_PORT_STACK_LIMIT			(SCDL_PORT_STACK_TOP - SCDL_PORT_STACK_SIZE)
+#endif
+
+unsigned long ulScdlPortCycles(void);
+void vBenchIdle(void);
+
+#endif /* SCDL_PORT_H_ */
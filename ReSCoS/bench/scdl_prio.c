@@ -0,0 +1,181 @@
+/**************************************************************************************************
+  Filename:       scdl_prio.c
+  Author:         $Author: Menz $
+
+  Description:    Host test of SCDL_AUTO_PRIO. Six tasks with different periods, one of them with
+                  a deadline shorter than its period, are created in all 720 orders and run in
+                  virtual time, every tick of run time is one vScdlTick. Halfway two periods and
+                  the deadline change. Every start must be the ready task with the shortest
+                  deadline and the schedule, the list of starts and their ticks, must be the same
+                  for every creation order. The exit code is 1 otherwise. See README.md for the
+                  build.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_prio.c */
+
+
+#include <stdio.h>
+#include <string.h>
+
+#include "inc/scheduler.h"
+#include "scdl_port.h"
+#include "scdl_sim.h"
+
+#ifndef SCDL_AUTO_PRIO
+#error scdl_prio needs -DSCDL_AUTO_PRIO
+#endif
+
+#define PRIO_TASKS			(6)
+/** ticks per run and tick of the period change */
+#define PRIO_TICKS			(6000UL)
+#define PRIO_SWITCH			(3000UL)
+/** starts recorded per run */
+#define PRIO_MAX_STARTS		(4096)
+
+/*!
+ * one start of the schedule
+ */
+struct typPrioStart
+{
+	unsigned long ulTick;
+	unsigned char ucTask;
+};
+
+static const unsigned long g_aulPrioPeriod[PRIO_TASKS] = { 7, 13, 20, 31, 50, 97 };
+static const unsigned long g_aulPrioRun[PRIO_TASKS] = { 1, 2, 3, 4, 6, 9 };
+/* explicit deadline of the last task, deadline monotonic before rate monotonic */
+#define PRIO_DEADLINE_TASK	(5)
+#define PRIO_DEADLINE		(10)
+
+static taskID_t g_atidPrio[PRIO_TASKS];
+/* deadline of each task, the period without an explicit one */
+static unsigned long g_aulPrioDeadline[PRIO_TASKS];
+static unsigned long g_ulPrioNow;
+static unsigned char g_bPrioSwitched;
+static struct typPrioStart g_atPrioStarts[PRIO_MAX_STARTS];
+static struct typPrioStart g_atPrioRef[PRIO_MAX_STARTS];
+static unsigned int g_uiPrioStarts;
+static unsigned long g_ulPrioWrongStarts;
+
+/* virtual time, no cycles */
+unsigned long ulScdlPortCycles(void)
+{
+	return 0;
+}
+
+static void vPrioTick(void)
+{
+	vScdlTick();
+	g_ulPrioNow++;
+}
+
+/* the periods of tasks 0 and 3 and the deadline of task 5 change the order */
+static void vPrioSwitch(void)
+{
+	vTaskSetPeriod(g_atidPrio[0], 120);
+	g_aulPrioDeadline[0] = 120;
+	vTaskSetPeriod(g_atidPrio[3], 11);
+	g_aulPrioDeadline[3] = 11;
+	vTaskSetDeadline(g_atidPrio[PRIO_DEADLINE_TASK], 0);
+	g_aulPrioDeadline[PRIO_DEADLINE_TASK] = g_aulPrioPeriod[PRIO_DEADLINE_TASK];
+	g_bPrioSwitched = 1;
+}
+
+/* records the start, no ready task may have a shorter deadline */
+static void vPrioJob(unsigned char ucTask)
+{
+	unsigned char i;
+
+	if(!g_bPrioSwitched && g_ulPrioNow >= PRIO_SWITCH)
+		vPrioSwitch();
+
+	for(i = 0; i < PRIO_TASKS; i++)
+	{
+		if(g_tScdlDefault.atTask[g_atidPrio[i]].eTaskState == READY && g_aulPrioDeadline[i] < g_aulPrioDeadline[ucTask])
+			g_ulPrioWrongStarts++;
+	}
+
+	if(g_uiPrioStarts < PRIO_MAX_STARTS)
+	{
+		g_atPrioStarts[g_uiPrioStarts].ulTick = g_ulPrioNow;
+		g_atPrioStarts[g_uiPrioStarts].ucTask = ucTask;
+	}
+	g_uiPrioStarts++;
+
+	vSimRun(g_aulPrioRun[ucTask] * SIM_TICK_NS);
+}
+
+#define PRIO_TASK(i)	static void vPrioTask##i(void) { vPrioJob(i); }
+PRIO_TASK(0) PRIO_TASK(1) PRIO_TASK(2) PRIO_TASK(3) PRIO_TASK(4) PRIO_TASK(5)
+static void (* const g_apfnPrioTasks[PRIO_TASKS])(void) =
+{
+	vPrioTask0, vPrioTask1, vPrioTask2, vPrioTask3, vPrioTask4, vPrioTask5
+};
+
+/* one run with the tasks created in the order of aucOrder */
+static void vPrioRun(const unsigned char *aucOrder)
+{
+	unsigned char i, ucTask;
+
+	vSimReset(SIM_TICKS_NS(PRIO_TICKS), vPrioTick);
+	for(i = 0; i < PRIO_TASKS; i++)
+	{
+		ucTask = aucOrder[i];
+		g_atidPrio[ucTask] = tidCreateTask(g_apfnPrioTasks[ucTask], g_aulPrioPeriod[ucTask]);
+		g_aulPrioDeadline[ucTask] = g_aulPrioPeriod[ucTask];
+	}
+	vTaskSetDeadline(g_atidPrio[PRIO_DEADLINE_TASK], PRIO_DEADLINE);
+	g_aulPrioDeadline[PRIO_DEADLINE_TASK] = PRIO_DEADLINE;
+
+	g_ulPrioNow = 0;
+	g_bPrioSwitched = 0;
+	g_uiPrioStarts = 0;
+	vSimStart();
+}
+
+int main(void)
+{
+	unsigned char aucOrder[PRIO_TASKS], aucLeft[PRIO_TASKS];
+	unsigned int uiPerm, uiCode, uiRefStarts = 0, uiOrders = 0, uiDiffer = 0;
+	unsigned char i, j, ucLeft;
+
+	for(uiPerm = 0; uiPerm < 720; uiPerm++)
+	{
+		/* the creation order of number uiPerm, 0 is the order of the periods */
+		for(i = 0; i < PRIO_TASKS; i++)
+			aucLeft[i] = i;
+		ucLeft = PRIO_TASKS;
+		uiCode = uiPerm;
+		for(i = 0; i < PRIO_TASKS; i++)
+		{
+			j = uiCode % ucLeft;
+			uiCode /= ucLeft;
+			aucOrder[i] = aucLeft[j];
+			memmove(&aucLeft[j], &aucLeft[j + 1], ucLeft - j - 1);
+			ucLeft--;
+		}
+
+		vPrioRun(aucOrder);
+		if(g_uiPrioStarts > PRIO_MAX_STARTS)
+		{
+			fprintf(stderr, "more than %u starts\n", PRIO_MAX_STARTS);
+			return 1;
+		}
+
+		if(!uiPerm)
+		{
+			uiRefStarts = g_uiPrioStarts;
+			memcpy(g_atPrioRef, g_atPrioStarts, sizeof(g_atPrioStarts));
+		}
+		else if(g_uiPrioStarts != uiRefStarts || memcmp(g_atPrioRef, g_atPrioStarts, uiRefStarts * sizeof(g_atPrioStarts[0])))
+			uiDiffer++;
+		uiOrders++;
+	}
+
+	printf("orders,starts,wrong_starts,different_schedules\n");
+	printf("%u,%u,%lu,%u\n", uiOrders, uiRefStarts, g_ulPrioWrongStarts, uiDiffer);
+
+	return (g_ulPrioWrongStarts || uiDiffer) ? 1 : 0;
+}
@@ -0,0 +1,146 @@
+/**************************************************************************************************
+  Filename:       scdl_sim.c
+  Author:         $Author: Menz $
+
+  Description:    Virtual time runner shared by the host tests. vSimReset empties the default
+                  instance and starts the time at 0, vSimStart runs the scheduler until the end
+                  time or vSimStop. The test may take over the tick, e.g. to record releases
+                  around vScdlTick, and may add events between the ticks, e.g. pin changes of a
+                  mock port, which wake the idle sleep. The idle sleep of the benchmark port is
+                  defined here.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_sim.c */
+
+
+#include <setjmp.h>
+
+#include "inc/scheduler.h"
+#include "scdl_port.h"
+#include "scdl_sim.h"
+
+unsigned long long g_ullSimNs;
+static unsigned long long g_ullSimNextTickNs;
+static unsigned long long g_ullSimEndNs;
+static jmp_buf g_tSimExit;
+
+/* tick of the test, 0 for vScdlTick alone */
+static void (*g_pfnSimTick)(void);
+/* events of the test up to ullTo, 0 for none */
+static unsigned char (*g_pfnSimAdvance)(unsigned long long ullTo, unsigned char bWake);
+
+/*! **********************************************************************************
+ * @fn		vSimReset
+ *
+ * @brief	Empty default instance at time 0, the events of vSimSetAdvance are cleared
+ *
+ * @param	ullEndNs end of the run, SIM_TICKS_NS for a number of ticks
+ *
+ * 			pfnTick tick of the test, it has to call vScdlTick, 0 for vScdlTick alone
+ *
+ */
+void vSimReset(unsigned long long ullEndNs, void (*pfnTick)(void))
+{
+#ifndef SCDL_STATIC_TASKS
+	vResetScheduler();
+#endif
+	g_ullSimNs = 0;
+	g_ullSimNextTickNs = SIM_TICK_NS;
+	g_ullSimEndNs = ullEndNs;
+	g_pfnSimTick = pfnTick;
+	g_pfnSimAdvance = 0;
+}
+
+/*! **********************************************************************************
+ * @fn		vSimSetAdvance
+ *
+ * @brief	Events between the ticks, for interrupts of a mock device
+ *
+ * @param	pfnAdvance handles the events up to ullTo in order and sets g_ullSimNs to the
+ * 			time of each, at last to ullTo. With bWake it stops after an event that made
+ * 			a task ready and returns 1, the idle sleep then returns before the tick.
+ *
+ */
+void vSimSetAdvance(unsigned char (*pfnAdvance)(unsigned long long ullTo, unsigned char bWake))
+{
+	g_pfnSimAdvance = pfnAdvance;
+}
+
+/* events up to ullTo, returns 1 if bWake and one of them woke the idle sleep */
+static unsigned char bSimAdvance(unsigned long long ullTo, unsigned char bWake)
+{
+	if(g_pfnSimAdvance)
+		return g_pfnSimAdvance(ullTo, bWake);
+
+	g_ullSimNs = ullTo;
+	return 0;
+}
+
+/*! **********************************************************************************
+ * @fn		vSimStart
+ *
+ * @brief	Run the scheduler until the end of the run
+ *
+ */
+void vSimStart(void)
+{
+	if(!setjmp(g_tSimExit))
+		vStartScheduler();
+}
+
+/*! **********************************************************************************
+ * @fn		vSimStop
+ *
+ * @brief	End the run now, vSimStart returns
+ *
+ */
+void vSimStop(void)
+{
+	longjmp(g_tSimExit, 1);
+}
+
+/*! **********************************************************************************
+ * @fn		vSimTick
+ *
+ * @brief	Tick interrupt at the next tick boundary, ends the run at its end time
+ *
+ */
+void vSimTick(void)
+{
+	bSimAdvance(g_ullSimNextTickNs, 0);
+	g_ullSimNextTickNs += SIM_TICK_NS;
+
+	if(g_ullSimNs >= g_ullSimEndNs)
+		vSimStop();
+
+	if(g_pfnSimTick)
+		g_pfnSimTick();
+	else
+		vScdlTick();
+}
+
+/*! **********************************************************************************
+ * @fn		vSimRun
+ *
+ * @brief	The caller runs for ullNs, ticks and events hit it meanwhile
+ *
+ * @param	ullNs run time
+ *
+ */
+void vSimRun(unsigned long long ullNs)
+{
+	unsigned long long ullEnd = g_ullSimNs + ullNs;
+
+	while(ullEnd >= g_ullSimNextTickNs)
+		vSimTick();
+	bSimAdvance(ullEnd, 0);
+}
+
+/* idle sleep until the next tick or event */
+void vBenchIdle(void)
+{
+	if(!bSimAdvance(g_ullSimNextTickNs, 1))
+		vSimTick();
+}
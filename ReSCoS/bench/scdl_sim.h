@@ -0,0 +1,31 @@
+/*
+ * scdl_sim.h
+ *
+ *  Virtual time of the host tests, see scdl_sim.c. A run starts with an empty
+ *  default instance at time 0, ticks come every SCDL_TICK_US, tasks take time
+ *  with vSimRun and the idle sleep waits for the next tick. The run ends at
+ *  the first tick at or after its end time, or with vSimStop.
+ */
+
+/*! @file */
+
+#ifndef SCDL_SIM_H_
+#define SCDL_SIM_H_
+
+#include "inc/scheduler.h"
+
+#define SIM_TICK_NS			((unsigned long long)SCDL_TICK_US * 1000)
+/** end time of a run of n ticks */
+#define SIM_TICKS_NS(n)		(((unsigned long long)(n) + 1) * SIM_TICK_NS)
+
+/** virtual time, ns */
+extern unsigned long long g_ullSimNs;
+
+void vSimReset(unsigned long long ullEndNs, void (*pfnTick)(void));
+void vSimSetAdvance(unsigned char (*pfnAdvance)(unsigned long long ullTo, unsigned char bWake));
+void vSimStart(void);
+void vSimStop(void);
+void vSimTick(void);
+void vSimRun(unsigned long long ullNs);
+
+#endif /* SCDL_SIM_H_ */
@@ -0,0 +1,203 @@
+/**************************************************************************************************
+  Filename:       scdl_staged.c
+  Author:         $Author: Menz $
+
+  Description:    Host test of the staged boot, built with SCDL_BOOT_STAGES. Runs in virtual
+                  time, ticks interrupt the stages. A control task of period 1 ms is created in
+                  main, four stages of 5, 2, 8 and 3 ms are deferred, the third one creates a
+                  task. The stages must run in order with the control task between each two, the
+                  created task must run, the done callback must be called once, and the first
+                  task must start at vStartScheduler, not at the first tick. For comparison the
+                  same stages run serially in main. Results are written as csv lines "variant,
+                  first_task_us,initialized_us,control_max_gap_us". The exit code is 1 on a
+                  failed check. See README.md for the build.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_staged.c */
+
+
+#include <stdio.h>
+#include <string.h>
+
+#include "inc/scheduler.h"
+#include "inc/scdl_boot.h"
+#include "scdl_port.h"
+#include "scdl_sim.h"
+
+#ifndef SCDL_BOOT_STAGES
+#error scdl_staged needs -DSCDL_BOOT_STAGES
+#endif
+
+/** simulated time per variant */
+#define STAGED_SIM_NS		(100ULL * 1000000ULL)
+/** the part of main the first tasks need, clock and tick */
+#define STAGED_MAIN_NS		(200000UL)
+#define STAGED_NUM_STAGES	(4)
+#define STAGED_LOG_SIZE		(64)
+
+static const unsigned long g_aulStagedNs[STAGED_NUM_STAGES] = { 5000000, 2000000, 8000000, 3000000 };
+
+/* stages '0'.., control 'c' once per gap, created task 'n' */
+static char g_acStagedLog[STAGED_LOG_SIZE];
+static unsigned char g_ucStagedLog;
+static unsigned long long g_ullStagedLastCtl;
+static unsigned long long g_ullStagedMaxGap;
+static unsigned long g_ulStagedCtlRuns;
+static unsigned char g_ucStagedDoneCalls;
+
+/* virtual time, ns */
+unsigned long ulScdlPortCycles(void)
+{
+	return (unsigned long)g_ullSimNs;
+}
+
+static void vStagedLog(char cEvent)
+{
+	if(g_ucStagedLog < STAGED_LOG_SIZE - 1)
+		g_acStagedLog[g_ucStagedLog++] = cEvent;
+}
+
+static void vTaskStagedControl(void)
+{
+	if(g_ulStagedCtlRuns++ && g_ullSimNs - g_ullStagedLastCtl > g_ullStagedMaxGap)
+		g_ullStagedMaxGap = g_ullSimNs - g_ullStagedLastCtl;
+	g_ullStagedLastCtl = g_ullSimNs;
+
+	if(!g_ucStagedLog || g_acStagedLog[g_ucStagedLog - 1] != 'c')
+		vStagedLog('c');
+	vSimRun(50000);
+}
+
+static void vTaskStagedCreated(void)
+{
+	vStagedLog('n');
+}
+
+static void vStaged(unsigned char ucStage)
+{
+	vStagedLog((char)('0' + ucStage));
+	vSimRun(g_aulStagedNs[ucStage]);
+}
+
+static void vStaged0(void)
+{
+	vStaged(0);
+}
+
+static void vStaged1(void)
+{
+	vStaged(1);
+}
+
+/* a stage bringing up a driver task */
+static void vStaged2(void)
+{
+	vStaged(2);
+	tidCreateTask(vTaskStagedCreated, SCDL_INF_PERIOD);
+}
+
+static void vStaged3(void)
+{
+	vStaged(3);
+}
+
+static void vStagedDone(const struct typScdlBootTimes *ptTimes)
+{
+	(void)ptTimes;
+	g_ucStagedDoneCalls++;
+}
+
+/* empty default instance, virtual time and log */
+static void vStagedReset(void)
+{
+	vSimReset(STAGED_SIM_NS, 0);
+	memset(g_acStagedLog, 0, sizeof(g_acStagedLog));
+	g_ucStagedLog = 0;
+	g_ullStagedMaxGap = 0;
+	g_ulStagedCtlRuns = 0;
+	g_ucStagedDoneCalls = 0;
+}
+
+/* one boot, the stages deferred or run in main, returns the failed checks */
+static unsigned long ulStagedRun(unsigned char bStaged, struct typScdlBootTimes *ptTimes)
+{
+	static void (* const apfnStages[STAGED_NUM_STAGES])(void) = { vStaged0, vStaged1, vStaged2, vStaged3 };
+	unsigned char i;
+
+	vStagedReset();
+	vScdlBootInit();
+	vSimRun(STAGED_MAIN_NS);
+	tidCreateTask(vTaskStagedControl, SCDL_MS_TO_TICKS(1));
+
+	for(i = 0; i < STAGED_NUM_STAGES; i++)
+	{
+		if(bStaged)
+			vScdlBootDefer(apfnStages[i]);
+		else
+			apfnStages[i]();
+	}
+	vScdlBootStart(tidCreateTask(vTaskScdlBoot, SCDL_INF_PERIOD), vStagedDone);
+
+	vSimStart();
+
+	vScdlBootGetTimes(ptTimes);
+	printf("%s,%lu,%lu,%lu\n", bStaged ? "staged" : "serial", SCDL_BOOT_CYCLES_TO_US(ptTimes->ulFirstTask),
+			SCDL_BOOT_CYCLES_TO_US(ptTimes->ulInitialized), (unsigned long)(g_ullStagedMaxGap / 1000));
+
+	return g_ucStagedDoneCalls != 1;
+}
+
+/* the order of the staged boot and its times */
+static unsigned long ulStagedCheck(const struct typScdlBootTimes *ptTimes)
+{
+	char acOrder[STAGED_LOG_SIZE];
+	unsigned long ulErrors = 0;
+	unsigned char i, n = 0;
+
+	/* the control task first and between each two stages */
+	for(i = 0; i < g_ucStagedLog; i++)
+	{
+		if(g_acStagedLog[i] != 'n')
+			acOrder[n++] = g_acStagedLog[i];
+	}
+	acOrder[n] = 0;
+	if(strncmp(acOrder, "c0c1c2c3c", 9))
+		ulErrors++;
+	if(!strchr(g_acStagedLog, 'n'))
+		ulErrors++;
+
+	if(ptTimes->ucStages != STAGED_NUM_STAGES || ptTimes->ucDone != STAGED_NUM_STAGES)
+		ulErrors++;
+	for(i = 0; i < STAGED_NUM_STAGES; i++)
+	{
+		if(ptTimes->aulStage[i] != g_aulStagedNs[i])
+			ulErrors++;
+	}
+
+	/* no wait for the first tick */
+	if(ptTimes->ulFirstTask != ptTimes->ulStart)
+		ulErrors++;
+
+	return ulErrors;
+}
+
+int main(void)
+{
+	struct typScdlBootTimes tTimes;
+	unsigned long ulErrors;
+
+	printf("variant,first_task_us,initialized_us,control_max_gap_us\n");
+	ulErrors = ulStagedRun(0, &tTimes);
+	ulErrors += ulStagedRun(1, &tTimes);
+	ulErrors += ulStagedCheck(&tTimes);
+
+	if(ulErrors)
+	{
+		fprintf(stderr, "%lu failed boot checks, log %s\n", ulErrors, g_acStagedLog);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,108 @@
+/**************************************************************************************************
+  Filename:       scdl_startup.c
+  Author:         $Author: Menz $
+
+  Description:    Host benchmark of the startup with the task set of the LaunchPad example,
+                  built once as is and once with SCDL_STATIC_TASKS. The time runs from main to
+                  the start of the first task: the three tidCreateTask calls and vStartScheduler,
+                  or with the static table the copy of the initialized task list, which the C
+                  start-up does on the target, and vStartScheduler. Every result is the fastest
+                  of STARTUP_REPEAT batches timed with one pair of clock reads. Results are written
+                  as csv lines "variant,tasks,task_list_bytes,startup_ns". See README.md for the
+                  build.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_startup.c */
+
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "inc/scheduler.h"
+#include "scdl_port.h"
+#include "scdl_sim.h"
+
+/** startups per batch and batches */
+#define STARTUP_LOOPS		(100000UL)
+#define STARTUP_REPEAT		(51)
+
+#ifdef SCDL_STATIC_TASKS
+/* the task list as the C start-up leaves it */
+static struct typScheduler g_tStartupImage;
+#endif
+
+unsigned long ulScdlPortCycles(void)
+{
+	struct timespec tNow;
+
+	clock_gettime(CLOCK_MONOTONIC, &tNow);
+	return (unsigned long)tNow.tv_sec * 1000000000UL + (unsigned long)tNow.tv_nsec;
+}
+
+/* the first task ends the startup */
+void vTaskStartup1(void)
+{
+	vSimStop();
+}
+
+void vTaskStartup2(void)
+{
+}
+
+void vTaskStartup3(void)
+{
+}
+
+/* main up to the first task */
+static void vStartupOnce(void)
+{
+#ifdef SCDL_STATIC_TASKS
+	memcpy(&g_tScdlDefault, &g_tStartupImage, sizeof(g_tScdlDefault));
+#else
+	vResetScheduler();
+	tidCreateTask(vTaskStartup1, SCDL_MS_TO_TICKS(1000));
+	tidCreateTask(vTaskStartup2, SCDL_MS_TO_TICKS(250));
+	tidCreateTask(vTaskStartup3, SCDL_MS_TO_TICKS(50));
+#endif
+
+	vSimStart();
+}
+
+int main(void)
+{
+	unsigned long l, ulStart;
+	double dNs, dMin = 1e30;
+	unsigned char r;
+
+#ifdef SCDL_STATIC_TASKS
+	g_tStartupImage = g_tScdlDefault;
+#endif
+	/* the first task ends each run before the first tick */
+	vSimReset(SIM_TICKS_NS(1), 0);
+
+	for(r = 0; r < STARTUP_REPEAT; r++)
+	{
+		ulStart = ulScdlPortCycles();
+		for(l = 0; l < STARTUP_LOOPS; l++)
+			vStartupOnce();
+		dNs = (double)(ulScdlPortCycles() - ulStart) / STARTUP_LOOPS;
+		if(dNs < dMin)
+			dMin = dNs;
+	}
+
+	printf("variant,tasks,task_list_bytes,startup_ns\n");
+#ifdef SCDL_STATIC_TASKS
+#ifdef SCDL_CONST_PERIODS
+	printf("static_const_periods,%u,%u,%.1f\n", SCDL_NUM_STATIC_TASKS, (unsigned int)sizeof(g_tScdlDefault), dMin);
+#else
+	printf("static,%u,%u,%.1f\n", SCDL_NUM_STATIC_TASKS, (unsigned int)sizeof(g_tScdlDefault), dMin);
+#endif
+#else
+	printf("dynamic,%u,%u,%.1f\n", g_tScdlDefault.ucNumTasks, (unsigned int)sizeof(g_tScdlDefault), dMin);
+#endif
+
+	return 0;
+}
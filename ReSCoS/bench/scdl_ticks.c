@@ -0,0 +1,196 @@
+/**************************************************************************************************
+  Filename:       scdl_ticks.c
+  Author:         $Author: Menz $
+
+  Description:    Host test of the task periods at the tick rate of the build, SCDL_TICK_US. Tasks
+                  with periods and delays given in us run in virtual time from tick 0 and across
+                  0x7FFFFFFF, 0xFFFFFFFF and the wrap of the tick counter. Periods shorter than a
+                  tick cannot be represented and are left out. Every start must follow the
+                  last one by the same number of ticks, and that time must differ from the period
+                  asked for by at most half a tick. Results are written as csv lines "tick_us,
+                  start,period_us,ticks,actual_us,error_pct,runs". The exit code is 1 on a wrong
+                  start, count or period. See README.md for the build.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_ticks.c */
+
+
+#include <stdio.h>
+
+#include "inc/scheduler.h"
+#include "scdl_port.h"
+#include "scdl_sim.h"
+
+/** periods of the periodic tasks in us, 0 ends the list */
+#define TICKS_PERIODS_US	{ 100, 250, 300, 1000, 1600, 2500, 10000, 1000000, 60000000, 0 }
+/** the task re-invoking itself with vTaskInvokeDelayedUs */
+#define TICKS_DELAY_US		(7000)
+/** periods of the longest task per run */
+#define TICKS_RUN_PERIODS	(3)
+
+/*!
+ * record of one test task
+ */
+struct typTicksTask
+{
+	/** period or delay in us and ticks */
+	unsigned long ulUs;
+	unsigned long ulTicks;
+	/** last start, starts and wrong starts */
+	scdlTicks_t ulLast;
+	unsigned long ulRuns;
+	unsigned long ulErrors;
+};
+
+static const unsigned long g_aulTicksPeriods[] = TICKS_PERIODS_US;
+
+static struct typTicksTask g_atTicksTasks[SCDL_MAX_NUM_TASKS];
+static unsigned char g_ucTicksTasks;
+static taskID_t g_tidTicksDelay;
+
+/* no time is measured here */
+unsigned long ulScdlPortCycles(void)
+{
+	return 0;
+}
+
+/* the time since the last start must be the period asked for within half a tick */
+static void vTicksRecord(taskID_t tid)
+{
+	struct typTicksTask *ptTask = &g_atTicksTasks[tid];
+	scdlTicks_t ulNow = ulScdlGetTicks();
+	unsigned long ulUs;
+
+	if(ptTask->ulRuns)
+	{
+		ulUs = SCDL_TICKS_TO_US(ulNow - ptTask->ulLast);
+		if(ulNow - ptTask->ulLast != ptTask->ulTicks)
+			ptTask->ulErrors++;
+		if((ulUs > ptTask->ulUs ? ulUs - ptTask->ulUs : ptTask->ulUs - ulUs) > SCDL_TICK_US / 2)
+			ptTask->ulErrors++;
+	}
+	ptTask->ulLast = ulNow;
+	ptTask->ulRuns++;
+}
+
+static void vTaskTicksPeriodic(void)
+{
+	vTicksRecord(g_tScdlDefault.tidActiveTask);
+}
+
+static void vTaskTicksDelayed(void)
+{
+	vTicksRecord(g_tidTicksDelay);
+	vTaskInvokeDelayedUs(g_tidTicksDelay, TICKS_DELAY_US);
+}
+
+/* empty default instance for ulTicks ticks, its counter starts at ulStart */
+static void vTicksReset(scdlTicks_t ulStart, unsigned long ulTicks)
+{
+	vSimReset(SIM_TICKS_NS(ulTicks), 0);
+	g_tScdlDefault.ulSystemTicks = ulStart;
+}
+
+static void vTicksAdd(unsigned long ulUs, unsigned long ulTicks)
+{
+	struct typTicksTask *ptTask = &g_atTicksTasks[g_ucTicksTasks++];
+
+	ptTask->ulUs = ulUs;
+	ptTask->ulTicks = ulTicks;
+	ptTask->ulRuns = 0;
+	ptTask->ulErrors = 0;
+}
+
+/* one run of ulTicks ticks from ulStart, returns the wrong starts and counts */
+static unsigned long ulTicksRun(scdlTicks_t ulStart, unsigned long ulTicks)
+{
+	struct typTicksTask *ptTask;
+	unsigned long ulErrors, ulFirst;
+	unsigned char i;
+
+	vTicksReset(ulStart, ulTicks);
+	g_ucTicksTasks = 0;
+	for(i = 0; g_aulTicksPeriods[i]; i++)
+	{
+		/* too short for the tick rate, creating the task would fail its assert */
+		if(!SCDL_PERIOD_US(g_aulTicksPeriods[i]))
+			continue;
+		tidCreateTaskUs(vTaskTicksPeriodic, g_aulTicksPeriods[i]);
+		vTicksAdd(g_aulTicksPeriods[i], SCDL_PERIOD_US(g_aulTicksPeriods[i]));
+	}
+	if(TICKS_DELAY_US >= SCDL_TICK_US)
+	{
+		g_tidTicksDelay = tidCreateTask(vTaskTicksDelayed, SCDL_INF_PERIOD);
+		vTicksAdd(TICKS_DELAY_US, SCDL_US_TO_TICKS(TICKS_DELAY_US));
+	}
+
+	vSimStart();
+
+	/* all tasks start with the first tick, then once per period */
+#ifdef SCDL_BOOT_STAGES
+	ulFirst = 0;
+#else
+	ulFirst = 1;
+#endif
+	ulErrors = 0;
+	for(i = 0; i < g_ucTicksTasks; i++)
+	{
+		ptTask = &g_atTicksTasks[i];
+		if(ptTask->ulRuns != (ulTicks - ulFirst) / ptTask->ulTicks + 1)
+			ptTask->ulErrors++;
+		ulErrors += ptTask->ulErrors;
+
+		printf("%lu,0x%lx,%lu,%lu,%lu,%.3f,%lu\n", (unsigned long)SCDL_TICK_US, (unsigned long)ulStart,
+				ptTask->ulUs, ptTask->ulTicks, SCDL_TICKS_TO_US(ptTask->ulTicks),
+				100.0 * ((double)SCDL_TICKS_TO_US(ptTask->ulTicks) - ptTask->ulUs) / ptTask->ulUs, ptTask->ulRuns);
+	}
+
+	return ulErrors;
+}
+
+/* SCDL_MS_TO_TICKS must agree with SCDL_US_TO_TICKS on every tick rate */
+static unsigned long ulTicksConversions(void)
+{
+	unsigned long ulMs, ulErrors = 0;
+
+	for(ulMs = 0; ulMs < 100000; ulMs++)
+	{
+		if(SCDL_MS_TO_TICKS(ulMs) != SCDL_US_TO_TICKS(ulMs * 1000))
+			ulErrors++;
+	}
+
+	return ulErrors;
+}
+
+int main(void)
+{
+	unsigned long ulTicks, ulErrors;
+	unsigned char i;
+
+	/* a few periods of the longest task */
+	ulTicks = 0;
+	for(i = 0; g_aulTicksPeriods[i]; i++)
+	{
+		if(SCDL_PERIOD_US(g_aulTicksPeriods[i]) > ulTicks)
+			ulTicks = SCDL_PERIOD_US(g_aulTicksPeriods[i]);
+	}
+	ulTicks *= TICKS_RUN_PERIODS;
+
+	printf("tick_us,start,period_us,ticks,actual_us,error_pct,runs\n");
+	ulErrors = ulTicksConversions();
+	ulErrors += ulTicksRun(0, ulTicks);
+	/* across the wrap of the counter before the free running one, of a 32 bit counter and of this one */
+	ulErrors += ulTicksRun(SCDL_MAX_TASK_PERIOD - ulTicks / 2, ulTicks);
+	ulErrors += ulTicksRun(0xFFFFFFFFUL - ulTicks / 2, ulTicks);
+	ulErrors += ulTicksRun((scdlTicks_t)0 - ulTicks / 2, ulTicks);
+
+	if(ulErrors)
+	{
+		fprintf(stderr, "%lu wrong task starts, counts or conversions\n", ulErrors);
+		return 1;
+	}
+
+	return 0;
+}
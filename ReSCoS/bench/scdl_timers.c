@@ -0,0 +1,164 @@
+/**************************************************************************************************
+  Filename:       scdl_timers.c
+  Author:         $Author: Menz $
+
+  Description:    Host benchmark of the callback timers of scdl_timer.h, built with SCDL_TIMERS.
+                  Thousands of timers run for TIMERS_TICKS ticks, half of them periodic and half
+                  one-shot timers restarting themselves from their callback with a random delay.
+                  Every expiry is checked against the tick it was due. The time of vScdlTick and
+                  of the timer service is measured per tick, with the memory of a timer next to the
+                  one of a task slot. Results are written as csv lines "wheel_bits,timers,
+                  timer_bytes,task_bytes,expiries,late,start_stop_ns,tick_ns,service_ns,
+                  expiry_ns". See README.md for the build.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_timers.c */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "inc/scheduler.h"
+#include "inc/scdl_timer.h"
+#include "scdl_port.h"
+#include "scdl_sim.h"
+
+#ifndef SCDL_TIMERS
+#error scdl_timers needs -DSCDL_TIMERS
+#endif
+
+/** ticks per run */
+#define TIMERS_TICKS		(100000UL)
+/** longest delay of a one-shot timer and longest period in ticks */
+#define TIMERS_MAX_DELAY	(5000)
+#define TIMERS_MAX_PERIOD	(1000)
+/** most timers of a run */
+#define TIMERS_MAX			(100000UL)
+
+static struct typScdlTimer g_atTimers[TIMERS_MAX];
+/* tick each timer is due next */
+static scdlTicks_t g_aulTimersDue[TIMERS_MAX];
+static unsigned long g_ulTimersExpiries;
+static unsigned long g_ulTimersLate;
+static unsigned long g_ulTimersTickNs;
+static unsigned long g_ulTimersServiceNs;
+
+unsigned long ulScdlPortCycles(void)
+{
+	struct timespec tNow;
+
+	clock_gettime(CLOCK_MONOTONIC, &tNow);
+	return (unsigned long)tNow.tv_sec * 1000000000UL + (unsigned long)tNow.tv_nsec;
+}
+
+/* tick interrupt, timed */
+static void vTimersTick(void)
+{
+	unsigned long ulStart = ulScdlPortCycles();
+
+	vScdlTick();
+	g_ulTimersTickNs += ulScdlPortCycles() - ulStart;
+}
+
+static void vTimersCallback(void *pvArg)
+{
+	unsigned long i = (unsigned long)pvArg, ulDelay;
+
+	g_ulTimersExpiries++;
+	if(ulScdlGetTicks() != g_aulTimersDue[i])
+		g_ulTimersLate++;
+
+	if(g_atTimers[i].ulPeriod)
+	{
+		g_aulTimersDue[i] += g_atTimers[i].ulPeriod;
+	}
+	else
+	{
+		ulDelay = 1 + rand() % TIMERS_MAX_DELAY;
+		g_aulTimersDue[i] = ulScdlGetTicks() + ulDelay;
+		vScdlTimerStart(&g_atTimers[i], ulDelay, 0, vTimersCallback, pvArg);
+	}
+}
+
+static void vTaskTimers(void)
+{
+	unsigned long ulStart = ulScdlPortCycles();
+
+	vTaskScdlTimers();
+	g_ulTimersServiceNs += ulScdlPortCycles() - ulStart;
+}
+
+/* ns of one vScdlTimerStart and vScdlTimerStop of every timer, they are stopped afterwards */
+static double dTimersStartStop(unsigned long ulTimers)
+{
+	unsigned long i, ulStart = ulScdlPortCycles();
+
+	for(i = 0; i < ulTimers; i++)
+		vScdlTimerStart(&g_atTimers[i], 1 + i % TIMERS_MAX_DELAY, 0, vTimersCallback, (void *)i);
+	for(i = 0; i < ulTimers; i++)
+		vScdlTimerStop(&g_atTimers[i]);
+
+	return (double)(ulScdlPortCycles() - ulStart) / ulTimers;
+}
+
+static void vTimersRun(unsigned long ulTimers)
+{
+	unsigned long i, ulDelay, ulPeriod;
+	double dStartStop;
+	taskID_t tidService;
+
+	vSimReset(SIM_TICKS_NS(TIMERS_TICKS), vTimersTick);
+	tidService = tidCreateTask(vTaskTimers, SCDL_INF_PERIOD);
+	/* the wheel forgets all timers, they must be stopped */
+	memset(g_atTimers, 0, sizeof(g_atTimers));
+	vScdlTimerInit(tidService);
+
+	dStartStop = dTimersStartStop(ulTimers);
+
+	srand(1);
+	for(i = 0; i < ulTimers; i++)
+	{
+		ulDelay = 1 + rand() % TIMERS_MAX_DELAY;
+		ulPeriod = (i & 1) ? 1 + rand() % TIMERS_MAX_PERIOD : 0;
+		g_aulTimersDue[i] = ulDelay;
+		vScdlTimerStart(&g_atTimers[i], ulDelay, ulPeriod, vTimersCallback, (void *)i);
+	}
+
+	g_ulTimersExpiries = 0;
+	g_ulTimersLate = 0;
+	g_ulTimersTickNs = 0;
+	g_ulTimersServiceNs = 0;
+	vSimStart();
+
+	printf("%u,%lu,%u,%u,%lu,%lu,%.1f,%.1f,%.1f,%.1f\n", SCDL_TIMER_WHEEL_BITS, ulTimers,
+			(unsigned int)sizeof(struct typScdlTimer), (unsigned int)sizeof(struct typTask), g_ulTimersExpiries,
+			g_ulTimersLate, dStartStop, (double)g_ulTimersTickNs / TIMERS_TICKS,
+			(double)g_ulTimersServiceNs / TIMERS_TICKS,
+			g_ulTimersExpiries ? (double)g_ulTimersServiceNs / g_ulTimersExpiries : 0.0);
+}
+
+int main(int argc, char *argv[])
+{
+	static const unsigned long aulTimers[] = { 10, 100, 1000, 4000, 10000 };
+	unsigned long ulTimers, ulLate = 0;
+	int a;
+
+	printf("wheel_bits,timers,timer_bytes,task_bytes,expiries,late,start_stop_ns,tick_ns,service_ns,expiry_ns\n");
+	for(a = 1; a < argc || (argc == 1 && a <= (int)(sizeof(aulTimers) / sizeof(aulTimers[0]))); a++)
+	{
+		ulTimers = (argc > 1) ? strtoul(argv[a], 0, 10) : aulTimers[a - 1];
+		if(!ulTimers || ulTimers > TIMERS_MAX)
+		{
+			fprintf(stderr, "timers must be 1 to %lu\n", TIMERS_MAX);
+			return 2;
+		}
+		vTimersRun(ulTimers);
+		ulLate += g_ulTimersLate;
+	}
+
+	return ulLate ? 1 : 0;
+}
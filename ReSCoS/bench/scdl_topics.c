@@ -0,0 +1,199 @@
+/**************************************************************************************************
+  Filename:       scdl_topics.c
+  Author:         $Author: Menz $
+
+  Description:    Host benchmark of the zero-copy topics of scdl_topic.h against a handoff with
+                  one memcpy per consumer, built with SCDL_TOPICS. A producer hands samples of 16
+                  to 1024 bytes to 1 to 11 consumer tasks, which are set READY and read the first
+                  and last byte. The time per sample is the fastest of TOPICS_REPEAT runs. Then the
+                  statistics are checked: samples replaced before a get count as missed, a claim
+                  with every slot in use counts as no slot. Results are written as csv lines
+                  "size,subscribers,topic_ns,memcpy_ns". The exit code is 1 on wrong statistics.
+                  See README.md for the build.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_topics.c */
+
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "inc/scheduler.h"
+#include "inc/scdl_topic.h"
+#include "scdl_port.h"
+
+#ifndef SCDL_TOPICS
+#error scdl_topics needs -DSCDL_TOPICS
+#endif
+
+/** most consumers, the other task slot is left to the scheduler */
+#define TOPICS_MAX_SUBS		(SCDL_MAX_NUM_TASKS - 1)
+#define TOPICS_MAX_SIZE		(1024)
+/** samples per timed run and runs per result */
+#define TOPICS_SAMPLES		(200000UL)
+#define TOPICS_REPEAT		(5)
+
+/* with subscribers + 2 slots a claim never fails */
+#if (SCDL_TOPIC_MAX_SLOTS < TOPICS_MAX_SUBS + 2)
+#error scdl_topics needs SCDL_TOPIC_MAX_SLOTS of at least SCDL_MAX_NUM_TASKS + 1
+#endif
+
+SCDL_TOPIC_STORAGE(g_apvTopicsMem, TOPICS_MAX_SIZE, TOPICS_MAX_SUBS + 2);
+static struct typScdlTopic g_tTopic;
+static struct typScdlSubscriber g_atTopicsSubs[TOPICS_MAX_SUBS];
+static taskID_t g_atidTopics[TOPICS_MAX_SUBS];
+
+/* the memcpy handoff: the producer's sample, a copy and a flag per consumer */
+static unsigned char g_aucTopicsSrc[TOPICS_MAX_SIZE];
+static unsigned char g_aucTopicsCopies[TOPICS_MAX_SUBS][TOPICS_MAX_SIZE];
+static volatile unsigned char g_abTopicsNew[TOPICS_MAX_SUBS];
+volatile unsigned long g_ulTopicsSink;
+
+unsigned long ulScdlPortCycles(void)
+{
+	struct timespec tNow;
+
+	clock_gettime(CLOCK_MONOTONIC, &tNow);
+	return (unsigned long)tNow.tv_sec * 1000000000UL + (unsigned long)tNow.tv_nsec;
+}
+
+/* no scheduler run here */
+void vBenchIdle(void)
+{
+}
+
+static void vTaskTopicsConsumer(void)
+{
+}
+
+/* ns per sample through a topic with ucSubs subscribers */
+static double dTopicsTopic(unsigned short usSize, unsigned char ucSubs)
+{
+	unsigned long ulSample, ulStart;
+	const unsigned char *pucSample;
+	unsigned char *pucSlot;
+	unsigned char i;
+
+	vScdlTopicInit(&g_tTopic, g_apvTopicsMem, usSize, ucSubs + 2);
+	for(i = 0; i < ucSubs; i++)
+		vScdlTopicSubscribe(&g_tTopic, &g_atTopicsSubs[i], g_atidTopics[i]);
+
+	ulStart = ulScdlPortCycles();
+	for(ulSample = 0; ulSample < TOPICS_SAMPLES; ulSample++)
+	{
+		/* the producer fills the slot in place */
+		pucSlot = pvScdlTopicClaim(&g_tTopic);
+		pucSlot[0] = (unsigned char)ulSample;
+		pucSlot[usSize - 1] = (unsigned char)ulSample;
+		vScdlTopicPublish(&g_tTopic, pucSlot);
+
+		for(i = 0; i < ucSubs; i++)
+		{
+			pucSample = pvScdlTopicGet(&g_tTopic, &g_atTopicsSubs[i]);
+			g_ulTopicsSink += pucSample[0] + pucSample[usSize - 1];
+		}
+	}
+
+	return (double)(ulScdlPortCycles() - ulStart) / TOPICS_SAMPLES;
+}
+
+/* ns per sample copied to every consumer, which is flagged and set READY */
+static double dTopicsMemcpy(unsigned short usSize, unsigned char ucSubs)
+{
+	unsigned long ulSample, ulStart;
+	unsigned char i;
+
+	ulStart = ulScdlPortCycles();
+	for(ulSample = 0; ulSample < TOPICS_SAMPLES; ulSample++)
+	{
+		g_aucTopicsSrc[0] = (unsigned char)ulSample;
+		g_aucTopicsSrc[usSize - 1] = (unsigned char)ulSample;
+		for(i = 0; i < ucSubs; i++)
+		{
+			memcpy(g_aucTopicsCopies[i], g_aucTopicsSrc, usSize);
+			g_abTopicsNew[i] = 1;
+			vTaskSetState(g_atidTopics[i], READY);
+		}
+
+		for(i = 0; i < ucSubs; i++)
+		{
+			if(g_abTopicsNew[i])
+			{
+				g_abTopicsNew[i] = 0;
+				g_ulTopicsSink += g_aucTopicsCopies[i][0] + g_aucTopicsCopies[i][usSize - 1];
+			}
+		}
+	}
+
+	return (double)(ulScdlPortCycles() - ulStart) / TOPICS_SAMPLES;
+}
+
+/* missed samples and a claim without a free slot must be counted */
+static unsigned long ulTopicsCheckStats(void)
+{
+	unsigned long ulErrors = 0;
+	unsigned char i;
+
+	/* three publications without a get, the subscriber sees the last one */
+	vScdlTopicInit(&g_tTopic, g_apvTopicsMem, 16, 3);
+	vScdlTopicSubscribe(&g_tTopic, &g_atTopicsSubs[0], g_atidTopics[0]);
+	for(i = 0; i < 3; i++)
+		vScdlTopicPublish(&g_tTopic, pvScdlTopicClaim(&g_tTopic));
+	if(!pvScdlTopicGet(&g_tTopic, &g_atTopicsSubs[0]) || usScdlTopicGetMissed(&g_tTopic) != 2)
+		ulErrors++;
+
+	/* the held sample and two claims take all three slots */
+	if(!pvScdlTopicClaim(&g_tTopic) || !pvScdlTopicClaim(&g_tTopic))
+		ulErrors++;
+	if(pvScdlTopicClaim(&g_tTopic) || usScdlTopicGetNoSlot(&g_tTopic) != 1)
+		ulErrors++;
+
+	return ulErrors;
+}
+
+int main(void)
+{
+	static const unsigned short ausSizes[] = { 16, 256, TOPICS_MAX_SIZE };
+	static const unsigned char aucSubs[] = { 1, 4, TOPICS_MAX_SUBS };
+	double dTopic, dCopy, dMinTopic, dMinCopy;
+	unsigned long ulErrors = 0;
+	unsigned char i, s, r;
+
+	for(i = 0; i < TOPICS_MAX_SUBS; i++)
+		g_atidTopics[i] = tidCreateTask(vTaskTopicsConsumer, SCDL_INF_PERIOD);
+
+	printf("size,subscribers,topic_ns,memcpy_ns\n");
+	for(i = 0; i < sizeof(ausSizes) / sizeof(ausSizes[0]); i++)
+	{
+		for(s = 0; s < sizeof(aucSubs); s++)
+		{
+			dMinTopic = 1e9;
+			dMinCopy = 1e9;
+			for(r = 0; r < TOPICS_REPEAT; r++)
+			{
+				dTopic = dTopicsTopic(ausSizes[i], aucSubs[s]);
+				dCopy = dTopicsMemcpy(ausSizes[i], aucSubs[s]);
+				if(dTopic < dMinTopic)
+					dMinTopic = dTopic;
+				if(dCopy < dMinCopy)
+					dMinCopy = dCopy;
+			}
+			/* every subscriber got every sample from a free slot */
+			if(usScdlTopicGetMissed(&g_tTopic) || usScdlTopicGetNoSlot(&g_tTopic))
+				ulErrors++;
+			printf("%u,%u,%.1f,%.1f\n", ausSizes[i], aucSubs[s], dMinTopic, dMinCopy);
+		}
+	}
+
+	ulErrors += ulTopicsCheckStats();
+	if(ulErrors)
+	{
+		fprintf(stderr, "%lu wrong topic statistics\n", ulErrors);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,143 @@
+/**************************************************************************************************
+  Filename:       scdl_urgent.c
+  Author:         $Author: Menz $
+
+  Description:    Host simulation of the start latency of a 1 ms control task next to a long
+                  running task, built with SCDL_URGENT_TASKS. The tasks run in virtual time, ticks
+                  interrupt them, and the urgent software interrupt is taken when a tick returns
+                  as on the targets. The control task runs once as an ordinary cooperative task
+                  and once as an urgent task. Results are written as csv lines "mode,long_ms,
+                  runs,releases,latency_avg_us,latency_max_us". See README.md for the build.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_urgent.c */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "inc/scheduler.h"
+#include "scdl_port.h"
+#include "scdl_sim.h"
+
+#ifndef SCDL_URGENT_TASKS
+#error build with -DSCDL_URGENT_TASKS
+#endif
+
+/* in the urgent software interrupt, it does not nest */
+static unsigned char g_bSimInUrgent;
+
+static taskID_t g_tidSimCtl;
+static unsigned long long g_ullSimReleaseNs;
+static unsigned long long g_ullLatencySum;
+static unsigned long long g_ullLatencyMax;
+static unsigned long g_ulRuns;
+static unsigned long g_ulReleases;
+
+/* settings */
+static double g_dSeconds = 10.0;
+static unsigned long g_ulCtlUs = 50;
+static unsigned long g_ulLongMs = 30;
+static unsigned long g_ulLongPeriodMs = 50;
+
+/* virtual time, ns */
+unsigned long ulScdlPortCycles(void)
+{
+	return (unsigned long)g_ullSimNs;
+}
+
+/* tick interrupt, the urgent interrupt follows it */
+static void vSimUrgentTick(void)
+{
+	unsigned char bBlocked;
+
+	bBlocked = (g_tScdlDefault.atTask[g_tidSimCtl].eTaskState == BLOCKED);
+	vScdlTick();
+	/* released, the tick may also have started it */
+	if(bBlocked && g_tScdlDefault.atTask[g_tidSimCtl].eTaskState != BLOCKED)
+	{
+		g_ullSimReleaseNs = g_ullSimNs;
+		g_ulReleases++;
+	}
+
+	/* pended by the tick whenever an urgent task is ready, finds nothing otherwise */
+	if(!g_bSimInUrgent)
+	{
+		g_bSimInUrgent = 1;
+		vScdlUrgentDispatch();
+		g_bSimInUrgent = 0;
+	}
+}
+
+static void vTaskSimCtl(void)
+{
+	unsigned long long ullLatency = g_ullSimNs - g_ullSimReleaseNs;
+
+	g_ulRuns++;
+	g_ullLatencySum += ullLatency;
+	if(ullLatency > g_ullLatencyMax)
+		g_ullLatencyMax = ullLatency;
+
+	vSimRun(g_ulCtlUs * 1000ULL);
+}
+
+/* the pathological task */
+static void vTaskSimLong(void)
+{
+	vSimRun(g_ulLongMs * 1000000ULL);
+}
+
+/* one run, the control task as urgent task with bUrgent */
+static void vSimRunMode(unsigned char bUrgent)
+{
+	vSimReset((unsigned long long)(g_dSeconds * 1e9), vSimUrgentTick);
+	g_bSimInUrgent = 0;
+	/* created READY, the first tick starts the tasks */
+	g_ullSimReleaseNs = SIM_TICK_NS;
+	g_ullLatencySum = 0;
+	g_ullLatencyMax = 0;
+	g_ulRuns = 0;
+	g_ulReleases = 1;
+
+	/* the long task has the higher priority, the urgent tier preempts it anyway */
+	tidCreateTask(vTaskSimLong, SCDL_MS_TO_TICKS(g_ulLongPeriodMs));
+	g_tidSimCtl = tidCreateTask(vTaskSimCtl, SCDL_MS_TO_TICKS(1));
+	vTaskSetUrgent(g_tidSimCtl, bUrgent);
+
+	vSimStart();
+
+	printf("%s,%lu,%lu,%lu,%.1f,%.1f\n", bUrgent ? "urgent" : "cooperative", g_ulLongMs, g_ulRuns,
+			g_ulReleases, g_ulRuns ? g_ullLatencySum / 1e3 / g_ulRuns : 0.0, g_ullLatencyMax / 1e3);
+}
+
+int main(int argc, char *argv[])
+{
+	int a;
+
+	for(a = 1; a < argc; a++)
+	{
+		if(!strcmp(argv[a], "-s") && a + 1 < argc)
+			g_dSeconds = atof(argv[++a]);
+		else if(!strcmp(argv[a], "-c") && a + 1 < argc)
+			g_ulCtlUs = strtoul(argv[++a], 0, 10);
+		else if(!strcmp(argv[a], "-l") && a + 1 < argc
+				&& sscanf(argv[++a], "%lu:%lu", &g_ulLongMs, &g_ulLongPeriodMs) == 2 && g_ulLongPeriodMs)
+			;
+		else
+			break;
+	}
+	if(a != argc || g_ulCtlUs >= SCDL_TICK_US)
+	{
+		fprintf(stderr, "usage: %s [-s seconds] [-c control_task_us] [-l long_ms:long_period_ms]\n", argv[0]);
+		return 2;
+	}
+
+	printf("mode,long_ms,runs,releases,latency_avg_us,latency_max_us\n");
+	vSimRunMode(0);
+	vSimRunMode(1);
+
+	return 0;
+}
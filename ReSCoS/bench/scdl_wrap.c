@@ -0,0 +1,258 @@
+/**************************************************************************************************
+  Filename:       scdl_wrap.c
+  Author:         $Author: Menz $
+
+  Description:    Host benchmark of the tick counter before and after the free running counter.
+                  It holds copies of the tick of scheduler.c with the counter wrapping at
+                  SCDL_MAX_SYSTICKS and its wrap corrections, and with SCDL_TIME_REACHED. Both
+                  run periodic tasks across the old wrap at 0x7FFFFFFF and count starts off their
+                  period, then the time per tick is compared for 1 to SCDL_MAX_NUM_TASKS tasks.
+                  Results are written as csv lines "name,tasks,old,new". See README.md for the
+                  build.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_wrap.c */
+
+
+#include <stdio.h>
+#include <time.h>
+
+#include "inc/scheduler.h"
+#include "scdl_port.h"
+
+/** wrap of the counter before */
+#define WRAP_MAX_SYSTICKS	(0x7FFFFFFFUL)
+/** ticks per timed run */
+#define WRAP_TICKS			(20000UL)
+/** runs per result, old and new alternate, the fastest counts */
+#define WRAP_REPEAT			(101)
+/** ticks around the old wrap in the check */
+#define WRAP_CHECK_TICKS	(100000UL)
+
+/*!
+ * the task members used by the tick
+ */
+struct typWrapTask
+{
+	enum etypTaskStates eTaskState;
+	unsigned long ulTaskPeriod;
+	scdlTicks_t ulNextStartTime;
+	/** last start of the check */
+	scdlTicks_t ulLast;
+};
+
+static struct typWrapTask g_atWrapTasks[SCDL_MAX_NUM_TASKS];
+static unsigned char g_ucWrapTasks;
+static scdlTicks_t g_ulWrapTicks;
+
+unsigned long ulScdlPortCycles(void)
+{
+	struct timespec tNow;
+
+	clock_gettime(CLOCK_MONOTONIC, &tNow);
+	return (unsigned long)tNow.tv_sec * 1000000000UL + (unsigned long)tNow.tv_nsec;
+}
+
+/* no scheduler run here */
+void vBenchIdle(void)
+{
+}
+
+/* the tick before: wrap to 0 after SCDL_MAX_SYSTICKS and correct start times */
+static void __attribute__((noinline)) vWrapTickOld(void)
+{
+	struct typWrapTask *ptTaskHandle;
+	unsigned char i;
+
+	g_ulWrapTicks = (g_ulWrapTicks < WRAP_MAX_SYSTICKS) ? g_ulWrapTicks + 1 : 0;
+
+	for(i = 0; i < g_ucWrapTasks; i++)
+	{
+		ptTaskHandle = &g_atWrapTasks[i];
+
+		if(ptTaskHandle->eTaskState == BLOCKED)
+		{
+			if(ptTaskHandle->ulNextStartTime <= g_ulWrapTicks)
+			{
+				ptTaskHandle->eTaskState = READY;
+				/* only if we had a wrap around, the next start time is lower than the period */
+				if(ptTaskHandle->ulNextStartTime < ptTaskHandle->ulTaskPeriod)
+				{
+					ptTaskHandle->eTaskState = BLOCKED;
+					if(g_ulWrapTicks < ptTaskHandle->ulTaskPeriod)
+						ptTaskHandle->eTaskState = READY;
+				}
+			}
+		}
+	}
+}
+
+static void __attribute__((noinline)) vWrapActivateOld(struct typWrapTask *ptTaskHandle)
+{
+	ptTaskHandle->eTaskState = ACTIVE;
+	if(g_ulWrapTicks + ptTaskHandle->ulTaskPeriod <= WRAP_MAX_SYSTICKS)
+		ptTaskHandle->ulNextStartTime = g_ulWrapTicks + ptTaskHandle->ulTaskPeriod;
+	else
+		ptTaskHandle->ulNextStartTime = ptTaskHandle->ulTaskPeriod - (WRAP_MAX_SYSTICKS - g_ulWrapTicks);
+}
+
+/* the tick after: a free running counter and one signed compare */
+static void __attribute__((noinline)) vWrapTickNew(void)
+{
+	struct typWrapTask *ptTaskHandle;
+	scdlTicks_t ulNow;
+	unsigned char i;
+
+	ulNow = ++g_ulWrapTicks;
+
+	for(i = 0; i < g_ucWrapTasks; i++)
+	{
+		ptTaskHandle = &g_atWrapTasks[i];
+
+		if(ptTaskHandle->eTaskState == BLOCKED && SCDL_TIME_REACHED(ulNow, ptTaskHandle->ulNextStartTime))
+			ptTaskHandle->eTaskState = READY;
+	}
+}
+
+static void __attribute__((noinline)) vWrapActivateNew(struct typWrapTask *ptTaskHandle)
+{
+	ptTaskHandle->eTaskState = ACTIVE;
+	ptTaskHandle->ulNextStartTime = g_ulWrapTicks + ptTaskHandle->ulTaskPeriod;
+}
+
+static void vWrapReset(unsigned char ucTasks, unsigned long ulPeriod, scdlTicks_t ulStart)
+{
+	unsigned char i;
+
+	g_ulWrapTicks = ulStart;
+	g_ucWrapTasks = ucTasks;
+	for(i = 0; i < ucTasks; i++)
+	{
+		g_atWrapTasks[i].eTaskState = BLOCKED;
+		g_atWrapTasks[i].ulTaskPeriod = ulPeriod;
+		g_atWrapTasks[i].ulNextStartTime = ulStart + 1;
+	}
+}
+
+/* run every ready task at once, they take no time */
+static void vWrapRun(unsigned char bOld)
+{
+	unsigned char i;
+
+	for(i = 0; i < g_ucWrapTasks; i++)
+	{
+		if(g_atWrapTasks[i].eTaskState != READY)
+			continue;
+
+		if(bOld)
+			vWrapActivateOld(&g_atWrapTasks[i]);
+		else
+			vWrapActivateNew(&g_atWrapTasks[i]);
+		g_atWrapTasks[i].eTaskState = BLOCKED;
+	}
+}
+
+/* starts off their period around the old wrap, the old counter has WRAP_MAX_SYSTICKS + 1 values */
+static unsigned long ulWrapCheck(unsigned char bOld)
+{
+	static const unsigned long aulPeriods[] = { 1, 2, 3, 7, 100, 1000, 4096 };
+	unsigned long ulErrors = 0, ulTicks;
+	scdlTicks_t ulSince;
+	unsigned char i;
+
+	vWrapReset(sizeof(aulPeriods) / sizeof(aulPeriods[0]), 1, WRAP_MAX_SYSTICKS - WRAP_CHECK_TICKS / 2);
+	for(i = 0; i < g_ucWrapTasks; i++)
+	{
+		g_atWrapTasks[i].ulTaskPeriod = aulPeriods[i];
+		g_atWrapTasks[i].ulLast = g_ulWrapTicks + 1 - aulPeriods[i];
+	}
+
+	for(ulTicks = 0; ulTicks < WRAP_CHECK_TICKS; ulTicks++)
+	{
+		if(bOld)
+			vWrapTickOld();
+		else
+			vWrapTickNew();
+
+		for(i = 0; i < g_ucWrapTasks; i++)
+		{
+			if(g_atWrapTasks[i].eTaskState != READY)
+				continue;
+
+			ulSince = g_ulWrapTicks - g_atWrapTasks[i].ulLast;
+			if(bOld)
+				ulSince &= WRAP_MAX_SYSTICKS;
+			if(ulSince != g_atWrapTasks[i].ulTaskPeriod)
+				ulErrors++;
+			g_atWrapTasks[i].ulLast = g_ulWrapTicks;
+		}
+		vWrapRun(bOld);
+	}
+
+	return ulErrors;
+}
+
+/* ns per tick of one timed run, tasks released every ulPeriod ticks */
+static double dWrapTime(unsigned char bOld, unsigned char ucTasks, unsigned long ulPeriod)
+{
+	unsigned long ulStart, ulTicks;
+
+	/* far from the wrap, where the counter is most of the time */
+	vWrapReset(ucTasks, ulPeriod, 0);
+
+	ulStart = ulScdlPortCycles();
+	for(ulTicks = 0; ulTicks < WRAP_TICKS; ulTicks++)
+	{
+		if(bOld)
+		{
+			vWrapTickOld();
+			vWrapRun(1);
+		}
+		else
+		{
+			vWrapTickNew();
+			vWrapRun(0);
+		}
+	}
+
+	return (double)(ulScdlPortCycles() - ulStart) / WRAP_TICKS;
+}
+
+int main(void)
+{
+	static const unsigned char aucTasks[] = { 1, 4, 8, SCDL_MAX_NUM_TASKS };
+	static const char * const apcNames[] = { "tick_release", "tick_idle" };
+	static const unsigned long aulPeriods[] = { 1, 1000000 };
+	double dOld, dNew, dMinOld, dMinNew;
+	unsigned long ulOld, ulNew;
+	unsigned char i, p, r;
+
+	ulOld = ulWrapCheck(1);
+	ulNew = ulWrapCheck(0);
+	printf("name,tasks,old,new\n");
+	printf("wrong_starts,7,%lu,%lu\n", ulOld, ulNew);
+
+	for(p = 0; p < sizeof(aulPeriods) / sizeof(aulPeriods[0]); p++)
+	{
+		for(i = 0; i < sizeof(aucTasks); i++)
+		{
+			dMinOld = 1e9;
+			dMinNew = 1e9;
+			for(r = 0; r < WRAP_REPEAT; r++)
+			{
+				dOld = dWrapTime(1, aucTasks[i], aulPeriods[p]);
+				dNew = dWrapTime(0, aucTasks[i], aulPeriods[p]);
+				if(dOld < dMinOld)
+					dMinOld = dOld;
+				if(dNew < dMinNew)
+					dMinNew = dNew;
+			}
+			printf("%s,%u,%.2f,%.2f\n", apcNames[p], aucTasks[i], dMinOld, dMinNew);
+		}
+	}
+
+	/* the new counter must not miss a period */
+	return ulNew ? 1 : 0;
+}
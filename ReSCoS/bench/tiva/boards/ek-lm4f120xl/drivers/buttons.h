@@ -0,0 +1,19 @@
+/*
+ * buttons.h
+ *
+ *  TivaWare stand-in of inputs_sim.c, the buttons of the EK-LM4F120XL.
+ */
+
+#ifndef BUTTONS_H_
+#define BUTTONS_H_
+
+#include "inc/hw_memmap.h"
+#include "driverlib/gpio.h"
+
+#define BUTTONS_GPIO_BASE		GPIO_PORTF_BASE
+
+#define LEFT_BUTTON				GPIO_PIN_4
+#define RIGHT_BUTTON			GPIO_PIN_0
+#define ALL_BUTTONS				(LEFT_BUTTON | RIGHT_BUTTON)
+
+#endif /* BUTTONS_H_ */
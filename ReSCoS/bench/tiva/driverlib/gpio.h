@@ -0,0 +1,21 @@
+/*
+ * gpio.h
+ *
+ *  TivaWare stand-in of inputs_sim.c, implemented by the simulation.
+ */
+
+#ifndef GPIO_H_
+#define GPIO_H_
+
+#define GPIO_PIN_0				(0x01)
+#define GPIO_PIN_4				(0x10)
+
+#define GPIO_BOTH_EDGES			(0x01)
+
+long GPIOPinRead(unsigned long ulPort, unsigned char ucPins);
+void GPIOIntTypeSet(unsigned long ulPort, unsigned char ucPins, unsigned long ulIntType);
+void GPIOPinIntEnable(unsigned long ulPort, unsigned char ucPins);
+void GPIOPinIntDisable(unsigned long ulPort, unsigned char ucPins);
+void GPIOPinIntClear(unsigned long ulPort, unsigned char ucPins);
+
+#endif /* GPIO_H_ */
@@ -0,0 +1,12 @@
+/*
+ * interrupt.h
+ *
+ *  TivaWare stand-in of inputs_sim.c, implemented by the simulation.
+ */
+
+#ifndef INTERRUPT_H_
+#define INTERRUPT_H_
+
+void IntEnable(unsigned long ulInterrupt);
+
+#endif /* INTERRUPT_H_ */
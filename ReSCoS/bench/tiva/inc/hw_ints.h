@@ -0,0 +1,12 @@
+/*
+ * hw_ints.h
+ *
+ *  TivaWare stand-in of inputs_sim.c.
+ */
+
+#ifndef HW_INTS_H_
+#define HW_INTS_H_
+
+#define INT_GPIOF				(46)
+
+#endif /* HW_INTS_H_ */
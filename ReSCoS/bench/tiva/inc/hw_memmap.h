@@ -0,0 +1,12 @@
+/*
+ * hw_memmap.h
+ *
+ *  TivaWare stand-in of inputs_sim.c, the GPIO port is a mock.
+ */
+
+#ifndef HW_MEMMAP_H_
+#define HW_MEMMAP_H_
+
+#define GPIO_PORTF_BASE			(0x40025000UL)
+
+#endif /* HW_MEMMAP_H_ */
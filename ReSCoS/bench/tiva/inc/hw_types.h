@@ -0,0 +1,10 @@
+/*
+ * hw_types.h
+ *
+ *  TivaWare stand-in of inputs_sim.c, nothing is needed.
+ */
+
+#ifndef HW_TYPES_H_
+#define HW_TYPES_H_
+
+#endif /* HW_TYPES_H_ */
@@ -0,0 +1,439 @@
+/**************************************************************************************************
+  Filename:       uart_rx_sim.c
+  Author:         $Author: Menz $
+
+  Description:    Host test of the batched UART receive of Stellaris_ReSCoS/src/uart_rx.c. A mock
+                  of uart_rx_hw.h models the 16 byte FIFO, the ping-pong DMA with bursts of 8 and
+                  the receive timeout after 32 bit times, bursty input arrives at the given baud
+                  rate in virtual time. The consumer task checks that every byte the FIFO accepted
+                  arrives once and in order and records the latency from the stop bit to the
+                  task. With -p the old polling task drains the FIFO every 50 ms instead. See
+                  README.md for the build.
+
+**************************************************************************************************/
+
+
+/*! @file uart_rx_sim.c */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "inc/scheduler.h"
+#include "inc/uart_rx.h"
+#include "scdl_port.h"
+#include "scdl_sim.h"
+
+#define SIM_NEVER			(~0ULL)
+
+#define MOCK_FIFO_LEN		(16)
+
+/*
+ * mock of UART0 and its DMA channel
+ */
+struct typMockHalf
+{
+	unsigned char *pucBuf;
+	unsigned short usLen;
+	unsigned short usPos;
+	/* ping-pong mode, otherwise stop */
+	unsigned char bArmed;
+};
+
+static struct
+{
+	unsigned char aucFifo[MOCK_FIFO_LEN];
+	unsigned char ucFifoHead;
+	unsigned char ucFifoCount;
+	struct typMockHalf atHalf[2];
+	unsigned char ucSel;
+	unsigned char bEnabled;
+	/* raw interrupt status and masks */
+	unsigned char bTimeoutRaw;
+	unsigned char bTimeoutEn;
+	unsigned char bOverrunRaw;
+	unsigned char bDonePending;
+	unsigned char bIrqEn;
+	unsigned long long ullLastRx;
+	unsigned long ulDropped;
+	unsigned long ulIsrs;
+} g_tMock;
+
+/*
+ * the sender
+ */
+static unsigned long long g_ullByteNs;
+static unsigned long long g_ullNextByteNs;
+static unsigned long g_ulBurstLeft = 0;
+static unsigned long g_ulMaxBurst = 200;
+static unsigned long g_ulMaxGapUs = 20000;
+static unsigned long g_ulSent = 0;
+static unsigned long g_ulSeed = 1;
+/* arrival of each byte by sequence number, and the bytes accepted by the FIFO in order */
+static unsigned long long g_aullArrival[0x10000];
+static unsigned long g_aulAccepted[0x10000];
+static unsigned short g_usAcceptedHead = 0;
+static unsigned short g_usAcceptedTail = 0;
+
+/* command line */
+static unsigned long g_ulBaud = 115200;
+static double g_dSeconds = 10.0;
+static unsigned char g_bPoll = 0;
+
+/*
+ * the consumer
+ */
+static unsigned long g_ulCostNs = 1000;
+static unsigned long g_ulBatchCostNs = 10000;
+static unsigned long g_ulHogNs = 0;
+static unsigned long g_ulHogPeriodMs = 0;
+static unsigned long g_ulReceived = 0;
+static unsigned long g_ulErrors = 0;
+static unsigned long g_ulRuns = 0;
+static unsigned long long g_ullLatencySum = 0;
+static unsigned long long g_ullLatencyMax = 0;
+
+static unsigned long ulSimRand(void)
+{
+	g_ulSeed = g_ulSeed * 1103515245UL + 12345UL;
+	return (g_ulSeed >> 16) & 0x7FFF;
+}
+
+/* virtual time, ns */
+unsigned long ulScdlPortCycles(void)
+{
+	return (unsigned long)g_ullSimNs;
+}
+
+static unsigned long ulMockIrq(void);
+
+/* the console received since boot, an overrun is pending before the driver starts */
+void vUartRxHwInit(void)
+{
+	g_tMock.bIrqEn = 0;
+	g_tMock.bOverrunRaw = 1;
+}
+
+void vUartRxHwArm(unsigned char ucHalf, unsigned char *pucBuf, unsigned short usLen)
+{
+	g_tMock.atHalf[ucHalf].pucBuf = pucBuf;
+	g_tMock.atHalf[ucHalf].usLen = usLen;
+	g_tMock.atHalf[ucHalf].usPos = 0;
+	g_tMock.atHalf[ucHalf].bArmed = 1;
+}
+
+unsigned char bUartRxHwDone(unsigned char ucHalf)
+{
+	return !g_tMock.atHalf[ucHalf].bArmed;
+}
+
+unsigned short usUartRxHwCut(unsigned char ucHalf)
+{
+	struct typMockHalf *ptHalf = &g_tMock.atHalf[ucHalf];
+
+	g_tMock.bEnabled = 0;
+	if(!ptHalf->bArmed)
+		return 0;
+	ptHalf->bArmed = 0;
+	return ptHalf->usLen - ptHalf->usPos;
+}
+
+void vUartRxHwResume(unsigned char ucHalf)
+{
+	g_tMock.ucSel = ucHalf;
+	g_tMock.bEnabled = 1;
+}
+
+unsigned char bUartRxHwRunning(void)
+{
+	return g_tMock.bEnabled;
+}
+
+static unsigned char ucMockPop(void)
+{
+	unsigned char ucByte = g_tMock.aucFifo[g_tMock.ucFifoHead];
+
+	g_tMock.ucFifoHead = (g_tMock.ucFifoHead + 1) % MOCK_FIFO_LEN;
+	g_tMock.ucFifoCount--;
+	return ucByte;
+}
+
+unsigned short usUartRxHwDrain(unsigned char *pucDst, unsigned short usMax)
+{
+	unsigned short usLen = 0;
+
+	while(usLen < usMax && g_tMock.ucFifoCount)
+		pucDst[usLen++] = ucMockPop();
+	if(!g_tMock.ucFifoCount)
+		g_tMock.bTimeoutRaw = 0;
+
+	return usLen;
+}
+
+unsigned char ucUartRxHwEvents(void)
+{
+	unsigned char ucEvents = 0;
+
+	if(g_tMock.bTimeoutRaw && g_tMock.bTimeoutEn)
+	{
+		g_tMock.bTimeoutRaw = 0;
+		ucEvents |= UART_RX_HW_TIMEOUT;
+	}
+	if(g_tMock.bOverrunRaw)
+	{
+		g_tMock.bOverrunRaw = 0;
+		ucEvents |= UART_RX_HW_OVERRUN;
+	}
+	return ucEvents;
+}
+
+void vUartRxHwTimeout(unsigned char bEnable)
+{
+	g_tMock.bTimeoutEn = bEnable;
+}
+
+/* a pending interrupt is taken at once */
+void vUartRxHwIrqEnable(void)
+{
+	g_tMock.bIrqEn = 1;
+	ulMockIrq();
+}
+
+/* bursts whenever the FIFO level is reached, as UDMA_ATTR_USEBURST */
+static void vMockDma(void)
+{
+	struct typMockHalf *ptHalf;
+	unsigned char i;
+
+	while(g_tMock.bEnabled && g_tMock.ucFifoCount >= UART_RX_HW_BURST)
+	{
+		ptHalf = &g_tMock.atHalf[g_tMock.ucSel];
+		if(!ptHalf->bArmed)
+		{
+			g_tMock.bEnabled = 0;
+			break;
+		}
+		for(i = 0; i < UART_RX_HW_BURST; i++)
+			ptHalf->pucBuf[ptHalf->usPos++] = ucMockPop();
+		if(ptHalf->usPos == ptHalf->usLen)
+		{
+			/* completion is signalled on the UART interrupt, the channel goes on or stops */
+			ptHalf->bArmed = 0;
+			g_tMock.bDonePending = 1;
+			g_tMock.ucSel ^= 1;
+			if(!g_tMock.atHalf[g_tMock.ucSel].bArmed)
+				g_tMock.bEnabled = 0;
+		}
+	}
+}
+
+/* run the ISR while an enabled interrupt is pending, returns the number of runs */
+static unsigned long ulMockIrq(void)
+{
+	unsigned long ulRuns = 0;
+
+	while(g_tMock.bIrqEn && (g_tMock.bDonePending || g_tMock.bOverrunRaw
+			|| (g_tMock.bTimeoutRaw && g_tMock.bTimeoutEn)))
+	{
+		g_tMock.bDonePending = 0;
+		g_tMock.ulIsrs++;
+		ulRuns++;
+		vUartRxIntHandler();
+		vMockDma();
+	}
+	return ulRuns;
+}
+
+/* stop bit of the next byte, the sender counts up */
+static void vMockReceive(void)
+{
+	if(g_tMock.ucFifoCount == MOCK_FIFO_LEN)
+	{
+		g_tMock.ulDropped++;
+		g_tMock.bOverrunRaw = 1;
+	}
+	else
+	{
+		g_tMock.aucFifo[(g_tMock.ucFifoHead + g_tMock.ucFifoCount) % MOCK_FIFO_LEN] = (unsigned char)g_ulSent;
+		g_tMock.ucFifoCount++;
+		g_aulAccepted[g_usAcceptedHead++] = g_ulSent;
+	}
+	g_aullArrival[g_ulSent & 0xFFFF] = g_ullSimNs;
+	g_ulSent++;
+	g_tMock.ullLastRx = g_ullSimNs;
+
+	g_ullNextByteNs = g_ullSimNs + g_ullByteNs;
+	if(g_ulBurstLeft)
+		g_ulBurstLeft--;
+	else
+	{
+		g_ullNextByteNs += (unsigned long long)(ulSimRand() % (g_ulMaxGapUs + 1)) * 1000;
+		g_ulBurstLeft = ulSimRand() % g_ulMaxBurst;
+	}
+}
+
+/* process bytes and timeouts up to ullTo, with bWake stop after an interrupt */
+static unsigned char bSimAdvance(unsigned long long ullTo, unsigned char bWake)
+{
+	/* 32 bit times at 10 bits per byte */
+	unsigned long long ullTimeout, ullNext;
+
+	for(;;)
+	{
+		ullTimeout = (g_tMock.ucFifoCount && !g_tMock.bTimeoutRaw) ? g_tMock.ullLastRx + g_ullByteNs * 32 / 10 : SIM_NEVER;
+		ullNext = (g_ullNextByteNs < ullTimeout) ? g_ullNextByteNs : ullTimeout;
+		if(ullNext > ullTo)
+			break;
+
+		g_ullSimNs = ullNext;
+		if(ullNext == g_ullNextByteNs)
+			vMockReceive();
+		else
+			g_tMock.bTimeoutRaw = 1;
+
+		vMockDma();
+		if(ulMockIrq() && bWake)
+			return 1;
+	}
+	g_ullSimNs = ullTo;
+	return 0;
+}
+
+/* tick interrupt */
+static void vSimUartTick(void)
+{
+	/* a resumed channel finds the FIFO level reached without a new byte */
+	vMockDma();
+	ulMockIrq();
+	vScdlTick();
+}
+
+/* check order and latency of received bytes */
+static void vSimConsume(const unsigned char *pucData, unsigned short usLen)
+{
+	unsigned long ulSeq;
+	unsigned long long ullLatency;
+	unsigned short i;
+
+	vSimRun(g_ulBatchCostNs + usLen * g_ulCostNs);
+
+	for(i = 0; i < usLen; i++)
+	{
+		if(g_usAcceptedTail == g_usAcceptedHead)
+		{
+			/* more bytes than were received */
+			g_ulErrors++;
+			continue;
+		}
+		ulSeq = g_aulAccepted[g_usAcceptedTail++];
+		if(pucData[i] != (unsigned char)ulSeq)
+			g_ulErrors++;
+
+		ullLatency = g_ullSimNs - g_aullArrival[ulSeq & 0xFFFF];
+		g_ullLatencySum += ullLatency;
+		if(ullLatency > g_ullLatencyMax)
+			g_ullLatencyMax = ullLatency;
+		g_ulReceived++;
+	}
+}
+
+static void vTaskSimRx(void)
+{
+	const unsigned char *pucBatch;
+	unsigned short usLen;
+
+	g_ulRuns++;
+	while((usLen = usUartRxGet(&pucBatch)) != 0)
+	{
+		vSimConsume(pucBatch, usLen);
+		vUartRxRelease();
+	}
+}
+
+/* the task replaced by uart_rx.c, one driverlib call per byte */
+static void vTaskSimPoll(void)
+{
+	unsigned char aucBuf[MOCK_FIFO_LEN];
+	unsigned short usLen;
+
+	g_ulRuns++;
+	while((usLen = usUartRxHwDrain(aucBuf, 1)) != 0)
+		vSimConsume(aucBuf, usLen);
+}
+
+/* a long cooperative task delaying the receive task */
+static void vTaskSimHog(void)
+{
+	vSimRun(g_ulHogNs);
+}
+
+int main(int argc, char *argv[])
+{
+	struct typUartRxStats tStats;
+	unsigned long ulHogMs;
+	int a;
+
+	for(a = 1; a < argc; a++)
+	{
+		if(!strcmp(argv[a], "-p"))
+			g_bPoll = 1;
+		else if(!strcmp(argv[a], "-s") && a + 1 < argc)
+			g_dSeconds = atof(argv[++a]);
+		else if(!strcmp(argv[a], "-b") && a + 1 < argc)
+			g_ulBaud = strtoul(argv[++a], 0, 10);
+		else if(!strcmp(argv[a], "-m") && a + 1 < argc)
+			g_ulMaxBurst = strtoul(argv[++a], 0, 10);
+		else if(!strcmp(argv[a], "-g") && a + 1 < argc)
+			g_ulMaxGapUs = strtoul(argv[++a], 0, 10);
+		else if(!strcmp(argv[a], "-c") && a + 1 < argc)
+			g_ulCostNs = strtoul(argv[++a], 0, 10);
+		else if(!strcmp(argv[a], "-l") && a + 1 < argc
+				&& sscanf(argv[++a], "%lu:%lu", &ulHogMs, &g_ulHogPeriodMs) == 2 && g_ulHogPeriodMs)
+			g_ulHogNs = ulHogMs * 1000000UL;
+		else
+			break;
+	}
+	if(a != argc || !g_ulBaud || !g_ulMaxBurst)
+	{
+		fprintf(stderr, "usage: %s [-p] [-s seconds] [-b baud] [-m max_burst_bytes] [-g max_gap_us]\n"
+						"          [-c consumer_ns_per_byte] [-l hog_run_ms:hog_period_ms]\n", argv[0]);
+		return 2;
+	}
+
+	vSimReset((unsigned long long)(g_dSeconds * 1e9), vSimUartTick);
+	vSimSetAdvance(bSimAdvance);
+	g_ullByteNs = 10000000000ULL / g_ulBaud;
+	g_ullNextByteNs = g_ullByteNs;
+
+	/* the receive task has priority, as in main.c */
+	if(g_bPoll)
+		tidCreateTask(vTaskSimPoll, SCDL_MS_TO_TICKS(50));
+	else
+		vUartRxInit(tidCreateTask(vTaskSimRx, SCDL_INF_PERIOD));
+	if(g_ulHogNs)
+		tidCreateTask(vTaskSimHog, SCDL_MS_TO_TICKS(g_ulHogPeriodMs));
+
+	vSimStart();
+
+	printf("mode,baud,sent,received,dropped,errors,bytes_per_s,wakeups,isrs,latency_avg_ms,latency_max_ms\n");
+	printf("%s,%lu,%lu,%lu,%lu,%lu,%.0f,%lu,%lu,%.3f,%.3f\n", g_bPoll ? "poll" : "dma", g_ulBaud, g_ulSent,
+			g_ulReceived, g_tMock.ulDropped, g_ulErrors, g_ulReceived / g_dSeconds, g_ulRuns, g_tMock.ulIsrs,
+			g_ulReceived ? g_ullLatencySum / 1e6 / g_ulReceived : 0.0, g_ullLatencyMax / 1e6);
+
+	if(!g_bPoll)
+	{
+		vUartRxGetStats(&tStats);
+		printf("batches,avg_batch,timeouts,stalls,overruns\n");
+		printf("%lu,%.1f,%u,%u,%u\n", tStats.ulBatches, tStats.ulBatches ? (double)tStats.ulBytes / tStats.ulBatches : 0.0,
+				tStats.usTimeouts, tStats.usStalls, tStats.usOverruns);
+	}
+
+	/* every byte accepted by the FIFO arrived once and in order, the rest is still buffered */
+	if(g_ulErrors || g_ulSent - g_ulReceived - g_tMock.ulDropped > 2 * UART_RX_BATCH_LEN + MOCK_FIFO_LEN)
+	{
+		printf("lost or reordered bytes\n");
+		return 1;
+	}
+	return 0;
+}
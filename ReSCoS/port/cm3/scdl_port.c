@@ -0,0 +1,97 @@
+/**************************************************************************************************
+  Filename:       scdl_port.c
+  Author:         $Author: Menz $
+
+  Description:    Scheduler port for Cortex-M3/M4. SysTick generates the tick, the DWT
+                  cycle counter is used for time measurements. With SCDL_URGENT_TASKS
+                  PendSV at the lowest priority dispatches the urgent tasks.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_port.c */
+
+
+/* low level */
+#include "inc/hw_types.h"
+#include "inc/hw_ints.h"
+/* driverlib */
+#include "driverlib/interrupt.h"
+#include "driverlib/systick.h"
+/* project */
+#include "inc/scheduler.h"
+#include "scdl_port.h"
+
+/* debug and trace registers, not covered by driverlib */
+#define SCDL_PORT_DEMCR				(0xE000EDFC)
+#define SCDL_PORT_DEMCR_TRCENA		(0x01000000)
+#define SCDL_PORT_DWT_CTRL			(0xE0001000)
+#define SCDL_PORT_DWT_CTRL_CYCCNTENA	(0x00000001)
+#define SCDL_PORT_DWT_CYCCNT		(0xE0001004)
+
+#define SCDL_PORT_SYSTICK_PERIOD	(SCDL_PORT_CPU_HZ / 1000 * SCDL_TICK_US / 1000)
+
+#if (SCDL_PORT_SYSTICK_PERIOD > 0x1000000) || (SCDL_PORT_SYSTICK_PERIOD < 1)
+#error SCDL_TICK_US not reachable with the 24 bit SysTick
+#endif
+
+/*! **********************************************************************************
+ * @fn		vScdlPortCyclesInit
+ *
+ * @brief	start the cycle counter from 0, uses no data, so the reset handler may call
+ * 			it before the C runtime is set up
+ *
+ */
+void vScdlPortCyclesInit(void)
+{
+	HWREG(SCDL_PORT_DEMCR) |= SCDL_PORT_DEMCR_TRCENA;
+	HWREG(SCDL_PORT_DWT_CYCCNT) = 0;
+	HWREG(SCDL_PORT_DWT_CTRL) |= SCDL_PORT_DWT_CTRL_CYCCNTENA;
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlPortTickInit
+ *
+ * @brief	start the SysTick and the cycle counter, interrupts must be enabled
+ * 			by the application
+ *
+ */
+void vScdlPortTickInit(void)
+{
+	/* a counter started at reset keeps counting */
+	if(!(HWREG(SCDL_PORT_DEMCR) & SCDL_PORT_DEMCR_TRCENA) || !(HWREG(SCDL_PORT_DWT_CTRL) & SCDL_PORT_DWT_CTRL_CYCCNTENA))
+		vScdlPortCyclesInit();
+
+#ifdef SCDL_URGENT_TASKS
+	/* below every other interrupt, SysTick keeps priority 0 */
+	IntPrioritySet(FAULT_PENDSV, 0xE0);
+#endif
+
+	SysTickPeriodSet(SCDL_PORT_SYSTICK_PERIOD);
+	SysTickIntEnable();
+	SysTickEnable();
+}
+
+/*! **********************************************************************************
+ * @fn		ulScdlPortCycles
+ *
+ * @brief	read the free running DWT cycle counter
+ *
+ * @return	CPU cycles since vScdlPortCyclesInit
+ */
+unsigned long ulScdlPortCycles(void)
+{
+	return HWREG(SCDL_PORT_DWT_CYCCNT);
+}
+
+void SysTickIntHandler(void)
+{
+	vScdlTick();
+}
+
+void PendSVIntHandler(void)
+{
+#ifdef SCDL_URGENT_TASKS
+	vScdlUrgentDispatch();
+#endif
+}
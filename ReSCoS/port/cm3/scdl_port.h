@@ -0,0 +1,57 @@
+/*
+ * scdl_port.h
+ *
+ *  Scheduler port for Cortex-M3/M4 (Stellaris), SysTick as tick source,
+ *  PendSV runs the urgent tasks.
+ */
+
+/*! @file */
+
+#ifndef SCDL_PORT_H_
+#define SCDL_PORT_H_
+
+#include "inc/hw_types.h"
+#include "inc/hw_nvic.h"
+
+#include "inc/scdl_config.h"
+
+#ifndef SCDL_PORT_CPU_HZ
+#error SCDL_PORT_CPU_HZ must be defined in scdl_config.h
+#endif
+
+#define SCDL_PORT_DISABLE_INTERRUPTS()	_disable_interrupts()
+#define SCDL_PORT_ENABLE_INTERRUPTS()	_enable_interrupts()
+
+/* nestable critical sections, the previous PRIMASK is saved in s */
+typedef unsigned int scdlIrqState_t;
+#define SCDL_PORT_ENTER_CRITICAL(s)		{ (s) = _disable_interrupts(); }
+#define SCDL_PORT_EXIT_CRITICAL(s)		_restore_interrupts(s)
+#define SCDL_PORT_IRQ_WAS_ENABLED(s)	(!((s) & 1))
+/* wfi wakes on a pending interrupt even if PRIMASK is set, so there is no lost wake up,
+   a project may provide its own in scdl_config.h, it must enable interrupts */
+#ifndef SCDL_PORT_IDLE_SLEEP
+#define SCDL_PORT_IDLE_SLEEP()			{ __asm(" wfi"); _enable_interrupts(); }
+#endif
+
+/* PendSV has the lowest priority, urgent tasks run when all other ISRs returned */
+#define SCDL_PORT_PEND_URGENT()			{ HWREG(NVIC_INT_CTRL) = NVIC_INT_CTRL_PEND_SV; }
+
+/** resolution of ulScdlPortCycles */
+#define SCDL_PORT_CYCLES_PER_MS			(SCDL_PORT_CPU_HZ / 1000)
+
+#ifdef SCDL_MEASURE_STACK
+/* main stack, __STACK_TOP is set in the linker command file */
+extern unsigned long __stack;
+extern unsigned long __STACK_TOP;
+#define SCDL_PORT_STACK_TOP				((unsigned char *)&__STACK_TOP)
+#define SCDL_PORT_STACK_LIMIT			((unsigned char *)&__stack)
+#endif
+
+void vScdlPortCyclesInit(void);
+void vScdlPortTickInit(void);
+unsigned long ulScdlPortCycles(void);
+
+void SysTickIntHandler(void);
+void PendSVIntHandler(void);
+
+#endif /* SCDL_PORT_H_ */
@@ -0,0 +1,119 @@
+/**************************************************************************************************
+  Filename:       scdl_port.c
+  Author:         $Author: Menz $
+
+  Description:    Scheduler port for MSP430. Timer A0 in up mode generates the tick.
+                  With SCDL_URGENT_TASKS the port 2 vector is the urgent software interrupt.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_port.c */
+
+
+#include <msp430.h>
+
+#include "inc/scheduler.h"
+#include "scdl_port.h"
+
+/* timer A runs with SMCLK / 8 */
+#define SCDL_PORT_TIMER_DIV		(8)
+#define SCDL_PORT_TIMER_PERIOD	(SCDL_PORT_SMCLK_HZ / SCDL_PORT_TIMER_DIV / 1000 * SCDL_TICK_US / 1000)
+
+#if (SCDL_PORT_TIMER_PERIOD > 0x10000) || (SCDL_PORT_TIMER_PERIOD < 1)
+#error SCDL_TICK_US not reachable with the 16 bit timer
+#endif
+
+static volatile unsigned long g_ulPortTicks = 0;
+
+/*! **********************************************************************************
+ * @fn		vScdlPortTickInit
+ *
+ * @brief	start the tick, interrupts must be enabled by the application
+ *
+ */
+void vScdlPortTickInit(void)
+{
+	/* compare interrupt */
+	TACCTL0 |= CCIE;
+	/* up mode counts 0..TACCR0 */
+	TACCR0 = SCDL_PORT_TIMER_PERIOD - 1;
+	/* configure timer A with subsystemclock / 8 and up-mode */
+	TACTL = TASSEL_2 | MC_1 | ID0 | ID1;
+
+#ifdef SCDL_URGENT_TASKS
+	/* output without edges, the flag is only set by SCDL_PORT_PEND_URGENT */
+	P2SEL &= ~SCDL_PORT_URGENT_BIT;
+	P2DIR |= SCDL_PORT_URGENT_BIT;
+	P2IFG &= ~SCDL_PORT_URGENT_BIT;
+	P2IE |= SCDL_PORT_URGENT_BIT;
+#endif
+}
+
+/*! **********************************************************************************
+ * @fn		ulScdlPortCycles
+ *
+ * @brief	free running SMCLK cycle count with a resolution of SCDL_PORT_TIMER_DIV,
+ * 			built from the tick count and the timer register. Also valid with
+ * 			interrupts masked for up to one tick period.
+ *
+ * @return	cycles since vScdlPortTickInit
+ */
+unsigned long ulScdlPortCycles(void)
+{
+	unsigned long ulTicks;
+	unsigned short usTimer;
+	unsigned char ucPending;
+
+	/* the 32 bit tick count is not read atomically, retry if the ISR changed it */
+	do
+	{
+		ulTicks = g_ulPortTicks;
+		usTimer = TAR;
+		ucPending = 0;
+		/* the timer reached TACCR0 but the ISR did not run yet, interrupts are masked */
+		if(TACCTL0 & CCIFG)
+		{
+			/* read again after the flag, the timer wrapped unless it still is at TACCR0 */
+			usTimer = TAR;
+			if(usTimer != SCDL_PORT_TIMER_PERIOD - 1)
+				ucPending = 1;
+		}
+	} while(ulTicks != g_ulPortTicks);
+
+	return ((ulTicks + ucPending) * SCDL_PORT_TIMER_PERIOD + usTimer) * SCDL_PORT_TIMER_DIV;
+}
+
+#pragma vector=TIMER0_A0_VECTOR
+__interrupt void Timer0_A0 (void)
+{
+	g_ulPortTicks++;
+
+	/* function must be called every SCDL_TICK_US */
+	vScdlTick();
+
+	/* leave LPM0 in case the scheduler idles in SCDL_PORT_IDLE_SLEEP */
+	__bic_SR_register_on_exit(LPM0_bits);
+}
+
+#ifdef SCDL_URGENT_TASKS
+#pragma vector=PORT2_VECTOR
+__interrupt void vScdlPortUrgentISR(void)
+{
+	P2IFG &= ~SCDL_PORT_URGENT_BIT;
+
+	/* the MSP430 has no interrupt priorities: keep this one masked against
+	   itself and let the tick and all other interrupts nest */
+	P2IE &= ~SCDL_PORT_URGENT_BIT;
+	__enable_interrupt();
+
+	vScdlUrgentDispatch();
+
+	/* a request raised meanwhile fires again right after the reti */
+	__disable_interrupt();
+	P2IE |= SCDL_PORT_URGENT_BIT;
+
+	/* urgent tasks may have made cooperative tasks ready */
+	__bic_SR_register_on_exit(LPM0_bits);
+}
+#endif
@@ -0,0 +1,55 @@
+/*
+ * scdl_port.h
+ *
+ *  Scheduler port for MSP430, Timer A0 as tick source. Urgent tasks run from
+ *  the port 2 interrupt, triggered in software on the pin SCDL_PORT_URGENT_BIT.
+ */
+
+/*! @file */
+
+#ifndef SCDL_PORT_H_
+#define SCDL_PORT_H_
+
+#include <msp430.h>
+
+#include "inc/scdl_config.h"
+
+#ifndef SCDL_PORT_SMCLK_HZ
+#error SCDL_PORT_SMCLK_HZ must be defined in scdl_config.h
+#endif
+
+#define SCDL_PORT_DISABLE_INTERRUPTS()	_disable_interrupts()
+#define SCDL_PORT_ENABLE_INTERRUPTS()	_enable_interrupts()
+
+/* nestable critical sections, the previous interrupt state is saved in s */
+typedef unsigned short scdlIrqState_t;
+#define SCDL_PORT_ENTER_CRITICAL(s)		{ (s) = __get_interrupt_state(); __disable_interrupt(); }
+#define SCDL_PORT_EXIT_CRITICAL(s)		__set_interrupt_state(s)
+#define SCDL_PORT_IRQ_WAS_ENABLED(s)	((s) & GIE)
+/* enter LPM0 and enable interrupts in one instruction, the tick ISR wakes us */
+#define SCDL_PORT_IDLE_SLEEP()			__bis_SR_register(LPM0_bits | GIE)
+
+#ifdef SCDL_URGENT_TASKS
+/* port 2 pin used as software interrupt, must not be used otherwise */
+#ifndef SCDL_PORT_URGENT_BIT
+#define SCDL_PORT_URGENT_BIT			BIT5
+#endif
+/* the interrupt is taken after the tick ISR returned */
+#define SCDL_PORT_PEND_URGENT()			{ P2IFG |= SCDL_PORT_URGENT_BIT; }
+#endif
+
+/** resolution of ulScdlPortCycles */
+#define SCDL_PORT_CYCLES_PER_MS			(SCDL_PORT_SMCLK_HZ / 1000)
+
+#ifdef SCDL_MEASURE_STACK
+/* stack section symbols of the TI linker, see -stack in the linker command file */
+extern unsigned char __STACK_END;
+extern unsigned char __STACK_SIZE;
+#define SCDL_PORT_STACK_TOP				(&__STACK_END)
+#define SCDL_PORT_STACK_LIMIT			(&__STACK_END - (unsigned short)&__STACK_SIZE)
+#endif
+
+void vScdlPortTickInit(void);
+unsigned long ulScdlPortCycles(void);
+
+#endif /* SCDL_PORT_H_ */
@@ -0,0 +1,252 @@
+/**************************************************************************************************
+  Filename:       scdl_port.c
+  Author:         $Author: Menz $
+
+  Description:    Scheduler port for POSIX hosts, used to run and simulate task sets on a PC.
+                  The tick is an ITIMER_REAL interval timer delivering SIGALRM, SIGUSR1 runs
+                  the urgent tasks. With SCDL_MULTI_INSTANCE a thread ticks all instances
+                  running in threads.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_port.c */
+
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <signal.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+
+#include "inc/scheduler.h"
+#include "scdl_port.h"
+
+#ifdef SCDL_MULTI_INSTANCE
+pthread_mutex_t g_tScdlPortLock;
+unsigned int g_uiScdlPortLockDepth = 0;
+/** the lock is created on first use, vScdlInit and task creation lock it before the tick runs */
+static pthread_once_t g_tScdlPortLockOnce = PTHREAD_ONCE_INIT;
+/** signaled on every tick, wakes sleeping instances */
+static pthread_cond_t g_tScdlPortTickCond = PTHREAD_COND_INITIALIZER;
+
+static void *pvScdlPortTickThread(void *pvArg)
+{
+	struct timespec tNext;
+
+	(void)pvArg;
+	clock_gettime(CLOCK_MONOTONIC, &tNext);
+
+	for(;;)
+	{
+		tNext.tv_nsec += (long)(SCDL_TICK_US % 1000000) * 1000;
+		tNext.tv_sec += SCDL_TICK_US / 1000000 + tNext.tv_nsec / 1000000000;
+		tNext.tv_nsec %= 1000000000;
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &tNext, 0);
+
+		vScdlPortLock();
+		vScdlTickAll();
+		pthread_cond_broadcast(&g_tScdlPortTickCond);
+		vScdlPortUnlock();
+	}
+
+	return 0;
+}
+
+static void *pvScdlPortInstanceThread(void *pvScdl)
+{
+	vScdlRun((scdlHandle_t)pvScdl);
+
+	return 0;
+}
+
+static void vScdlPortLockInit(void)
+{
+	pthread_mutexattr_t tAttr;
+
+	pthread_mutexattr_init(&tAttr);
+	pthread_mutexattr_settype(&tAttr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&g_tScdlPortLock, &tAttr);
+	pthread_mutexattr_destroy(&tAttr);
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlPortLock
+ *
+ * @brief	enter the critical section lock, recursive, created on the first call
+ *
+ */
+void vScdlPortLock(void)
+{
+	pthread_once(&g_tScdlPortLockOnce, vScdlPortLockInit);
+	pthread_mutex_lock(&g_tScdlPortLock);
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlPortUnlock
+ *
+ * @brief	leave the critical section lock
+ *
+ */
+void vScdlPortUnlock(void)
+{
+	pthread_mutex_unlock(&g_tScdlPortLock);
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlPortTickInit
+ *
+ * @brief	start the tick thread, the instances must be registered by vScdlInit before
+ *
+ */
+void vScdlPortTickInit(void)
+{
+	pthread_t tThread;
+
+	pthread_create(&tThread, 0, pvScdlPortTickThread, 0);
+	pthread_detach(tThread);
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlPortRunInstances
+ *
+ * @brief	run every instance in its own thread, the first one in the calling thread.
+ * 			vScdlPortTickInit must have been called before -> does not return!
+ *
+ * @param	phScdl array of instances
+ *
+ * 			ucNum number of instances
+ *
+ */
+void vScdlPortRunInstances(scdlHandle_t *phScdl, unsigned char ucNum)
+{
+	pthread_t tThread;
+	unsigned char i;
+
+	SCDL_ASSERT(ucNum > 0);
+
+	for(i = 1; i < ucNum; i++)
+	{
+		pthread_create(&tThread, 0, pvScdlPortInstanceThread, phScdl[i]);
+		pthread_detach(tThread);
+	}
+
+	vScdlRun(phScdl[0]);
+}
+#else
+sigset_t g_tScdlPortTickMask;
+
+static void vScdlPortTickHandler(int iSignal)
+{
+	(void)iSignal;
+	vScdlTick();
+}
+
+#ifdef SCDL_URGENT_TASKS
+/** set once the SIGUSR1 handler is installed, the default action would end the process */
+static volatile sig_atomic_t g_iScdlPortUrgentOn = 0;
+
+static void vScdlPortUrgentHandler(int iSignal)
+{
+	(void)iSignal;
+	vScdlUrgentDispatch();
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlPortPendUrgent
+ *
+ * @brief	request the urgent dispatch, ignored before vScdlPortTickInit
+ *
+ */
+void vScdlPortPendUrgent(void)
+{
+	if(g_iScdlPortUrgentOn)
+		raise(SIGUSR1);
+}
+#endif
+
+/*! **********************************************************************************
+ * @fn		vScdlPortTickInit
+ *
+ * @brief	install the SIGALRM handler and start an interval timer with SCDL_TICK_US
+ *
+ */
+void vScdlPortTickInit(void)
+{
+	struct sigaction tAction;
+	struct itimerval tTimer;
+
+	sigemptyset(&g_tScdlPortTickMask);
+	sigaddset(&g_tScdlPortTickMask, SIGALRM);
+#ifdef SCDL_URGENT_TASKS
+	sigaddset(&g_tScdlPortTickMask, SIGUSR1);
+
+	/* the urgent handler may be interrupted by the tick, SIGUSR1 itself stays blocked */
+	memset(&tAction, 0, sizeof(tAction));
+	tAction.sa_handler = vScdlPortUrgentHandler;
+	sigemptyset(&tAction.sa_mask);
+	tAction.sa_flags = SA_RESTART;
+	sigaction(SIGUSR1, &tAction, 0);
+	g_iScdlPortUrgentOn = 1;
+#endif
+
+	/* the tick blocks the urgent signal, it is delivered when the tick returns */
+	memset(&tAction, 0, sizeof(tAction));
+	tAction.sa_handler = vScdlPortTickHandler;
+	sigemptyset(&tAction.sa_mask);
+	sigaddset(&tAction.sa_mask, SIGUSR1);
+	tAction.sa_flags = SA_RESTART;
+	sigaction(SIGALRM, &tAction, 0);
+
+	tTimer.it_interval.tv_sec = SCDL_TICK_US / 1000000;
+	tTimer.it_interval.tv_usec = SCDL_TICK_US % 1000000;
+	tTimer.it_value = tTimer.it_interval;
+	setitimer(ITIMER_REAL, &tTimer, 0);
+}
+#endif
+
+/*! **********************************************************************************
+ * @fn		ulScdlPortCycles
+ *
+ * @brief	monotonic time in ns
+ *
+ * @return	ns, wraps with the width of unsigned long
+ */
+unsigned long ulScdlPortCycles(void)
+{
+	struct timespec tNow;
+
+	clock_gettime(CLOCK_MONOTONIC, &tNow);
+
+	return (unsigned long)tNow.tv_sec * 1000000000UL + (unsigned long)tNow.tv_nsec;
+}
+
+#ifdef SCDL_MULTI_INSTANCE
+/*! **********************************************************************************
+ * @fn		vScdlPortIdleSleep
+ *
+ * @brief	wait for the next tick, called with the lock held, returns with it released
+ *
+ */
+void vScdlPortIdleSleep(void)
+{
+	pthread_cond_wait(&g_tScdlPortTickCond, &g_tScdlPortLock);
+	SCDL_PORT_ENABLE_INTERRUPTS();
+}
+#else
+/*! **********************************************************************************
+ * @fn		vScdlPortIdleSleep
+ *
+ * @brief	wait for the next tick, called with SIGALRM blocked, returns with it unblocked
+ *
+ */
+void vScdlPortIdleSleep(void)
+{
+	sigset_t tWaitMask;
+
+	sigemptyset(&tWaitMask);
+	sigsuspend(&tWaitMask);
+	SCDL_PORT_ENABLE_INTERRUPTS();
+}
+#endif
@@ -0,0 +1,80 @@
+/*
+ * scdl_port.h
+ *
+ *  Scheduler port for POSIX hosts. SIGALRM from an interval timer is the tick
+ *  interrupt, blocking the signal is the critical section. SIGUSR1 raised by
+ *  the tick runs the urgent tasks.
+ *
+ *  With SCDL_MULTI_INSTANCE every instance runs in its own thread instead, a tick
+ *  thread calls vScdlTickAll and one recursive mutex shared by all instances is
+ *  the critical section, see vScdlPortRunInstances.
+ */
+
+/*! @file */
+
+#ifndef SCDL_PORT_H_
+#define SCDL_PORT_H_
+
+#include <signal.h>
+
+#include "inc/scdl_config.h"
+
+#ifdef SCDL_MULTI_INSTANCE
+#include <pthread.h>
+
+#include "inc/scheduler.h"
+
+extern pthread_mutex_t g_tScdlPortLock;
+extern unsigned int g_uiScdlPortLockDepth;
+
+#define SCDL_PORT_DISABLE_INTERRUPTS()	vScdlPortLock()
+#define SCDL_PORT_ENABLE_INTERRUPTS()	vScdlPortUnlock()
+
+/* nestable critical sections, s holds the nesting depth before entering */
+typedef unsigned int scdlIrqState_t;
+#define SCDL_PORT_ENTER_CRITICAL(s)		{ vScdlPortLock(); (s) = g_uiScdlPortLockDepth++; }
+#define SCDL_PORT_EXIT_CRITICAL(s)		{ g_uiScdlPortLockDepth = (s); vScdlPortUnlock(); }
+#define SCDL_PORT_IRQ_WAS_ENABLED(s)	((s) == 0)
+
+void vScdlPortLock(void);
+void vScdlPortUnlock(void);
+void vScdlPortRunInstances(scdlHandle_t *phScdl, unsigned char ucNum);
+#else
+extern sigset_t g_tScdlPortTickMask;
+
+#define SCDL_PORT_DISABLE_INTERRUPTS()	sigprocmask(SIG_BLOCK, &g_tScdlPortTickMask, 0)
+#define SCDL_PORT_ENABLE_INTERRUPTS()	sigprocmask(SIG_UNBLOCK, &g_tScdlPortTickMask, 0)
+
+/* nestable critical sections, the previous signal mask is saved in s */
+typedef sigset_t scdlIrqState_t;
+#define SCDL_PORT_ENTER_CRITICAL(s)		sigprocmask(SIG_BLOCK, &g_tScdlPortTickMask, &(s))
+#define SCDL_PORT_EXIT_CRITICAL(s)		sigprocmask(SIG_SETMASK, &(s), 0)
+#define SCDL_PORT_IRQ_WAS_ENABLED(s)	(!sigismember(&(s), SIGALRM))
+/* SIGUSR1 is the urgent software interrupt, blocked while the tick runs */
+#define SCDL_PORT_PEND_URGENT()			vScdlPortPendUrgent()
+#endif
+#define SCDL_PORT_IDLE_SLEEP()			vScdlPortIdleSleep()
+/* threads may run on several cores, orders the accesses of scdl_snapshot.c */
+#define SCDL_PORT_MEMORY_BARRIER()		__sync_synchronize()
+
+/** resolution of ulScdlPortCycles, the host counts nanoseconds */
+#define SCDL_PORT_CYCLES_PER_MS			(1000000UL)
+
+#ifdef SCDL_MEASURE_STACK
+/* the lowest SCDL_PORT_STACK_SIZE bytes of the main thread's stack are watched */
+#ifndef SCDL_PORT_STACK_SIZE
+#define SCDL_PORT_STACK_SIZE			(0x10000UL)
+#endif
+extern void *__libc_stack_end;
+#define SCDL_PORT_STACK_TOP				((unsigned char *)__libc_stack_end)
+#define SCDL_PORT_STACK_LIMIT			(SCDL_PORT_STACK_TOP - SCDL_PORT_STACK_SIZE)
+#endif
+
+void vScdlPortTickInit(void);
+unsigned long ulScdlPortCycles(void);
+void vScdlPortIdleSleep(void);
+#ifdef SCDL_URGENT_TASKS
+void vScdlPortPendUrgent(void);
+#endif
+
+#endif /* SCDL_PORT_H_ */
@@ -0,0 +1,71 @@
+/*
+ * scdl_boot.h
+ *
+ *  Staged boot of the default instance with boot time measurement.
+ *
+ *  main only brings up what the first tasks need and registers the rest of
+ *  the initialization as stages. Once the scheduler runs, a boot task of low
+ *  priority runs one stage per dispatch in the order of registration, tasks
+ *  of higher priority run in between. The first ready task starts right at
+ *  vStartScheduler instead of at the first tick.
+ *
+ *  	main:	vScdlBootInit();
+ *  			... clock, tick and what the first tasks need ...
+ *  			tidCreateTask(vTaskControl, SCDL_MS_TO_TICKS(1));
+ *  			vScdlBootDefer(InitConsole);
+ *  			vScdlBootStart(tidCreateTask(vTaskScdlBoot, SCDL_INF_PERIOD), vOnBootDone);
+ *  			vStartScheduler();
+ *
+ *  Times are cycles of ulScdlPortCycles from reset if the project starts the
+ *  counter in its reset handler and defines SCDL_PORT_CYCLES_FROM_RESET,
+ *  otherwise from vScdlBootInit.
+ */
+
+/*! @file */
+
+#ifndef SCDL_BOOT_H_
+#define SCDL_BOOT_H_
+
+#include "inc/scheduler.h"
+#include "scdl_port.h"
+
+/** most deferred stages */
+#ifndef SCDL_BOOT_MAX_STAGES
+#define SCDL_BOOT_MAX_STAGES	(8)
+#endif
+
+/** cycles of struct typScdlBootTimes to us */
+#define SCDL_BOOT_CYCLES_TO_US(c)	((unsigned long)((unsigned long long)(c) * 1000 / SCDL_PORT_CYCLES_PER_MS))
+
+/*!
+ * boot times in cycles, see vScdlBootGetTimes
+ */
+struct typScdlBootTimes
+{
+	/** to vScdlBootInit, the C start-up, 0 without SCDL_PORT_CYCLES_FROM_RESET */
+	unsigned long ulMain;
+	/** to vScdlBootStart, the initialization left in main */
+	unsigned long ulStart;
+	/** to the start of the first task, 0 before */
+	unsigned long ulFirstTask;
+	/** to the end of the last stage, 0 while stages are pending */
+	unsigned long ulInitialized;
+	/** run time of each stage */
+	unsigned long aulStage[SCDL_BOOT_MAX_STAGES];
+	/** stages registered and completed */
+	unsigned char ucStages;
+	unsigned char ucDone;
+};
+
+typedef void (*tScdlBootStage)(void);
+typedef void (*tScdlBootDone)(const struct typScdlBootTimes *ptTimes);
+
+void vScdlBootInit(void);
+void vScdlBootDefer(tScdlBootStage pfnStage);
+void vScdlBootStart(taskID_t tidBoot, tScdlBootDone pfnDone);
+void vScdlBootGetTimes(struct typScdlBootTimes *ptTimes);
+
+void vTaskScdlBoot(void);
+void vScdlBootFirstTask(void);
+
+#endif /* SCDL_BOOT_H_ */
@@ -0,0 +1,38 @@
+/*
+ * scdl_critical.h
+ *
+ *  Nestable critical sections for tasks, ISRs and scheduler internals.
+ *
+ *  	scdlIrqState_t s;
+ *  	SCDL_ENTER_CRITICAL(s);
+ *  	...
+ *  	SCDL_EXIT_CRITICAL(s);
+ *
+ *  With SCDL_MEASURE_IRQ_OFF the longest time interrupts were masked by an
+ *  outermost critical section is recorded, see ulScdlGetMaxIrqOff.
+ */
+
+/*! @file */
+
+#ifndef SCDL_CRITICAL_H_
+#define SCDL_CRITICAL_H_
+
+#include "inc/scheduler.h"
+#include "scdl_port.h"
+
+#ifdef SCDL_MEASURE_IRQ_OFF
+extern unsigned long g_ulScdlIrqOffStart;
+void vScdlIrqOffEnd(void);
+
+#define SCDL_ENTER_CRITICAL(s)	{	SCDL_PORT_ENTER_CRITICAL(s);							\
+									if(SCDL_PORT_IRQ_WAS_ENABLED(s))						\
+										g_ulScdlIrqOffStart = ulScdlPortCycles(); }
+#define SCDL_EXIT_CRITICAL(s)	{	if(SCDL_PORT_IRQ_WAS_ENABLED(s))						\
+										vScdlIrqOffEnd();									\
+									SCDL_PORT_EXIT_CRITICAL(s); }
+#else
+#define SCDL_ENTER_CRITICAL(s)	SCDL_PORT_ENTER_CRITICAL(s)
+#define SCDL_EXIT_CRITICAL(s)	SCDL_PORT_EXIT_CRITICAL(s)
+#endif
+
+#endif /* SCDL_CRITICAL_H_ */
@@ -0,0 +1,61 @@
+/*
+ * scdl_pool.h
+ *
+ *  Fixed-block memory pools, O(1) and usable from tasks and ISRs.
+ *
+ *  Free blocks form a singly linked list through their first word, so a pool
+ *  has no overhead per block and never fragments. Every pool keeps its current
+ *  and peak usage and the number of failed allocations for sizing.
+ *
+ *  	SCDL_POOL_STORAGE(g_aulMsgMem, 32, 8);
+ *  	static struct typScdlPool g_tMsgPool;
+ *
+ *  	vScdlPoolInit(&g_tMsgPool, g_aulMsgMem, 32, 8);
+ *  	pvMsg = pvScdlPoolAlloc(&g_tMsgPool);
+ *  	...
+ *  	vScdlPoolFree(&g_tMsgPool, pvMsg);
+ */
+
+/*! @file */
+
+#ifndef SCDL_POOL_H_
+#define SCDL_POOL_H_
+
+#include "inc/scheduler.h"
+
+/** block size rounded up to hold and align the free list pointer */
+#define SCDL_POOL_BLOCK_SIZE(size)	((((size) < sizeof(void *) ? sizeof(void *) : (size))		\
+									  + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+/** aligned storage for num blocks of size bytes */
+#define SCDL_POOL_STORAGE(name,size,num)															\
+		static void *name[(SCDL_POOL_BLOCK_SIZE(size) * (num)) / sizeof(void *)]
+
+/*!
+ * pool, members are private to scdl_pool.c, use the getters
+ */
+struct typScdlPool
+{
+	/** first free block, its first word links to the next one */
+	void *pvFree;
+	/** start and end of the storage, for checks of freed blocks */
+	unsigned char *pucStart;
+	unsigned char *pucEnd;
+	unsigned short usBlockSize;
+	unsigned short usNumBlocks;
+	/** blocks in use, most blocks ever in use */
+	unsigned short usUsed;
+	unsigned short usPeak;
+	/** allocations that found the pool empty */
+	unsigned short usFailed;
+};
+
+void vScdlPoolInit(struct typScdlPool *ptPool, void *pvMem, unsigned short usSize, unsigned short usNumBlocks);
+void *pvScdlPoolAlloc(struct typScdlPool *ptPool);
+void vScdlPoolFree(struct typScdlPool *ptPool, void *pvBlock);
+
+unsigned short usScdlPoolGetUsed(struct typScdlPool *ptPool);
+unsigned short usScdlPoolGetPeak(struct typScdlPool *ptPool);
+unsigned short usScdlPoolGetFailed(struct typScdlPool *ptPool);
+void vScdlPoolResetStats(struct typScdlPool *ptPool);
+
+#endif /* SCDL_POOL_H_ */
@@ -0,0 +1,54 @@
+/*
+ * scdl_snapshot.h
+ *
+ *  Tear-free snapshots of multi-word data written by an ISR and read by tasks.
+ *
+ *  The writer bumps a sequence counter before and after it copies the new
+ *  data, readers copy and retry while the counter was odd or has changed.
+ *  Writers never wait and readers do not mask interrupts, only a reader
+ *  overrun SCDL_SNAPSHOT_RETRIES times in a row takes its copy in a critical
+ *  section. There is one writer per snapshot, it must not be preempted by a
+ *  reader of the same snapshot.
+ *
+ *  	static struct typAdc tAdc;
+ *  	static struct typScdlSnapshot tAdcSnap;
+ *  	vScdlSnapshotInit(&tAdcSnap, &tAdc, sizeof(tAdc));
+ *
+ *  	ISR:	vScdlSnapshotWrite(&tAdcSnap, &tNewSample);
+ *  	task:	vScdlSnapshotRead(&tAdcSnap, &tCopy);
+ */
+
+/*! @file */
+
+#ifndef SCDL_SNAPSHOT_H_
+#define SCDL_SNAPSHOT_H_
+
+#include "inc/scheduler.h"
+
+/** optimistic reads before a reader falls back to a critical section */
+#ifndef SCDL_SNAPSHOT_RETRIES
+#define SCDL_SNAPSHOT_RETRIES	(4)
+#endif
+
+/*!
+ * snapshot of caller provided data, members are private to scdl_snapshot.c
+ */
+struct typScdlSnapshot
+{
+	/** odd while the writer updates the data, native width to be read in one access */
+	volatile unsigned int uiSeq;
+	/** the shared data, only accessed by the snapshot functions */
+	void *pvData;
+	unsigned short usSize;
+	/** reads repeated because of a write, and reads taken in a critical section */
+	unsigned short usRetries;
+	unsigned short usLocked;
+};
+
+void vScdlSnapshotInit(struct typScdlSnapshot *ptSnap, void *pvData, unsigned short usSize);
+void vScdlSnapshotWrite(struct typScdlSnapshot *ptSnap, const void *pvSrc);
+void vScdlSnapshotRead(struct typScdlSnapshot *ptSnap, void *pvDst);
+unsigned short usScdlSnapshotGetRetries(struct typScdlSnapshot *ptSnap);
+unsigned short usScdlSnapshotGetLocked(struct typScdlSnapshot *ptSnap);
+
+#endif /* SCDL_SNAPSHOT_H_ */
@@ -0,0 +1,35 @@
+/*
+ * scdl_stack.h
+ *
+ *  Stack usage of the shared stack, enabled by SCDL_MEASURE_STACK.
+ *
+ *  All tasks and ISRs run on one stack between the port's SCDL_PORT_STACK_LIMIT
+ *  and SCDL_PORT_STACK_TOP. The free part is painted with SCDL_STACK_PATTERN,
+ *  after every task the scheduler looks for the deepest overwritten word and
+ *  paints the part used by the task again, so each task gets its own peak.
+ *  Interrupts hitting a task are counted for that task.
+ */
+
+/*! @file */
+
+#ifndef SCDL_STACK_H_
+#define SCDL_STACK_H_
+
+#include "inc/scheduler.h"
+
+/** fill word of the unused stack */
+#define SCDL_STACK_PATTERN		((unsigned int)0xA5A5A5A5UL)
+/** bytes below the measuring function left unpainted for its own frame,
+    per task depths are upper bounds by about this much */
+#ifndef SCDL_STACK_MARGIN
+#define SCDL_STACK_MARGIN		(16 * sizeof(void *))
+#endif
+
+void vScdlStackPaint(void);
+void vScdlStackTaskDone(taskID_t taskID, unsigned char *pucBase);
+
+unsigned long ulScdlStackGetSize(void);
+unsigned long ulScdlStackGetPeak(void);
+unsigned short usScdlTaskGetStackPeak(taskID_t taskID);
+
+#endif /* SCDL_STACK_H_ */
@@ -0,0 +1,66 @@
+/*
+ * scdl_timer.h
+ *
+ *  One-shot and periodic callback timers without a task slot per timer.
+ *
+ *  All timers are serviced by one task running vTaskScdlTimers, the tick only
+ *  makes it READY when a timer may expire. Timers sit in a wheel of
+ *  SCDL_TIMER_WHEEL_SIZE doubly linked lists indexed by the expiry time, so
+ *  start and stop are O(1) and the service only visits timers of due slots.
+ *
+ *  	static struct typScdlTimer tBlink;
+ *  	vScdlTimerStart(&tBlink, SCDL_MS_TO_TICKS(2000), 0, vOnBlink, 0);
+ */
+
+/*! @file */
+
+#ifndef SCDL_TIMER_H_
+#define SCDL_TIMER_H_
+
+#include "inc/scheduler.h"
+
+/** number of wheel slots as power of 2, more slots mean fewer timers to check per tick */
+#ifndef SCDL_TIMER_WHEEL_BITS
+#define SCDL_TIMER_WHEEL_BITS	(4)
+#endif
+#define SCDL_TIMER_WHEEL_SIZE	(1 << SCDL_TIMER_WHEEL_BITS)
+
+/** timer callback, called from the timer service task */
+typedef void (*tScdlTimerCallback)(void *pvArg);
+
+/*!
+ * list link, the first member of a timer
+ */
+struct typScdlTimerLink
+{
+	struct typScdlTimerLink *ptNext;
+	struct typScdlTimerLink *ptPrev;
+};
+
+/*!
+ * timer, memory is provided by the caller, members are private to scdl_timer.c
+ */
+struct typScdlTimer
+{
+	/** link in a wheel slot, ptNext is 0 while the timer is stopped */
+	struct typScdlTimerLink tLink;
+	/** tick of the next expiry */
+	scdlTicks_t ulExpiry;
+	/** reload in ticks, 0 for a one-shot timer */
+	unsigned long ulPeriod;
+	/** function called on expiry */
+	tScdlTimerCallback pfnCallback;
+	/** argument of pfnCallback */
+	void *pvArg;
+};
+
+void vScdlTimerInit(taskID_t tidService);
+void vScdlTimerStart(struct typScdlTimer *ptTimer, unsigned long ulDelay, unsigned long ulPeriod,
+		tScdlTimerCallback pfnCallback, void *pvArg);
+void vScdlTimerStop(struct typScdlTimer *ptTimer);
+unsigned char ucScdlTimerIsActive(struct typScdlTimer *ptTimer);
+
+void vTaskScdlTimers(void);
+void vScdlTimerTick(scdlTicks_t ulNow);
+
+#endif /* SCDL_TIMER_H_ */
@@ -0,0 +1,98 @@
+/*
+ * scdl_topic.h
+ *
+ *  Zero-copy publish/subscribe between tasks and from ISRs to tasks.
+ *
+ *  A topic owns a few preallocated slots of one sample each. The producer
+ *  claims a free slot, fills it in place and publishes it, which makes it the
+ *  latest sample and sets every subscribed task READY. A subscriber gets a
+ *  reference to the latest sample and keeps it until its next get or release,
+ *  the slot is not reused meanwhile. Subscribers only see the latest sample,
+ *  samples published before a subscriber got the previous one are counted as
+ *  missed. With subscribers + 2 slots a claim never fails.
+ *
+ *  	SCDL_TOPIC_STORAGE(g_aulAdcMem, sizeof(struct typAdc), 4);
+ *  	static struct typScdlTopic g_tAdcTopic;
+ *  	static struct typScdlSubscriber g_tFilterSub;
+ *
+ *  	vScdlTopicInit(&g_tAdcTopic, g_aulAdcMem, sizeof(struct typAdc), 4);
+ *  	vScdlTopicSubscribe(&g_tAdcTopic, &g_tFilterSub, TID_FILTER);
+ *
+ *  	producer:	ptAdc = pvScdlTopicClaim(&g_tAdcTopic);
+ *  				... fill *ptAdc ...
+ *  				vScdlTopicPublish(&g_tAdcTopic, ptAdc);
+ *
+ *  	TID_FILTER:	ptAdc = pvScdlTopicGet(&g_tAdcTopic, &g_tFilterSub);
+ *  				if(ptAdc) ...
+ */
+
+/*! @file */
+
+#ifndef SCDL_TOPIC_H_
+#define SCDL_TOPIC_H_
+
+#include "inc/scheduler.h"
+
+/** most slots of a topic */
+#ifndef SCDL_TOPIC_MAX_SLOTS
+#define SCDL_TOPIC_MAX_SLOTS	(8)
+#endif
+#if (SCDL_TOPIC_MAX_SLOTS >= SCDL_NA)
+#error SCDL_TOPIC_MAX_SLOTS must be less than SCDL_NA
+#endif
+
+/** slot size rounded up to keep every slot pointer aligned */
+#define SCDL_TOPIC_SLOT_SIZE(size)	(((size) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+/** aligned storage for num slots of size bytes */
+#define SCDL_TOPIC_STORAGE(name,size,num)															\
+		static void *name[(SCDL_TOPIC_SLOT_SIZE(size) * (num)) / sizeof(void *)]
+
+/*!
+ * subscription of a task of the default instance, memory is provided by the caller,
+ * members are private to scdl_topic.c
+ */
+struct typScdlSubscriber
+{
+	struct typScdlSubscriber *ptNext;
+	/** task set READY on every publication */
+	taskID_t tidTask;
+	/** slot referenced by the last get, SCDL_NA if none */
+	unsigned char ucHeld;
+	/** publication count at the last get */
+	unsigned short usSeen;
+};
+
+/*!
+ * topic, members are private to scdl_topic.c, use the getters
+ */
+struct typScdlTopic
+{
+	unsigned char *pucSlots;
+	unsigned short usSlotSize;
+	unsigned char ucNumSlots;
+	/** slot of the latest sample, SCDL_NA before the first publication */
+	unsigned char ucLatest;
+	/** references of each slot: being the latest, claimed by the producer, held by subscribers */
+	unsigned char aucRefs[SCDL_TOPIC_MAX_SLOTS];
+	/** publications, wraps */
+	unsigned short usSeq;
+	struct typScdlSubscriber *ptSubscribers;
+	/** samples replaced before a subscriber got them, claims that found no free slot */
+	unsigned short usMissed;
+	unsigned short usNoSlot;
+};
+
+void vScdlTopicInit(struct typScdlTopic *ptTopic, void *pvMem, unsigned short usSize, unsigned char ucNumSlots);
+void vScdlTopicSubscribe(struct typScdlTopic *ptTopic, struct typScdlSubscriber *ptSub, taskID_t tidTask);
+
+void *pvScdlTopicClaim(struct typScdlTopic *ptTopic);
+void vScdlTopicPublish(struct typScdlTopic *ptTopic, void *pvSample);
+
+const void *pvScdlTopicGet(struct typScdlTopic *ptTopic, struct typScdlSubscriber *ptSub);
+void vScdlTopicRelease(struct typScdlTopic *ptTopic, struct typScdlSubscriber *ptSub);
+
+unsigned short usScdlTopicGetMissed(struct typScdlTopic *ptTopic);
+unsigned short usScdlTopicGetNoSlot(struct typScdlTopic *ptTopic);
+void vScdlTopicResetStats(struct typScdlTopic *ptTopic);
+
+#endif /* SCDL_TOPIC_H_ */
@@ -0,0 +1,459 @@
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+/*! @file */
+
+/* project specific settings, every project provides its own inc/scdl_config.h */
+#include "inc/scdl_config.h"
+
+/** tick period in us, the port's tick source runs at this rate */
+#ifndef SCDL_TICK_US
+#define SCDL_TICK_US			(1000UL)
+#endif
+#if (SCDL_TICK_US == 0)
+#error SCDL_TICK_US must not be 0
+#endif
+
+/** us to ticks rounded to the nearest tick, folded at compile time for constants */
+#define SCDL_US_TO_TICKS(us)	(((unsigned long)(us) + SCDL_TICK_US / 2) / SCDL_TICK_US)
+/** ms to ticks, avoids the multiplication by 1000 where possible */
+#if (1000 % SCDL_TICK_US) == 0
+#define SCDL_MS_TO_TICKS(ms)	((unsigned long)(ms) * (1000 / SCDL_TICK_US))
+#elif (SCDL_TICK_US % 1000) == 0
+#define SCDL_MS_TO_TICKS(ms)	(((unsigned long)(ms) + SCDL_TICK_US / 2000) / (SCDL_TICK_US / 1000))
+#else
+#define SCDL_MS_TO_TICKS(ms)	SCDL_US_TO_TICKS((unsigned long)(ms) * 1000)
+#endif
+#define SCDL_TICKS_TO_US(t)		((unsigned long)(t) * SCDL_TICK_US)
+/**
+ * period in us to ticks, keeps SCDL_INF_PERIOD. Periods shorter than a tick give 0,
+ * which task creation and vTaskSetPeriod reject and a static task table fails on.
+ */
+#define SCDL_PERIOD_US(us)		((unsigned long)(us) == SCDL_INF_PERIOD ? SCDL_INF_PERIOD :		\
+								 (unsigned long)(us) < SCDL_TICK_US ? 0 : SCDL_US_TO_TICKS(us))
+
+/*
+ * The tick counter runs freely and wraps, times are compared with serial number
+ * arithmetic, so periods and delays are limited to half the counter range.
+ */
+typedef unsigned long scdlTicks_t;
+/** 1 if time t has been reached at time now, valid as long as they are less than 2^31 ticks apart */
+#define SCDL_TIME_REACHED(now,t)	((signed long)((scdlTicks_t)(now) - (scdlTicks_t)(t)) >= 0)
+/** same for the low 16 bits, cheap on 16 bit cpus for timeouts below 2^15 ticks */
+#define SCDL_TIME16_REACHED(now,t)	((signed short)((unsigned short)(now) - (unsigned short)(t)) >= 0)
+
+#define SCDL_MAX_TASK_PERIOD	(0x7FFFFFFF)
+#ifndef SCDL_MAX_NUM_TASKS
+#define SCDL_MAX_NUM_TASKS		(12)
+#endif
+#define SCDL_INF_PERIOD			(0xFFFFFFFF)
+#define SCDL_NA					(0xFF)	
+#if	(SCDL_MAX_NUM_TASKS > SCDL_NA)
+#error SCDL_MAX_NUM_TASKS > SCDL_NA
+#endif
+
+/** compile time check, fails with a negative array size */
+#define SCDL_STATIC_ASSERT(name,x)	typedef char name[(x) ? 1 : -1]
+
+
+#ifdef SCDL_ASSERTS_ON
+#define SCDL_ASSERT(x)	if(!(x))  while(1);
+#else
+#define SCDL_ASSERT(x)	{ }
+#endif
+
+typedef unsigned char sema_t;
+typedef unsigned char taskID_t;
+
+#define SEMAPHORE_TAKE(s)	bSemaTake(&(s))
+#define SEMAPHORE_GIVE(s)	((s)=1)
+
+#define SEMAPHORE_CNT_GIVE(s)	((s)+=1)
+#define SEMAPHORE_CNT_TAKE(s)	bSemaCntTake(&(s))
+
+enum etypTaskStates{
+	OFF = 0,
+	READY,
+	ACTIVE,
+	BLOCKED
+};
+
+/*
+ * Hooks for tracing, statistics and profiling backends. A project defines the
+ * ones it needs in scdl_config.h, usually as call of an inline function from the
+ * header named by SCDL_HOOKS_INCLUDE, all others compile to nothing. Hooks run
+ * where the event happens: task start, stop and idle in vScdlRun or the urgent
+ * dispatch, the tick in the tick ISR, state changes in tasks and ISRs with
+ * interrupts disabled. They must be short and must not call the scheduler.
+ *
+ * 	#define SCDL_HOOKS_INCLUDE				"inc/trace.h"
+ * 	#define SCDL_HOOK_TASK_START(h,id)		vTraceTaskStart(id)
+ */
+#ifndef SCDL_HOOK_TASK_START
+/** before the task function of id is called */
+#define SCDL_HOOK_TASK_START(h,id)			{ }
+#endif
+#ifndef SCDL_HOOK_TASK_STOP
+/** after the task function of id returned */
+#define SCDL_HOOK_TASK_STOP(h,id)			{ }
+#endif
+#ifndef SCDL_HOOK_IDLE_ENTER
+/** the instance found no ready task, before it steals or sleeps */
+#define SCDL_HOOK_IDLE_ENTER(h)				{ }
+#endif
+#ifndef SCDL_HOOK_IDLE_EXIT
+/** the first task after idle is about to start */
+#define SCDL_HOOK_IDLE_EXIT(h)				{ }
+#endif
+#ifndef SCDL_HOOK_TICK
+/** tick of the instance, after the tick counter was incremented */
+#define SCDL_HOOK_TICK(h)					{ }
+#endif
+#ifndef SCDL_HOOK_TASK_STATE
+/** the state of task id was set to s */
+#define SCDL_HOOK_TASK_STATE(h,id,s)		{ }
+#endif
+
+#if defined(SCDL_STATIC_TASKS) && defined(SCDL_MULTI_INSTANCE)
+#error SCDL_STATIC_TASKS describes the task set of the default instance only
+#endif
+#if defined(SCDL_WORK_STEALING) && !defined(SCDL_MULTI_INSTANCE)
+#error SCDL_WORK_STEALING requires SCDL_MULTI_INSTANCE
+#endif
+#if defined(SCDL_URGENT_TASKS) && defined(SCDL_MULTI_INSTANCE)
+#error SCDL_URGENT_TASKS are dispatched by the default instance only
+#endif
+#if defined(SCDL_URGENT_TASKS) && defined(SCDL_EDF)
+#error SCDL_URGENT_TASKS would bypass the deadline order of SCDL_EDF
+#endif
+#if defined(SCDL_AUTO_PRIO) && defined(SCDL_EDF)
+#error SCDL_AUTO_PRIO orders fixed priorities, SCDL_EDF has none
+#endif
+
+#if defined(SCDL_TASK_CHAINS) || defined(SCDL_MODES)
+/** set of tasks of one instance, bit n for task ID n */
+#if (SCDL_MAX_NUM_TASKS <= 16)
+typedef unsigned short scdlTaskMask_t;
+#elif (SCDL_MAX_NUM_TASKS <= 32)
+typedef unsigned long scdlTaskMask_t;
+#else
+#error SCDL_TASK_CHAINS and SCDL_MODES support up to 32 tasks
+#endif
+#define SCDL_TASK_BIT(id)		((scdlTaskMask_t)1 << (id))
+#define SCDL_ALL_TASKS			((scdlTaskMask_t)~0)
+#endif
+
+#ifdef SCDL_MODES
+/*!
+ * operating mode, usually a const object defined by the application
+ */
+struct typScdlMode
+{
+	/** tasks that run in this mode, SCDL_TASK_BIT of each */
+	scdlTaskMask_t tTasks;
+	/** period of each task ID in this mode, 0 keeps the task's own period, 0 pointer for all */
+	const unsigned long *pulPeriods;
+};
+/** all tasks with their own periods, the mode before the first switch */
+#define SCDL_MODE_ALL			((const struct typScdlMode *)0)
+#endif
+
+#ifdef SCDL_STATIC_TASKS
+/*
+ * Static task set, defined in scdl_config.h in priority order:
+ *
+ * #define SCDL_TASK_TABLE(TASK)	TASK(TID_LED, vTaskLED, SCDL_MS_TO_TICKS(500))	\
+ * 									TASK(TID_RX, vTaskRX, SCDL_INF_PERIOD)
+ *
+ * Task functions and, with SCDL_CONST_PERIODS, periods go to a const table,
+ * only state and start time stay in RAM. The IDs are enum constants, tasks
+ * start READY and must not be declared static.
+ */
+#define SCDL_TASK_ENUM(id,f,p)		id,
+#define SCDL_TASK_PROTO(id,f,p)		void f(void);
+#define SCDL_TASK_CHECK(id,f,p)		SCDL_STATIC_ASSERT(scdlCheckPeriod_##id,					\
+										((p) > 0 && (p) <= SCDL_MAX_TASK_PERIOD) || (p) == SCDL_INF_PERIOD);
+
+enum etypStaticTaskIDs { SCDL_TASK_TABLE(SCDL_TASK_ENUM) SCDL_NUM_STATIC_TASKS };
+SCDL_TASK_TABLE(SCDL_TASK_PROTO)
+SCDL_TASK_TABLE(SCDL_TASK_CHECK)
+SCDL_STATIC_ASSERT(scdlCheckNumTasks, SCDL_NUM_STATIC_TASKS > 0 && SCDL_NUM_STATIC_TASKS <= SCDL_MAX_NUM_TASKS);
+/** compile time check of a task ID used as a constant */
+#define SCDL_CHECK_TASK_ID(id)		SCDL_STATIC_ASSERT(scdlCheckID_##id, (id) < SCDL_NUM_STATIC_TASKS)
+#endif
+
+/*!
+ * structure representing a task handle, the task ID is the index in the task list.
+ * With SCDL_STATIC_TASKS only the members changing at runtime are kept here.
+ */
+struct typTask
+{
+	/** next start time for taks, when blocked by time */
+	scdlTicks_t ulNextStartTime;
+#if !(defined(SCDL_STATIC_TASKS) && defined(SCDL_CONST_PERIODS))
+	/** Task period in ticks */
+	unsigned long ulTaskPeriod;
+#endif
+#ifndef SCDL_STATIC_TASKS
+	/** Task function */
+	void (*vTaskFunc)(void);
+#endif
+	/** Task state @see etypTaskStates */
+	volatile enum etypTaskStates eTaskState;
+#ifdef SCDL_EDF
+	/** absolute deadline of the current release */
+	scdlTicks_t ulDeadline;
+#endif
+#if defined(SCDL_EDF) || defined(SCDL_AUTO_PRIO)
+	/** deadline relative to the release in ticks, 0 for the period */
+	unsigned long ulRelDeadline;
+#endif
+#ifdef SCDL_EDF
+	/** index in the ready heap while READY */
+	unsigned char ucHeapPos;
+#endif
+#ifdef SCDL_URGENT_TASKS
+	/** 1 if the task is dispatched from the urgent software interrupt */
+	unsigned char bUrgent;
+#endif
+#ifdef SCDL_TASK_CHAINS
+	/** tasks released when this one completes */
+	scdlTaskMask_t tSuccessors;
+	/** predecessors that must all complete before this task is released */
+	scdlTaskMask_t tPredecessors;
+	/** predecessors completed since the last release */
+	scdlTaskMask_t tPredDone;
+#endif
+};
+
+/*!
+ * scheduler instance, holds all task handles and the time of one scheduler.
+ * Allocated by the application, members are private to scheduler.c.
+ */
+struct typScheduler
+{
+	/** ID of the current active task.*/
+	volatile unsigned char tidActiveTask;
+#ifndef SCDL_STATIC_TASKS
+	/** Number of Tasks created.*/
+	unsigned char ucNumTasks;
+#endif
+	/** tick counter of this instance */
+	volatile scdlTicks_t ulSystemTicks;
+#ifdef SCDL_STATIC_TASKS
+	/** Array of Task Handles, initialized from SCDL_TASK_TABLE */
+	struct typTask atTask[SCDL_NUM_STATIC_TASKS];
+#else
+	/** Array of Task Handles */
+	struct typTask atTask[SCDL_MAX_NUM_TASKS];
+#endif
+#ifdef SCDL_EDF
+	/** READY tasks as binary min heap on the absolute deadline */
+	taskID_t atidReadyHeap[SCDL_MAX_NUM_TASKS];
+	/** number of READY tasks */
+	unsigned char ucNumReady;
+#endif
+#ifdef SCDL_AUTO_PRIO
+	/** task IDs from highest to lowest priority */
+	taskID_t atidPrioOrder[SCDL_MAX_NUM_TASKS];
+#endif
+#ifdef SCDL_MULTI_INSTANCE
+	/** next instance registered by vScdlInit */
+	struct typScheduler *ptNext;
+#endif
+#ifdef SCDL_WORK_STEALING
+	/** 1 if idle instances may run ready tasks of this one */
+	unsigned char bStealable;
+#endif
+#ifdef SCDL_MODES
+	/** mode in effect */
+	const struct typScdlMode *ptMode;
+	/** mode requested by vScdlSetMode, taken over by the next tick if bModeSwitch is set */
+	const struct typScdlMode *ptNextMode;
+	volatile unsigned char bModeSwitch;
+#endif
+};
+
+typedef struct typScheduler *scdlHandle_t;
+
+/*
+ * Every image has a default instance, the functions without handle work on it.
+ * With SCDL_MULTI_INSTANCE further instances can be run by other cores or
+ * threads, each instance needs its own tick, see vScdlTickOf and vScdlTickAll.
+ */
+extern struct typScheduler g_tScdlDefault;
+#define SCDL_DEFAULT				(&g_tScdlDefault)
+
+#ifdef SCDL_MULTI_INSTANCE
+void vScdlInit(scdlHandle_t hScdl);
+void vScdlTickAll(void);
+#endif
+#ifdef SCDL_WORK_STEALING
+void vScdlSetStealable(scdlHandle_t hScdl, unsigned char bStealable);
+#endif
+#ifndef SCDL_STATIC_TASKS
+void vScdlReset(scdlHandle_t hScdl);
+taskID_t tidScdlCreateTask(scdlHandle_t hScdl, void (*vTaskFunc)(void), unsigned long ulPeriod);
+#endif
+void vScdlRun(scdlHandle_t hScdl);
+void vScdlTickOf(scdlHandle_t hScdl);
+void vScdlTaskSetState(scdlHandle_t hScdl, taskID_t taskID, enum etypTaskStates eState);
+void vScdlSwitchAllTasksOff(scdlHandle_t hScdl);
+#if !(defined(SCDL_STATIC_TASKS) && defined(SCDL_CONST_PERIODS))
+void vScdlTaskSetPeriod(scdlHandle_t hScdl, taskID_t taskID, unsigned long ulPeriod);
+#endif
+void vScdlTaskInvokeDelayed(scdlHandle_t hScdl, taskID_t taskID, unsigned long ulDelay);
+scdlTicks_t ulScdlGetTicksOf(scdlHandle_t hScdl);
+unsigned short usScdlGetTicks16Of(scdlHandle_t hScdl);
+
+#ifdef SCDL_EDF
+/*
+ * Non preemptive earliest deadline first: the ready task with the earliest absolute
+ * deadline (release + relative deadline) is started, equal deadlines in task ID
+ * order. Without an explicit deadline it is the period, tasks with SCDL_INF_PERIOD
+ * get deadline 0 and run as soon as possible.
+ */
+#endif
+#ifdef SCDL_AUTO_PRIO
+/*
+ * Deadline monotonic priorities instead of the creation order: the shorter the
+ * relative deadline the higher the priority, equal deadlines in task ID order.
+ * Without explicit deadlines the deadline is the period, which gives rate
+ * monotonic priorities. Tasks with SCDL_INF_PERIOD come last. The order follows
+ * vTaskSetPeriod and vTaskSetDeadline.
+ */
+#endif
+#if defined(SCDL_EDF) || defined(SCDL_AUTO_PRIO)
+void vScdlTaskSetDeadline(scdlHandle_t hScdl, taskID_t taskID, unsigned long ulDeadline);
+#define vTaskSetDeadline(id,d)			vScdlTaskSetDeadline(SCDL_DEFAULT, (id), (d))
+#endif
+
+/*
+ * Release phases: tasks created at the same time are released on the same tick
+ * and again at every common multiple of their periods. A phase offset delays
+ * the first release, vScdlAutoPhase chooses the offsets so that as few tasks
+ * as possible are released together. Call both before vStartScheduler.
+ */
+void vScdlTaskSetPhase(scdlHandle_t hScdl, taskID_t taskID, unsigned long ulPhase);
+#ifdef SCDL_AUTO_PHASE
+void vScdlAutoPhase(scdlHandle_t hScdl);
+unsigned char ucScdlPeakReleases(scdlHandle_t hScdl, unsigned long ulWindow);
+#endif
+
+#ifdef SCDL_URGENT_TASKS
+/*
+ * Urgent tasks are released like all others but run from a low priority software
+ * interrupt of the port (SCDL_PORT_PEND_URGENT), so they preempt the cooperative
+ * task running in vStartScheduler. Urgent tasks do not preempt each other and
+ * ordinary tasks still never preempt anything. Data shared between an urgent
+ * and an ordinary task must be protected by SCDL_ENTER_CRITICAL.
+ */
+void vScdlTaskSetUrgent(scdlHandle_t hScdl, taskID_t taskID, unsigned char bUrgent);
+void vScdlUrgentDispatch(void);
+#define vTaskSetUrgent(id,b)			vScdlTaskSetUrgent(SCDL_DEFAULT, (id), (b))
+#endif
+
+#ifdef SCDL_MODES
+/*
+ * Operating modes: a mode selects the tasks that run and may override their
+ * periods. vScdlSetMode only stores the request and returns at once, from tasks
+ * and ISRs. The next tick switches the whole task set before it releases or
+ * starts anything: READY tasks outside the new mode are switched OFF and are not
+ * made READY again while it is in effect, periodic tasks entering the mode are
+ * released on this tick. A task running at the switch completes, no other task
+ * of the old mode starts afterwards. Priorities of SCDL_AUTO_PRIO follow the
+ * tasks' own periods.
+ *
+ * 	static const unsigned long g_aulSavePeriods[SCDL_MAX_NUM_TASKS] = { SCDL_MS_TO_TICKS(2000) };
+ * 	static const struct typScdlMode g_tModeSave = { SCDL_TASK_BIT(TID_LED) | SCDL_TASK_BIT(TID_RX), g_aulSavePeriods };
+ * 	...
+ * 	vSetMode(&g_tModeSave);
+ */
+void vScdlSetMode(scdlHandle_t hScdl, const struct typScdlMode *ptMode);
+const struct typScdlMode *ptScdlGetMode(scdlHandle_t hScdl);
+#define vSetMode(m)						vScdlSetMode(SCDL_DEFAULT, (m))
+#define ptGetMode()						ptScdlGetMode(SCDL_DEFAULT)
+#endif
+
+#ifdef SCDL_TASK_CHAINS
+/*
+ * Task chains: a successor is set READY as soon as all its predecessors have
+ * completed, in the same critical section that ends the last one, so the next
+ * dispatch already sees it. A successor with several predecessors is a join,
+ * one with several successors forks. Successors usually have SCDL_INF_PERIOD,
+ * periodic ones get the chained releases on top of their period. Releases
+ * coalesce like those of vTaskSetState.
+ *
+ * 	vTaskChain(TID_SAMPLE, TID_FILTER);
+ * 	vTaskChain(TID_FILTER, TID_TRANSMIT);
+ */
+void vScdlTaskChain(scdlHandle_t hScdl, taskID_t tidPred, taskID_t tidSucc);
+void vScdlTaskUnchain(scdlHandle_t hScdl, taskID_t tidPred, taskID_t tidSucc);
+#define vTaskChain(p,s)					vScdlTaskChain(SCDL_DEFAULT, (p), (s))
+#define vTaskUnchain(p,s)				vScdlTaskUnchain(SCDL_DEFAULT, (p), (s))
+#endif
+
+/* single instance interface on the default instance */
+#ifndef SCDL_STATIC_TASKS
+#define vResetScheduler()				vScdlReset(SCDL_DEFAULT)
+#define tidCreateTask(f,p)				tidScdlCreateTask(SCDL_DEFAULT, (f), (p))
+#endif
+#define vStartScheduler()				vScdlRun(SCDL_DEFAULT)
+#define vScdlTick()						vScdlTickOf(SCDL_DEFAULT)
+/* name of the tick function for a 1 ms tick in older code */
+#define vScdlTick1ms()					vScdlTick()
+#define vTaskSetState(id,s)				vScdlTaskSetState(SCDL_DEFAULT, (id), (s))
+#define vSwitchAllTasksOff()			vScdlSwitchAllTasksOff(SCDL_DEFAULT)
+#if !(defined(SCDL_STATIC_TASKS) && defined(SCDL_CONST_PERIODS))
+#define vTaskSetPeriod(id,p)			vScdlTaskSetPeriod(SCDL_DEFAULT, (id), (p))
+#endif
+#define vTaskInvokeDelayed(id,d)		vScdlTaskInvokeDelayed(SCDL_DEFAULT, (id), (d))
+#define vTaskSetPhase(id,p)				vScdlTaskSetPhase(SCDL_DEFAULT, (id), (p))
+#define ulScdlGetTicks()				ulScdlGetTicksOf(SCDL_DEFAULT)
+#define usScdlGetTicks16()				usScdlGetTicks16Of(SCDL_DEFAULT)
+
+/* variants with times in us, periods should be multiples of SCDL_TICK_US */
+#ifndef SCDL_STATIC_TASKS
+#define tidCreateTaskUs(f,us)			tidCreateTask((f), SCDL_PERIOD_US(us))
+#endif
+#define vTaskSetPeriodUs(id,us)			vTaskSetPeriod((id), SCDL_PERIOD_US(us))
+#define vTaskInvokeDelayedUs(id,us)		vTaskInvokeDelayed((id), SCDL_US_TO_TICKS(us))
+
+unsigned char bSemaTake(sema_t* sema);
+unsigned char bSemaCntTake(sema_t* sema);
+
+#ifdef SCDL_MEASURE_ACTIVITY
+#ifdef SCDL_MULTI_INSTANCE
+#error SCDL_MEASURE_ACTIVITY records the default instance only
+#endif
+/*!
+ * activity of the default instance since start or vScdlResetActivity, times in port
+ * cycles, see SCDL_PORT_CYCLES_PER_MS. Read it often enough for the counters not to wrap.
+ */
+struct typScdlActivity
+{
+	/** ticks counted */
+	unsigned long ulTicks;
+	/** idle sleeps, each one ends with a wake up */
+	unsigned long ulWakeups;
+	/** wake ups that found a task to run, all a tickless tick would need */
+	unsigned long ulReleaseWakeups;
+	/** time spent in idle sleep, including ISRs run meanwhile */
+	unsigned long ulSleepCycles;
+	/** run time and number of runs of each task, ISRs hitting a task count for it */
+	unsigned long aulTaskCycles[SCDL_MAX_NUM_TASKS];
+	unsigned long aulTaskRuns[SCDL_MAX_NUM_TASKS];
+};
+
+void vScdlGetActivity(struct typScdlActivity *ptActivity);
+void vScdlResetActivity(void);
+#endif
+
+#ifdef SCDL_MEASURE_IRQ_OFF
+unsigned long ulScdlGetMaxIrqOff(void);
+unsigned long ulScdlGetMaxTickDuration(void);
+void vScdlResetIrqOffStats(void);
+#endif
+
+
+#endif /*SCHEDULER_H_*/
@@ -0,0 +1,153 @@
+/**************************************************************************************************
+  Filename:       scdl_boot.c
+  Author:         $Author: Menz $
+
+  Description:    Staged boot. The boot task runs the next stage and sets itself READY again
+                  while stages are left, so the scheduler picks every ready task of higher
+                  priority before the next stage. All boot times are taken in task context, the
+                  first task start by vScdlRun.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_boot.c */
+
+
+#include "inc/scheduler.h"
+#include "inc/scdl_boot.h"
+
+#ifdef SCDL_BOOT_STAGES
+
+static struct typScdlBootTimes g_tScdlBoot;
+static tScdlBootStage g_apfnScdlBootStages[SCDL_BOOT_MAX_STAGES];
+static tScdlBootDone g_pfnScdlBootDone = 0;
+static taskID_t g_tidScdlBoot = SCDL_NA;
+/* cycles at reset, 0 if the counter runs from there */
+static unsigned long g_ulScdlBootReset = 0;
+
+static unsigned long ulScdlBootNow(void)
+{
+	return ulScdlPortCycles() - g_ulScdlBootReset;
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlBootInit
+ *
+ * @brief	Start the boot measurement, first thing in main
+ *
+ */
+void vScdlBootInit(void)
+{
+	unsigned char i;
+
+#ifdef SCDL_PORT_CYCLES_FROM_RESET
+	g_ulScdlBootReset = 0;
+#else
+	g_ulScdlBootReset = ulScdlPortCycles();
+#endif
+
+	g_tScdlBoot.ulMain = ulScdlBootNow();
+	g_tScdlBoot.ulStart = 0;
+	g_tScdlBoot.ulFirstTask = 0;
+	g_tScdlBoot.ulInitialized = 0;
+	for(i = 0; i < SCDL_BOOT_MAX_STAGES; i++)
+		g_tScdlBoot.aulStage[i] = 0;
+	g_tScdlBoot.ucStages = 0;
+	g_tScdlBoot.ucDone = 0;
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlBootDefer
+ *
+ * @brief	Register an initialization to run after the scheduler started
+ *
+ * @param	pfnStage initialization, may create tasks, should return within a few ticks
+ *
+ */
+void vScdlBootDefer(tScdlBootStage pfnStage)
+{
+	SCDL_ASSERT(g_tScdlBoot.ucStages < SCDL_BOOT_MAX_STAGES);
+
+	g_apfnScdlBootStages[g_tScdlBoot.ucStages++] = pfnStage;
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlBootStart
+ *
+ * @brief	Hand the registered stages to the boot task, right before vStartScheduler
+ *
+ * @param	tidBoot task calling vTaskScdlBoot, period SCDL_INF_PERIOD, created after
+ * 			the tasks that must not wait for the stages
+ *
+ * 			pfnDone called by the boot task after the last stage, 0 if not needed
+ *
+ */
+void vScdlBootStart(taskID_t tidBoot, tScdlBootDone pfnDone)
+{
+	g_tidScdlBoot = tidBoot;
+	g_pfnScdlBootDone = pfnDone;
+	g_tScdlBoot.ulStart = ulScdlBootNow();
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlBootGetTimes
+ *
+ * @brief	Copy the boot times, from tasks
+ *
+ * @param	ptTimes destination
+ *
+ */
+void vScdlBootGetTimes(struct typScdlBootTimes *ptTimes)
+{
+	*ptTimes = g_tScdlBoot;
+}
+
+/*! **********************************************************************************
+ * @fn		vTaskScdlBoot
+ *
+ * @brief	Boot task, runs the next stage
+ *
+ */
+void vTaskScdlBoot(void)
+{
+	unsigned char ucStage = g_tScdlBoot.ucDone;
+	unsigned long ulStart;
+
+	/* no task was ready at vStartScheduler, the boot task is the first one */
+	if(!g_tScdlBoot.ulFirstTask)
+		g_tScdlBoot.ulFirstTask = ulScdlBootNow();
+
+	if(ucStage < g_tScdlBoot.ucStages)
+	{
+		ulStart = ulScdlPortCycles();
+		g_apfnScdlBootStages[ucStage]();
+		g_tScdlBoot.aulStage[ucStage] = ulScdlPortCycles() - ulStart;
+		g_tScdlBoot.ucDone = ++ucStage;
+	}
+
+	if(ucStage < g_tScdlBoot.ucStages)
+	{
+		/* the scheduler runs waiting tasks of higher priority first */
+		vTaskSetState(g_tidScdlBoot, READY);
+		return;
+	}
+
+	if(g_tScdlBoot.ulInitialized)
+		return;
+	g_tScdlBoot.ulInitialized = ulScdlBootNow();
+	if(g_pfnScdlBootDone)
+		g_pfnScdlBootDone(&g_tScdlBoot);
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlBootFirstTask
+ *
+ * @brief	Record the first task start, called by vScdlRun before its loop
+ *
+ */
+void vScdlBootFirstTask(void)
+{
+	g_tScdlBoot.ulFirstTask = ulScdlBootNow();
+}
+
+#endif /* SCDL_BOOT_STAGES */
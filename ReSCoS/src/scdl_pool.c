@@ -0,0 +1,181 @@
+/**************************************************************************************************
+  Filename:       scdl_pool.c
+  Author:         $Author: Menz $
+
+  Description:    Fixed-block memory pools. Allocation pops and free pushes the head of the
+                  free list inside a short critical section, so both take constant time and
+                  blocks can be passed between ISRs and tasks, e.g. a UART ISR fills a block
+                  that a task frees after processing.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_pool.c */
+
+
+#include "inc/scheduler.h"
+#include "inc/scdl_critical.h"
+#include "inc/scdl_pool.h"
+
+#ifdef SCDL_POOLS
+
+/*! **********************************************************************************
+ * @fn		vScdlPoolInit
+ *
+ * @brief	Initialize a pool, all blocks are free afterwards
+ *
+ * @param	ptPool pool
+ *
+ * 			pvMem storage of at least usNumBlocks * SCDL_POOL_BLOCK_SIZE(usSize) bytes,
+ * 			aligned for a pointer, see SCDL_POOL_STORAGE
+ *
+ * 			usSize bytes per block
+ *
+ * 			usNumBlocks number of blocks
+ *
+ */
+void vScdlPoolInit(struct typScdlPool *ptPool, void *pvMem, unsigned short usSize, unsigned short usNumBlocks)
+{
+	unsigned short usBlockSize = SCDL_POOL_BLOCK_SIZE(usSize);
+	unsigned char *pucBlock = (unsigned char *)pvMem;
+	unsigned short i;
+
+	SCDL_ASSERT(pvMem != 0 && usNumBlocks > 0);
+	SCDL_ASSERT(((unsigned long)pvMem & (sizeof(void *) - 1)) == 0);
+
+	/* link all blocks in address order */
+	for(i = 1; i < usNumBlocks; i++)
+	{
+		*(void **)pucBlock = pucBlock + usBlockSize;
+		pucBlock += usBlockSize;
+	}
+	*(void **)pucBlock = 0;
+
+	ptPool->pvFree = pvMem;
+	ptPool->pucStart = (unsigned char *)pvMem;
+	ptPool->pucEnd = pucBlock + usBlockSize;
+	ptPool->usBlockSize = usBlockSize;
+	ptPool->usNumBlocks = usNumBlocks;
+	ptPool->usUsed = 0;
+	ptPool->usPeak = 0;
+	ptPool->usFailed = 0;
+}
+
+/*! **********************************************************************************
+ * @fn		pvScdlPoolAlloc
+ *
+ * @brief	Take a block from a pool, O(1), may be called from ISRs
+ *
+ * @param	ptPool pool
+ *
+ * @return	block, 0 if the pool is empty
+ */
+void *pvScdlPoolAlloc(struct typScdlPool *ptPool)
+{
+	void *pvBlock;
+	scdlIrqState_t tIrqState;
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	pvBlock = ptPool->pvFree;
+	if(pvBlock)
+	{
+		ptPool->pvFree = *(void **)pvBlock;
+		if(++ptPool->usUsed > ptPool->usPeak)
+			ptPool->usPeak = ptPool->usUsed;
+	}
+	else if(ptPool->usFailed < 0xFFFF)
+		ptPool->usFailed++;
+	SCDL_EXIT_CRITICAL(tIrqState);
+
+	return pvBlock;
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlPoolFree
+ *
+ * @brief	Return a block to its pool, O(1), may be called from ISRs
+ *
+ * @param	ptPool pool the block was taken from
+ *
+ * 			pvBlock block, 0 is ignored
+ *
+ */
+void vScdlPoolFree(struct typScdlPool *ptPool, void *pvBlock)
+{
+	scdlIrqState_t tIrqState;
+
+	if(!pvBlock)
+		return;
+
+	SCDL_ASSERT((unsigned char *)pvBlock >= ptPool->pucStart && (unsigned char *)pvBlock < ptPool->pucEnd);
+	SCDL_ASSERT(((unsigned char *)pvBlock - ptPool->pucStart) % ptPool->usBlockSize == 0);
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	SCDL_ASSERT(ptPool->usUsed > 0);
+	*(void **)pvBlock = ptPool->pvFree;
+	ptPool->pvFree = pvBlock;
+	ptPool->usUsed--;
+	SCDL_EXIT_CRITICAL(tIrqState);
+}
+
+/*! **********************************************************************************
+ * @fn		usScdlPoolGetUsed
+ *
+ * @brief	Get the number of blocks in use
+ *
+ * @param	ptPool pool
+ *
+ * @return	blocks in use
+ */
+unsigned short usScdlPoolGetUsed(struct typScdlPool *ptPool)
+{
+	return ptPool->usUsed;
+}
+
+/*! **********************************************************************************
+ * @fn		usScdlPoolGetPeak
+ *
+ * @brief	Get the high-water mark of a pool
+ *
+ * @param	ptPool pool
+ *
+ * @return	most blocks in use at the same time since init or vScdlPoolResetStats
+ */
+unsigned short usScdlPoolGetPeak(struct typScdlPool *ptPool)
+{
+	return ptPool->usPeak;
+}
+
+/*! **********************************************************************************
+ * @fn		usScdlPoolGetFailed
+ *
+ * @brief	Get the number of allocations that found the pool empty
+ *
+ * @param	ptPool pool
+ *
+ * @return	failed allocations, saturates at 0xFFFF
+ */
+unsigned short usScdlPoolGetFailed(struct typScdlPool *ptPool)
+{
+	return ptPool->usFailed;
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlPoolResetStats
+ *
+ * @brief	Restart the high-water mark at the current usage and clear the failures
+ *
+ * @param	ptPool pool
+ *
+ */
+void vScdlPoolResetStats(struct typScdlPool *ptPool)
+{
+	scdlIrqState_t tIrqState;
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	ptPool->usPeak = ptPool->usUsed;
+	ptPool->usFailed = 0;
+	SCDL_EXIT_CRITICAL(tIrqState);
+}
+
+#endif /* SCDL_POOLS */
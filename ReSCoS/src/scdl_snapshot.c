@@ -0,0 +1,172 @@
+/**************************************************************************************************
+  Filename:       scdl_snapshot.c
+  Author:         $Author: Menz $
+
+  Description:    Sequence locked snapshots. All accesses to the shared data and the counter
+                  are volatile, so the compiler keeps them in program order. Single core ports
+                  need no more, ports with threads on several cores add a fence by
+                  SCDL_PORT_MEMORY_BARRIER.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_snapshot.c */
+
+
+#include "inc/scheduler.h"
+#include "inc/scdl_critical.h"
+#include "inc/scdl_snapshot.h"
+
+#ifdef SCDL_SNAPSHOTS
+
+#ifndef SCDL_PORT_MEMORY_BARRIER
+#define SCDL_PORT_MEMORY_BARRIER()	{ }
+#endif
+
+/* word wise if both sides and the size are word aligned */
+static void vScdlSnapshotCopy(volatile void *pvDst, const volatile void *pvSrc, unsigned short usSize)
+{
+	volatile unsigned char *pucDst = (volatile unsigned char *)pvDst;
+	const volatile unsigned char *pucSrc = (const volatile unsigned char *)pvSrc;
+	volatile unsigned int *puiDst;
+	const volatile unsigned int *puiSrc;
+	unsigned short i;
+
+	if((((unsigned long)pucDst | (unsigned long)pucSrc | usSize) & (sizeof(unsigned int) - 1)) == 0)
+	{
+		puiDst = (volatile unsigned int *)pvDst;
+		puiSrc = (const volatile unsigned int *)pvSrc;
+		for(i = 0; i < usSize / sizeof(unsigned int); i++)
+			puiDst[i] = puiSrc[i];
+	}
+	else
+	{
+		for(i = 0; i < usSize; i++)
+			pucDst[i] = pucSrc[i];
+	}
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlSnapshotInit
+ *
+ * @brief	Initialize a snapshot, the data keeps its current content
+ *
+ * @param	ptSnap snapshot
+ *
+ * 			pvData shared data, only accessed through the snapshot afterwards
+ *
+ * 			usSize bytes of data
+ *
+ */
+void vScdlSnapshotInit(struct typScdlSnapshot *ptSnap, void *pvData, unsigned short usSize)
+{
+	SCDL_ASSERT(pvData != 0 && usSize > 0);
+
+	ptSnap->uiSeq = 0;
+	ptSnap->pvData = pvData;
+	ptSnap->usSize = usSize;
+	ptSnap->usRetries = 0;
+	ptSnap->usLocked = 0;
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlSnapshotWrite
+ *
+ * @brief	Publish new data, never waits, called by the single writer, usually an ISR
+ *
+ * @param	ptSnap snapshot
+ *
+ * 			pvSrc new data of the size given to vScdlSnapshotInit
+ *
+ */
+void vScdlSnapshotWrite(struct typScdlSnapshot *ptSnap, const void *pvSrc)
+{
+	ptSnap->uiSeq++;
+	SCDL_PORT_MEMORY_BARRIER();
+
+	vScdlSnapshotCopy(ptSnap->pvData, pvSrc, ptSnap->usSize);
+
+	SCDL_PORT_MEMORY_BARRIER();
+	ptSnap->uiSeq++;
+}
+
+/*
+ * one optimistic read, returns 1 if no write overlapped the copy
+ */
+static unsigned char bScdlSnapshotTryRead(struct typScdlSnapshot *ptSnap, void *pvDst)
+{
+	unsigned int uiSeq = ptSnap->uiSeq;
+
+	if(uiSeq & 1)
+		return 0;
+
+	SCDL_PORT_MEMORY_BARRIER();
+	vScdlSnapshotCopy(pvDst, ptSnap->pvData, ptSnap->usSize);
+	SCDL_PORT_MEMORY_BARRIER();
+
+	return (ptSnap->uiSeq == uiSeq);
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlSnapshotRead
+ *
+ * @brief	Copy consistent data, from tasks or ISRs that do not preempt the writer.
+ * 			Interrupts stay enabled unless the writer overran SCDL_SNAPSHOT_RETRIES reads.
+ *
+ * @param	ptSnap snapshot
+ *
+ * 			pvDst buffer of the size given to vScdlSnapshotInit
+ *
+ */
+void vScdlSnapshotRead(struct typScdlSnapshot *ptSnap, void *pvDst)
+{
+	unsigned char i;
+	scdlIrqState_t tIrqState;
+
+	for(i = 0; i < SCDL_SNAPSHOT_RETRIES; i++)
+	{
+		if(bScdlSnapshotTryRead(ptSnap, pvDst))
+			return;
+		ptSnap->usRetries++;
+	}
+
+	/* the ISR writer cannot run meanwhile, the first try succeeds. A writer on another
+	   core or thread is not stopped by the lock and still never waits for us. */
+	SCDL_ENTER_CRITICAL(tIrqState);
+	while(!bScdlSnapshotTryRead(ptSnap, pvDst))
+	{
+	}
+	ptSnap->usLocked++;
+	SCDL_EXIT_CRITICAL(tIrqState);
+}
+
+/*! **********************************************************************************
+ * @fn		usScdlSnapshotGetRetries
+ *
+ * @brief	Reads repeated because a write overlapped them, wraps
+ *
+ * @param	ptSnap snapshot
+ *
+ * @return	number of retries since vScdlSnapshotInit
+ */
+unsigned short usScdlSnapshotGetRetries(struct typScdlSnapshot *ptSnap)
+{
+	return ptSnap->usRetries;
+}
+
+/*! **********************************************************************************
+ * @fn		usScdlSnapshotGetLocked
+ *
+ * @brief	Reads that fell back to a critical section, wraps. If this grows the writer
+ * 			runs too often for the size of the data.
+ *
+ * @param	ptSnap snapshot
+ *
+ * @return	number of locked reads since vScdlSnapshotInit
+ */
+unsigned short usScdlSnapshotGetLocked(struct typScdlSnapshot *ptSnap)
+{
+	return ptSnap->usLocked;
+}
+
+#endif /* SCDL_SNAPSHOTS */
@@ -0,0 +1,175 @@
+/**************************************************************************************************
+  Filename:       scdl_stack.c
+  Author:         $Author: Menz $
+
+  Description:    Stack watermark of the shared stack and per task stack depth. The unused
+                  stack is painted once, the scheduler calls vScdlStackTaskDone after each
+                  task. It scans from the stack limit to the first overwritten word, which
+                  is the deepest point since the last scan, and repaints up to itself.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_stack.c */
+
+
+#include "inc/scheduler.h"
+#include "inc/scdl_critical.h"
+#include "inc/scdl_stack.h"
+
+#ifdef SCDL_MEASURE_STACK
+
+#ifdef SCDL_MULTI_INSTANCE
+#error SCDL_MEASURE_STACK needs a single shared stack
+#endif
+
+static unsigned char g_bScdlStackPainted = 0;
+/** deepest overwritten word found so far */
+static unsigned int *g_puiScdlStackDeepest;
+/** deepest point of each task below the scheduler's frame */
+static unsigned short g_ausScdlStackPeak[SCDL_MAX_NUM_TASKS];
+
+/* first stack word, aligned up */
+static unsigned int *puiScdlStackLimit(void)
+{
+	unsigned long ulLimit = (unsigned long)SCDL_PORT_STACK_LIMIT;
+
+	return (unsigned int *)((ulLimit + sizeof(unsigned int) - 1) & ~(unsigned long)(sizeof(unsigned int) - 1));
+}
+
+/* word below the frame of the caller that must not be painted */
+static unsigned int *puiScdlStackPaintEnd(unsigned char *pucFrame)
+{
+	return (unsigned int *)(((unsigned long)pucFrame - SCDL_STACK_MARGIN) & ~(unsigned long)(sizeof(unsigned int) - 1));
+}
+
+/* first overwritten word above the limit, below puiEnd, kept if it is the deepest */
+static unsigned int *puiScdlStackScan(unsigned int *puiEnd)
+{
+	unsigned int *puiPos = puiScdlStackLimit();
+
+	/* read only, an ISR meanwhile only adds to the result */
+	while(puiPos < puiEnd && *puiPos == SCDL_STACK_PATTERN)
+		puiPos++;
+
+	if(puiPos < g_puiScdlStackDeepest)
+		g_puiScdlStackDeepest = puiPos;
+
+	return puiPos;
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlStackPaint
+ *
+ * @brief	paint the unused stack, called by vStartScheduler. Call it first in main
+ * 			to include the stack used by the initialization, the call of vStartScheduler
+ * 			then adds it to the peak of the stack and paints again, so that it is not
+ * 			counted for the first task.
+ *
+ */
+void vScdlStackPaint(void)
+{
+	unsigned char ucFrame;
+	unsigned int *puiPos = puiScdlStackLimit();
+	unsigned int *puiEnd = puiScdlStackPaintEnd(&ucFrame);
+	scdlIrqState_t tIrqState;
+
+	if(g_bScdlStackPainted)
+		puiPos = puiScdlStackScan(puiEnd);
+
+	/* ISRs use the stack below us */
+	SCDL_ENTER_CRITICAL(tIrqState);
+	while(puiPos < puiEnd)
+		*puiPos++ = SCDL_STACK_PATTERN;
+	if(!g_bScdlStackPainted)
+	{
+		g_puiScdlStackDeepest = puiEnd;
+		g_bScdlStackPainted = 1;
+	}
+	SCDL_EXIT_CRITICAL(tIrqState);
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlStackTaskDone
+ *
+ * @brief	measure the depth of a task that just returned and repaint the stack it used,
+ * 			the repainting runs with interrupts disabled and takes as long as the task
+ * 			was deep
+ *
+ * @param	taskID finished task
+ *
+ * 			pucBase address in the scheduler's frame, the task depth is counted from here
+ *
+ */
+void vScdlStackTaskDone(taskID_t taskID, unsigned char *pucBase)
+{
+	unsigned char ucFrame;
+	unsigned int *puiPos;
+	unsigned int *puiEnd = puiScdlStackPaintEnd(&ucFrame);
+	unsigned long ulDepth;
+	scdlIrqState_t tIrqState;
+
+	if(!g_bScdlStackPainted)
+		return;
+
+	puiPos = puiScdlStackScan(puiEnd);
+
+	ulDepth = (pucBase > (unsigned char *)puiPos) ? (unsigned long)(pucBase - (unsigned char *)puiPos) : 0;
+	if(ulDepth > 0xFFFF)
+		ulDepth = 0xFFFF;
+	if(ulDepth > g_ausScdlStackPeak[taskID])
+		g_ausScdlStackPeak[taskID] = (unsigned short)ulDepth;
+
+	/* an ISR frame may be below us while painting */
+	SCDL_ENTER_CRITICAL(tIrqState);
+	while(puiPos < puiEnd)
+		*puiPos++ = SCDL_STACK_PATTERN;
+	SCDL_EXIT_CRITICAL(tIrqState);
+}
+
+/*! **********************************************************************************
+ * @fn		ulScdlStackGetSize
+ *
+ * @brief	size of the stack region
+ *
+ * @return	bytes between SCDL_PORT_STACK_LIMIT and SCDL_PORT_STACK_TOP
+ */
+unsigned long ulScdlStackGetSize(void)
+{
+	return (unsigned long)(SCDL_PORT_STACK_TOP - SCDL_PORT_STACK_LIMIT);
+}
+
+/*! **********************************************************************************
+ * @fn		ulScdlStackGetPeak
+ *
+ * @brief	high-water mark of the shared stack, updated after each task. The difference
+ * 			to ulScdlStackGetSize is the stack that could be given to buffers.
+ *
+ * @return	most bytes used from the top of the stack, 0 before vScdlStackPaint
+ */
+unsigned long ulScdlStackGetPeak(void)
+{
+	if(!g_bScdlStackPainted)
+		return 0;
+
+	return (unsigned long)(SCDL_PORT_STACK_TOP - (unsigned char *)g_puiScdlStackDeepest);
+}
+
+/*! **********************************************************************************
+ * @fn		usScdlTaskGetStackPeak
+ *
+ * @brief	deepest stack use of a task, including its callees and the ISRs that hit it
+ *
+ * @param	taskID task
+ *
+ * @return	bytes below the scheduler's frame, at least about SCDL_STACK_MARGIN once the
+ * 			task ran
+ */
+unsigned short usScdlTaskGetStackPeak(taskID_t taskID)
+{
+	SCDL_ASSERT(taskID < SCDL_MAX_NUM_TASKS);
+
+	return g_ausScdlStackPeak[taskID];
+}
+
+#endif /* SCDL_MEASURE_STACK */
@@ -0,0 +1,248 @@
+/**************************************************************************************************
+  Filename:       scdl_timer.c
+  Author:         $Author: Menz $
+
+  Description:    Software timers serviced by a single scheduler task. A timer expiring at
+                  tick t is kept in the wheel slot t % SCDL_TIMER_WHEEL_SIZE, timers further
+                  away than one revolution stay in their slot until their round has come.
+                  Callbacks run in the service task, not in the tick ISR.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_timer.c */
+
+
+#include "inc/scheduler.h"
+#include "inc/scdl_critical.h"
+#include "inc/scdl_timer.h"
+
+#ifdef SCDL_TIMERS
+
+#define SCDL_TIMER_SLOT(t)		(&g_atScdlTimerWheel[(t) & (SCDL_TIMER_WHEEL_SIZE - 1)])
+
+/** circular lists with the slot as sentinel */
+static struct typScdlTimerLink g_atScdlTimerWheel[SCDL_TIMER_WHEEL_SIZE];
+/** last tick handled by the service task */
+static scdlTicks_t g_ulScdlTimerLast;
+static volatile taskID_t g_tidScdlTimers = SCDL_NA;
+
+/* list operations, interrupts must be disabled */
+static void vScdlTimerLink(struct typScdlTimerLink *ptHead, struct typScdlTimerLink *ptLink)
+{
+	ptLink->ptNext = ptHead->ptNext;
+	ptLink->ptPrev = ptHead;
+	ptHead->ptNext->ptPrev = ptLink;
+	ptHead->ptNext = ptLink;
+}
+
+static void vScdlTimerUnlink(struct typScdlTimerLink *ptLink)
+{
+	ptLink->ptPrev->ptNext = ptLink->ptNext;
+	ptLink->ptNext->ptPrev = ptLink->ptPrev;
+	ptLink->ptNext = 0;
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlTimerInit
+ *
+ * @brief	Initialize the timer wheel, all timers are stopped afterwards
+ *
+ * @param	tidService task calling vTaskScdlTimers, period SCDL_INF_PERIOD
+ *
+ */
+void vScdlTimerInit(taskID_t tidService)
+{
+	unsigned short i;
+	scdlIrqState_t tIrqState;
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	for(i = 0; i < SCDL_TIMER_WHEEL_SIZE; i++)
+	{
+		g_atScdlTimerWheel[i].ptNext = &g_atScdlTimerWheel[i];
+		g_atScdlTimerWheel[i].ptPrev = &g_atScdlTimerWheel[i];
+	}
+	g_ulScdlTimerLast = ulScdlGetTicks();
+	g_tidScdlTimers = tidService;
+	SCDL_EXIT_CRITICAL(tIrqState);
+
+	/* woken by vScdlTimerTick */
+	vTaskSetState(tidService, OFF);
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlTimerStart
+ *
+ * @brief	Start or restart a timer, O(1), may be called from ISRs
+ *
+ * @param	ptTimer timer, restarted if running
+ *
+ * 			ulDelay ticks until the first expiry, at least 1
+ *
+ * 			ulPeriod ticks between further expiries, 0 for a one-shot timer
+ *
+ * 			pfnCallback function called from the service task on expiry
+ *
+ * 			pvArg argument of pfnCallback
+ *
+ */
+void vScdlTimerStart(struct typScdlTimer *ptTimer, unsigned long ulDelay, unsigned long ulPeriod,
+		tScdlTimerCallback pfnCallback, void *pvArg)
+{
+	scdlIrqState_t tIrqState;
+
+	SCDL_ASSERT(g_tidScdlTimers != SCDL_NA);
+	SCDL_ASSERT(ulDelay > 0 && ulDelay <= SCDL_MAX_TASK_PERIOD);
+	SCDL_ASSERT(ulPeriod <= SCDL_MAX_TASK_PERIOD);
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	if(ptTimer->tLink.ptNext)
+		vScdlTimerUnlink(&ptTimer->tLink);
+	ptTimer->ulExpiry = ulScdlGetTicks() + ulDelay;
+	ptTimer->ulPeriod = ulPeriod;
+	ptTimer->pfnCallback = pfnCallback;
+	ptTimer->pvArg = pvArg;
+	vScdlTimerLink(SCDL_TIMER_SLOT(ptTimer->ulExpiry), &ptTimer->tLink);
+	SCDL_EXIT_CRITICAL(tIrqState);
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlTimerStop
+ *
+ * @brief	Stop a timer, O(1), may be called from ISRs and callbacks
+ *
+ * @param	ptTimer timer, nothing happens if it is not running
+ *
+ */
+void vScdlTimerStop(struct typScdlTimer *ptTimer)
+{
+	scdlIrqState_t tIrqState;
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	if(ptTimer->tLink.ptNext)
+		vScdlTimerUnlink(&ptTimer->tLink);
+	SCDL_EXIT_CRITICAL(tIrqState);
+}
+
+/*! **********************************************************************************
+ * @fn		ucScdlTimerIsActive
+ *
+ * @brief	Check if a timer is running
+ *
+ * @param	ptTimer timer
+ *
+ * @return	1 if the timer will expire, 0 otherwise
+ */
+unsigned char ucScdlTimerIsActive(struct typScdlTimer *ptTimer)
+{
+	return ptTimer->tLink.ptNext ? 1 : 0;
+}
+
+/*
+ * fire the due timers of one slot. The slot is moved to a local list first, then
+ * every timer is handled under its own short lock, so start and stop from ISRs
+ * stay possible meanwhile.
+ */
+static void vScdlTimerSlot(struct typScdlTimerLink *ptSlot, scdlTicks_t ulNow)
+{
+	struct typScdlTimerLink tWork;
+	struct typScdlTimer *ptTimer;
+	tScdlTimerCallback pfnCallback;
+	void *pvArg;
+	scdlIrqState_t tIrqState;
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	if(ptSlot->ptNext == ptSlot)
+	{
+		SCDL_EXIT_CRITICAL(tIrqState);
+		return;
+	}
+	tWork.ptNext = ptSlot->ptNext;
+	tWork.ptPrev = ptSlot->ptPrev;
+	tWork.ptNext->ptPrev = &tWork;
+	tWork.ptPrev->ptNext = &tWork;
+	ptSlot->ptNext = ptSlot;
+	ptSlot->ptPrev = ptSlot;
+	SCDL_EXIT_CRITICAL(tIrqState);
+
+	for(;;)
+	{
+		SCDL_ENTER_CRITICAL(tIrqState);
+		if(tWork.ptNext == &tWork)
+		{
+			SCDL_EXIT_CRITICAL(tIrqState);
+			break;
+		}
+		ptTimer = (struct typScdlTimer *)tWork.ptNext;
+		vScdlTimerUnlink(&ptTimer->tLink);
+
+		/* a later round of this slot */
+		if(!SCDL_TIME_REACHED(ulNow, ptTimer->ulExpiry))
+		{
+			vScdlTimerLink(ptSlot, &ptTimer->tLink);
+			SCDL_EXIT_CRITICAL(tIrqState);
+			continue;
+		}
+
+		if(ptTimer->ulPeriod)
+		{
+			/* reload without drift, restart from now after an overrun */
+			ptTimer->ulExpiry += ptTimer->ulPeriod;
+			if(SCDL_TIME_REACHED(ulNow, ptTimer->ulExpiry))
+				ptTimer->ulExpiry = ulNow + ptTimer->ulPeriod;
+			vScdlTimerLink(SCDL_TIMER_SLOT(ptTimer->ulExpiry), &ptTimer->tLink);
+		}
+		pfnCallback = ptTimer->pfnCallback;
+		pvArg = ptTimer->pvArg;
+		SCDL_EXIT_CRITICAL(tIrqState);
+
+		pfnCallback(pvArg);
+	}
+}
+
+/*! **********************************************************************************
+ * @fn		vTaskScdlTimers
+ *
+ * @brief	timer service task, handles all slots since its last run
+ *
+ */
+void vTaskScdlTimers(void)
+{
+	scdlTicks_t ulNow = ulScdlGetTicks();
+	unsigned long ulSlots = ulNow - g_ulScdlTimerLast;
+
+	/* after a long pause one revolution covers every slot */
+	if(ulSlots > SCDL_TIMER_WHEEL_SIZE)
+		ulSlots = SCDL_TIMER_WHEEL_SIZE;
+
+	while(ulSlots)
+	{
+		ulSlots--;
+		vScdlTimerSlot(SCDL_TIMER_SLOT(ulNow - ulSlots), ulNow);
+	}
+
+	g_ulScdlTimerLast = ulNow;
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlTimerTick
+ *
+ * @brief	called by the tick of the default instance, O(1): wakes the service task
+ * 			if the slot of this tick holds a timer
+ *
+ * @param	ulNow current tick
+ *
+ */
+void vScdlTimerTick(scdlTicks_t ulNow)
+{
+	struct typScdlTimerLink *ptSlot;
+
+	if(g_tidScdlTimers == SCDL_NA)
+		return;
+
+	ptSlot = SCDL_TIMER_SLOT(ulNow);
+	if(ptSlot->ptNext != ptSlot)
+		vTaskSetState(g_tidScdlTimers, READY);
+}
+
+#endif /* SCDL_TIMERS */
@@ -0,0 +1,267 @@
+/**************************************************************************************************
+  Filename:       scdl_topic.c
+  Author:         $Author: Menz $
+
+  Description:    Publish/subscribe topics with reference counted slots. Samples are never
+                  copied, claim, publish, get and release only move slot references inside
+                  short critical sections, so producers may be ISRs. A publication walks the
+                  subscriber list to set the tasks READY.
+
+**************************************************************************************************/
+
+
+/*! @file scdl_topic.c */
+
+
+#include "inc/scheduler.h"
+#include "inc/scdl_critical.h"
+#include "inc/scdl_topic.h"
+
+#ifdef SCDL_TOPICS
+
+#define SCDL_TOPIC_SLOT(pt,i)		((pt)->pucSlots + (unsigned short)(i) * (pt)->usSlotSize)
+
+/*! **********************************************************************************
+ * @fn		vScdlTopicInit
+ *
+ * @brief	Initialize a topic without subscribers and samples
+ *
+ * @param	ptTopic topic
+ *
+ * 			pvMem storage of at least ucNumSlots * SCDL_TOPIC_SLOT_SIZE(usSize) bytes,
+ * 			aligned for a pointer, see SCDL_TOPIC_STORAGE
+ *
+ * 			usSize bytes per sample
+ *
+ * 			ucNumSlots number of slots, at least 2, subscribers + 2 for claims to never fail
+ *
+ */
+void vScdlTopicInit(struct typScdlTopic *ptTopic, void *pvMem, unsigned short usSize, unsigned char ucNumSlots)
+{
+	unsigned char i;
+
+	SCDL_ASSERT(pvMem != 0 && usSize > 0);
+	SCDL_ASSERT(ucNumSlots >= 2 && ucNumSlots <= SCDL_TOPIC_MAX_SLOTS);
+
+	ptTopic->pucSlots = (unsigned char *)pvMem;
+	ptTopic->usSlotSize = SCDL_TOPIC_SLOT_SIZE(usSize);
+	ptTopic->ucNumSlots = ucNumSlots;
+	ptTopic->ucLatest = SCDL_NA;
+	for(i = 0; i < ucNumSlots; i++)
+		ptTopic->aucRefs[i] = 0;
+	ptTopic->usSeq = 0;
+	ptTopic->ptSubscribers = 0;
+	ptTopic->usMissed = 0;
+	ptTopic->usNoSlot = 0;
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlTopicSubscribe
+ *
+ * @brief	Subscribe a task, it is set READY by every following publication
+ *
+ * @param	ptTopic topic
+ *
+ * 			ptSub subscription, one per task and topic
+ *
+ * 			tidTask task of the default instance, usually with period SCDL_INF_PERIOD
+ *
+ */
+void vScdlTopicSubscribe(struct typScdlTopic *ptTopic, struct typScdlSubscriber *ptSub, taskID_t tidTask)
+{
+	scdlIrqState_t tIrqState;
+
+	SCDL_ASSERT(tidTask != SCDL_NA);
+
+	ptSub->tidTask = tidTask;
+	ptSub->ucHeld = SCDL_NA;
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	/* the current sample counts as seen, only new ones are delivered */
+	ptSub->usSeen = ptTopic->usSeq;
+	ptSub->ptNext = ptTopic->ptSubscribers;
+	ptTopic->ptSubscribers = ptSub;
+	SCDL_EXIT_CRITICAL(tIrqState);
+}
+
+/*! **********************************************************************************
+ * @fn		pvScdlTopicClaim
+ *
+ * @brief	Take a free slot to write the next sample into, may be called from ISRs
+ *
+ * @param	ptTopic topic
+ *
+ * @return	slot, to be passed to vScdlTopicPublish, 0 if all slots are in use
+ */
+void *pvScdlTopicClaim(struct typScdlTopic *ptTopic)
+{
+	unsigned char i;
+	void *pvSlot = 0;
+	scdlIrqState_t tIrqState;
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	for(i = 0; i < ptTopic->ucNumSlots; i++)
+	{
+		if(!ptTopic->aucRefs[i])
+		{
+			ptTopic->aucRefs[i] = 1;
+			pvSlot = SCDL_TOPIC_SLOT(ptTopic, i);
+			break;
+		}
+	}
+	if(!pvSlot && ptTopic->usNoSlot < 0xFFFF)
+		ptTopic->usNoSlot++;
+	SCDL_EXIT_CRITICAL(tIrqState);
+
+	return pvSlot;
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlTopicPublish
+ *
+ * @brief	Make a claimed slot the latest sample and set all subscribers READY,
+ * 			may be called from ISRs
+ *
+ * @param	ptTopic topic
+ *
+ * 			pvSample slot returned by pvScdlTopicClaim
+ *
+ */
+void vScdlTopicPublish(struct typScdlTopic *ptTopic, void *pvSample)
+{
+	struct typScdlSubscriber *ptSub;
+	unsigned char ucSlot = (unsigned char)(((unsigned char *)pvSample - ptTopic->pucSlots) / ptTopic->usSlotSize);
+	scdlIrqState_t tIrqState;
+
+	SCDL_ASSERT(ucSlot < ptTopic->ucNumSlots && pvSample == SCDL_TOPIC_SLOT(ptTopic, ucSlot));
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	SCDL_ASSERT(ptTopic->aucRefs[ucSlot] > 0);
+
+	/* the claim becomes the reference of the latest sample */
+	if(ptTopic->ucLatest != SCDL_NA)
+		ptTopic->aucRefs[ptTopic->ucLatest]--;
+	ptTopic->ucLatest = ucSlot;
+
+	for(ptSub = ptTopic->ptSubscribers; ptSub; ptSub = ptSub->ptNext)
+	{
+		/* the sample replaced now was not taken */
+		if(ptSub->usSeen != ptTopic->usSeq && ptTopic->usMissed < 0xFFFF)
+			ptTopic->usMissed++;
+		vTaskSetState(ptSub->tidTask, READY);
+	}
+	ptTopic->usSeq++;
+	SCDL_EXIT_CRITICAL(tIrqState);
+}
+
+/*
+ * drop the reference of a subscriber, interrupts must be disabled
+ */
+static void vScdlTopicDrop(struct typScdlTopic *ptTopic, struct typScdlSubscriber *ptSub)
+{
+	if(ptSub->ucHeld != SCDL_NA)
+	{
+		ptTopic->aucRefs[ptSub->ucHeld]--;
+		ptSub->ucHeld = SCDL_NA;
+	}
+}
+
+/*! **********************************************************************************
+ * @fn		pvScdlTopicGet
+ *
+ * @brief	Get the latest sample if it is new to the subscriber. The sample stays valid
+ * 			until the next get or release of this subscription, the reference to the
+ * 			previous sample is dropped.
+ *
+ * @param	ptTopic topic
+ *
+ * 			ptSub subscription of the calling task
+ *
+ * @return	sample, read only, 0 if nothing was published since the last get
+ */
+const void *pvScdlTopicGet(struct typScdlTopic *ptTopic, struct typScdlSubscriber *ptSub)
+{
+	const void *pvSample = 0;
+	scdlIrqState_t tIrqState;
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	vScdlTopicDrop(ptTopic, ptSub);
+	if(ptSub->usSeen != ptTopic->usSeq)
+	{
+		ptSub->usSeen = ptTopic->usSeq;
+		ptSub->ucHeld = ptTopic->ucLatest;
+		ptTopic->aucRefs[ptSub->ucHeld]++;
+		pvSample = SCDL_TOPIC_SLOT(ptTopic, ptSub->ucHeld);
+	}
+	SCDL_EXIT_CRITICAL(tIrqState);
+
+	return pvSample;
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlTopicRelease
+ *
+ * @brief	Return the sample of the last get before the next one, so the slot can be reused
+ *
+ * @param	ptTopic topic
+ *
+ * 			ptSub subscription of the calling task
+ *
+ */
+void vScdlTopicRelease(struct typScdlTopic *ptTopic, struct typScdlSubscriber *ptSub)
+{
+	scdlIrqState_t tIrqState;
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	vScdlTopicDrop(ptTopic, ptSub);
+	SCDL_EXIT_CRITICAL(tIrqState);
+}
+
+/*! **********************************************************************************
+ * @fn		usScdlTopicGetMissed
+ *
+ * @brief	Get the number of samples replaced before a subscriber got them, every
+ * 			subscriber counts
+ *
+ * @param	ptTopic topic
+ *
+ * @return	missed samples, saturates at 0xFFFF
+ */
+unsigned short usScdlTopicGetMissed(struct typScdlTopic *ptTopic)
+{
+	return ptTopic->usMissed;
+}
+
+/*! **********************************************************************************
+ * @fn		usScdlTopicGetNoSlot
+ *
+ * @brief	Get the number of claims that found all slots in use
+ *
+ * @param	ptTopic topic
+ *
+ * @return	failed claims, saturates at 0xFFFF
+ */
+unsigned short usScdlTopicGetNoSlot(struct typScdlTopic *ptTopic)
+{
+	return ptTopic->usNoSlot;
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlTopicResetStats
+ *
+ * @brief	Clear the missed samples and failed claims
+ *
+ * @param	ptTopic topic
+ *
+ */
+void vScdlTopicResetStats(struct typScdlTopic *ptTopic)
+{
+	scdlIrqState_t tIrqState;
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	ptTopic->usMissed = 0;
+	ptTopic->usNoSlot = 0;
+	SCDL_EXIT_CRITICAL(tIrqState);
+}
+
+#endif /* SCDL_TOPICS */
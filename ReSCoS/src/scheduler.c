@@ -0,0 +1,1521 @@
+/**************************************************************************************************
+  Filename:       scheduler.c
+  Revised:        $Date: 2013-02-20 17:37:33 +0100 (Mi, 20 Feb 2013) $
+  Revision:       $Revision: 54 $
+  Author:         $Author: Menz $
+
+  Description:    Functions for a cooperative scheduling of tasks.
+                  Platform specific parts are in port/<platform>/scdl_port.h.
+
+
+**************************************************************************************************/
+
+
+/*! @file scheduler.c */
+
+
+#include "inc/scheduler.h"
+#include "inc/scdl_critical.h"
+#ifdef SCDL_TIMERS
+#include "inc/scdl_timer.h"
+#endif
+#ifdef SCDL_BOOT_STAGES
+#include "inc/scdl_boot.h"
+#endif
+#ifdef SCDL_MEASURE_STACK
+#include "inc/scdl_stack.h"
+#endif
+#ifdef SCDL_HOOKS_INCLUDE
+#include SCDL_HOOKS_INCLUDE
+#endif
+
+static void vScheduler(struct typScheduler *ptScdl);
+
+#ifdef SCDL_STATIC_TASKS
+/*!
+ * constant part of a task from SCDL_TASK_TABLE, placed in flash
+ */
+struct typTaskConst
+{
+	/** Task function */
+	void (*vTaskFunc)(void);
+#ifdef SCDL_CONST_PERIODS
+	/** Task period in ticks */
+	unsigned long ulTaskPeriod;
+#endif
+};
+
+#define SCDL_TASK_ID_INIT(id,f,p)		id,
+#ifdef SCDL_EDF
+/* all tasks READY with deadline 0, the heap in ID order is valid then */
+#define SCDL_TASK_EDF_INIT(id)			, 0, 0, id
+#define SCDL_HEAP_INIT					, { SCDL_TASK_TABLE(SCDL_TASK_ID_INIT) }, SCDL_NUM_STATIC_TASKS
+#else
+#define SCDL_TASK_EDF_INIT(id)
+#define SCDL_HEAP_INIT
+#endif
+#ifdef SCDL_AUTO_PRIO
+/* ID order until vScdlRun sorts it */
+#define SCDL_PRIO_INIT					, { SCDL_TASK_TABLE(SCDL_TASK_ID_INIT) }
+#else
+#define SCDL_PRIO_INIT
+#endif
+
+#ifdef SCDL_CONST_PERIODS
+#define SCDL_TASK_CONST_INIT(id,f,p)	{ f, p },
+#define SCDL_TASK_INIT(id,f,p)			{ 0, READY SCDL_TASK_EDF_INIT(id) },
+#else
+#define SCDL_TASK_CONST_INIT(id,f,p)	{ f },
+#define SCDL_TASK_INIT(id,f,p)			{ 0, p, READY SCDL_TASK_EDF_INIT(id) },
+#endif
+
+static const struct typTaskConst g_atTaskConst[SCDL_NUM_STATIC_TASKS] = { SCDL_TASK_TABLE(SCDL_TASK_CONST_INIT) };
+
+/** default instance, initialized from SCDL_TASK_TABLE */
+struct typScheduler g_tScdlDefault = { SCDL_NA, 0, { SCDL_TASK_TABLE(SCDL_TASK_INIT) } SCDL_HEAP_INIT SCDL_PRIO_INIT };
+#else
+/** default instance, tasks are added by tidCreateTask */
+struct typScheduler g_tScdlDefault = { .tidActiveTask = SCDL_NA };
+#endif
+
+/* access to members that are constant with SCDL_STATIC_TASKS */
+#ifdef SCDL_STATIC_TASKS
+#define SCDL_NUM_TASKS(p)		(SCDL_NUM_STATIC_TASKS)
+#define SCDL_TASK_FUNC(p,id)	(g_atTaskConst[id].vTaskFunc)
+#else
+#define SCDL_NUM_TASKS(p)		((p)->ucNumTasks)
+#define SCDL_TASK_FUNC(p,id)	((p)->atTask[id].vTaskFunc)
+#endif
+#if defined(SCDL_STATIC_TASKS) && defined(SCDL_CONST_PERIODS)
+#define SCDL_TASK_OWN_PERIOD(p,id)	(g_atTaskConst[id].ulTaskPeriod)
+#else
+#define SCDL_TASK_OWN_PERIOD(p,id)	((p)->atTask[id].ulTaskPeriod)
+#endif
+#ifdef SCDL_MODES
+/* the period of the current mode */
+#define SCDL_TASK_PERIOD(p,id)	ulScdlModePeriod((p), (id))
+#define SCDL_MODE_TASKS(p)		((p)->ptMode ? (p)->ptMode->tTasks : SCDL_ALL_TASKS)
+#define SCDL_IN_MODE(p,id)		(SCDL_MODE_TASKS(p) & SCDL_TASK_BIT(id))
+#else
+#define SCDL_TASK_PERIOD(p,id)	SCDL_TASK_OWN_PERIOD(p,id)
+#endif
+/* ID of the task with the i-th highest priority */
+#ifdef SCDL_AUTO_PRIO
+#define SCDL_PRIO_TASK(p,i)		((p)->atidPrioOrder[i])
+#else
+#define SCDL_PRIO_TASK(p,i)		(i)
+#endif
+
+#ifdef SCDL_MULTI_INSTANCE
+/** instances registered by vScdlInit, ticked by vScdlTickAll */
+static struct typScheduler *g_ptScdlInstances = 0;
+#endif
+
+#ifdef SCDL_MEASURE_ACTIVITY
+/** updated by vScdlRun only, so tasks read it consistently */
+static struct typScdlActivity g_tScdlActivity;
+static unsigned long g_ulScdlActivityStartTick = 0;
+#endif
+
+#ifdef SCDL_MEASURE_IRQ_OFF
+unsigned long g_ulScdlIrqOffStart;
+static unsigned long g_ulScdlIrqOffMax = 0;
+static unsigned long g_ulScdlTickMax = 0;
+#endif
+
+#ifdef SCDL_MODES
+static unsigned long ulScdlModePeriod(struct typScheduler *ptScdl, taskID_t tid)
+{
+	const struct typScdlMode *ptMode = ptScdl->ptMode;
+
+	if(ptMode && ptMode->pulPeriods && ptMode->pulPeriods[tid])
+		return ptMode->pulPeriods[tid];
+	return SCDL_TASK_OWN_PERIOD(ptScdl, tid);
+}
+#endif
+
+#ifdef SCDL_EDF
+/*
+ * ready heap, all functions need interrupts disabled
+ */
+static unsigned char bScdlEarlier(struct typScheduler *ptScdl, taskID_t tidA, taskID_t tidB)
+{
+	signed long lDiff = (signed long)(ptScdl->atTask[tidA].ulDeadline - ptScdl->atTask[tidB].ulDeadline);
+
+	return lDiff < 0 || (lDiff == 0 && tidA < tidB);
+}
+
+static void vScdlHeapPlace(struct typScheduler *ptScdl, unsigned char ucPos, taskID_t tid)
+{
+	ptScdl->atidReadyHeap[ucPos] = tid;
+	ptScdl->atTask[tid].ucHeapPos = ucPos;
+}
+
+/* move the task at ucPos towards the root while it is earlier than its parent */
+static void vScdlHeapUp(struct typScheduler *ptScdl, unsigned char ucPos)
+{
+	taskID_t tid = ptScdl->atidReadyHeap[ucPos];
+	unsigned char ucParent;
+
+	while(ucPos)
+	{
+		ucParent = (ucPos - 1) / 2;
+		if(!bScdlEarlier(ptScdl, tid, ptScdl->atidReadyHeap[ucParent]))
+			break;
+		vScdlHeapPlace(ptScdl, ucPos, ptScdl->atidReadyHeap[ucParent]);
+		ucPos = ucParent;
+	}
+	vScdlHeapPlace(ptScdl, ucPos, tid);
+}
+
+/* move the task at ucPos towards the leaves while a child is earlier */
+static void vScdlHeapDown(struct typScheduler *ptScdl, unsigned char ucPos)
+{
+	taskID_t tid = ptScdl->atidReadyHeap[ucPos];
+	unsigned char ucChild;
+
+	for(;;)
+	{
+		ucChild = 2 * ucPos + 1;
+		if(ucChild >= ptScdl->ucNumReady)
+			break;
+		if(ucChild + 1 < ptScdl->ucNumReady &&
+				bScdlEarlier(ptScdl, ptScdl->atidReadyHeap[ucChild + 1], ptScdl->atidReadyHeap[ucChild]))
+			ucChild++;
+		if(!bScdlEarlier(ptScdl, ptScdl->atidReadyHeap[ucChild], tid))
+			break;
+		vScdlHeapPlace(ptScdl, ucPos, ptScdl->atidReadyHeap[ucChild]);
+		ucPos = ucChild;
+	}
+	vScdlHeapPlace(ptScdl, ucPos, tid);
+}
+
+static void vScdlHeapInsert(struct typScheduler *ptScdl, taskID_t tid)
+{
+	unsigned long ulRel = ptScdl->atTask[tid].ulRelDeadline;
+
+	/* the deadline counts from the release, which is now */
+	if(!ulRel && SCDL_TASK_PERIOD(ptScdl, tid) != SCDL_INF_PERIOD)
+		ulRel = SCDL_TASK_PERIOD(ptScdl, tid);
+	ptScdl->atTask[tid].ulDeadline = ptScdl->ulSystemTicks + ulRel;
+
+	vScdlHeapPlace(ptScdl, ptScdl->ucNumReady, tid);
+	ptScdl->ucNumReady++;
+	vScdlHeapUp(ptScdl, ptScdl->ucNumReady - 1);
+}
+
+static void vScdlHeapRemove(struct typScheduler *ptScdl, taskID_t tid)
+{
+	unsigned char ucPos = ptScdl->atTask[tid].ucHeapPos;
+
+	ptScdl->ucNumReady--;
+	if(ucPos == ptScdl->ucNumReady)
+		return;
+
+	/* fill the gap with the last task, it may have to move either way */
+	vScdlHeapPlace(ptScdl, ucPos, ptScdl->atidReadyHeap[ptScdl->ucNumReady]);
+	if(ucPos && bScdlEarlier(ptScdl, ptScdl->atidReadyHeap[ucPos], ptScdl->atidReadyHeap[(ucPos - 1) / 2]))
+		vScdlHeapUp(ptScdl, ucPos);
+	else
+		vScdlHeapDown(ptScdl, ucPos);
+}
+#endif
+
+#ifdef SCDL_AUTO_PRIO
+/*
+ * sort key of the deadline monotonic order, SCDL_INF_PERIOD sorts last
+ */
+static unsigned long ulScdlPrioKey(struct typScheduler *ptScdl, taskID_t tid)
+{
+	return ptScdl->atTask[tid].ulRelDeadline ? ptScdl->atTask[tid].ulRelDeadline : SCDL_TASK_PERIOD(ptScdl, tid);
+}
+
+static unsigned char bScdlHigherPrio(struct typScheduler *ptScdl, taskID_t tidA, taskID_t tidB)
+{
+	unsigned long ulKeyA = ulScdlPrioKey(ptScdl, tidA);
+	unsigned long ulKeyB = ulScdlPrioKey(ptScdl, tidB);
+
+	return ulKeyA < ulKeyB || (ulKeyA == ulKeyB && tidA < tidB);
+}
+
+/*
+ * move one task to its place after its key changed, the rest of the order is
+ * sorted. Interrupts must be disabled, the tick dispatches by this order.
+ */
+static void vScdlReorder(struct typScheduler *ptScdl, taskID_t tid)
+{
+	unsigned char ucNum = SCDL_NUM_TASKS(ptScdl);
+	unsigned char ucPos, i;
+
+	for(ucPos = 0; ptScdl->atidPrioOrder[ucPos] != tid; ucPos++);
+
+	/* move up while the task has a higher priority than its predecessor ... */
+	while(ucPos && bScdlHigherPrio(ptScdl, tid, ptScdl->atidPrioOrder[ucPos - 1]))
+	{
+		ptScdl->atidPrioOrder[ucPos] = ptScdl->atidPrioOrder[ucPos - 1];
+		ucPos--;
+	}
+	/* ... or down while its successor has a higher priority */
+	for(i = ucPos; i + 1 < ucNum && bScdlHigherPrio(ptScdl, ptScdl->atidPrioOrder[i + 1], tid); i++)
+		ptScdl->atidPrioOrder[i] = ptScdl->atidPrioOrder[i + 1];
+
+	ptScdl->atidPrioOrder[i] = tid;
+}
+
+static void vScdlReorderSafe(struct typScheduler *ptScdl, taskID_t tid)
+{
+	scdlIrqState_t tIrqState;
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	vScdlReorder(ptScdl, tid);
+	SCDL_EXIT_CRITICAL(tIrqState);
+}
+
+#ifdef SCDL_STATIC_TASKS
+/*
+ * insertion sort of the whole order, the static table starts in ID order
+ */
+static void vScdlSortPrio(struct typScheduler *ptScdl)
+{
+	unsigned char i, k;
+	taskID_t tid;
+	scdlIrqState_t tIrqState;
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	for(k = 1; k < SCDL_NUM_TASKS(ptScdl); k++)
+	{
+		tid = ptScdl->atidPrioOrder[k];
+		for(i = k; i && bScdlHigherPrio(ptScdl, tid, ptScdl->atidPrioOrder[i - 1]); i--)
+			ptScdl->atidPrioOrder[i] = ptScdl->atidPrioOrder[i - 1];
+		ptScdl->atidPrioOrder[i] = tid;
+	}
+	SCDL_EXIT_CRITICAL(tIrqState);
+}
+#endif
+#endif
+
+/*
+ * every state change goes through here, with SCDL_EDF the ready heap follows
+ * the state and interrupts must be disabled
+ */
+static void vScdlSetState(struct typScheduler *ptScdl, taskID_t tid, enum etypTaskStates eState)
+{
+#ifdef SCDL_EDF
+	enum etypTaskStates eOld = ptScdl->atTask[tid].eTaskState;
+
+	if(eOld == READY && eState != READY)
+		vScdlHeapRemove(ptScdl, tid);
+	ptScdl->atTask[tid].eTaskState = eState;
+	if(eOld != READY && eState == READY)
+		vScdlHeapInsert(ptScdl, tid);
+#else
+	ptScdl->atTask[tid].eTaskState = eState;
+#endif
+	SCDL_HOOK_TASK_STATE(ptScdl, tid, eState);
+}
+
+/*
+ * state change from task level, the ready heap needs a critical section
+ */
+static void vScdlSetStateSafe(struct typScheduler *ptScdl, taskID_t tid, enum etypTaskStates eState)
+{
+#ifdef SCDL_EDF
+	scdlIrqState_t tIrqState;
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	vScdlSetState(ptScdl, tid, eState);
+	SCDL_EXIT_CRITICAL(tIrqState);
+#else
+	vScdlSetState(ptScdl, tid, eState);
+#endif
+}
+
+#ifndef SCDL_STATIC_TASKS
+/*! **********************************************************************************
+ * @fn		vScdlReset
+ *
+ * @brief	Delete all tasks and restore the state of a new instance: tick 0, no
+ * 			active task, all tasks mode. Not while the instance runs, a following
+ * 			vScdlRun starts over with the tasks created after the reset.
+ *
+ * @param	hScdl instance, SCDL_DEFAULT for vResetScheduler
+ *
+ */
+void vScdlReset(scdlHandle_t hScdl)
+{
+	hScdl->tidActiveTask = SCDL_NA;
+	hScdl->ucNumTasks = 0;
+	hScdl->ulSystemTicks = 0;
+#ifdef SCDL_EDF
+	hScdl->ucNumReady = 0;
+#endif
+#ifdef SCDL_WORK_STEALING
+	hScdl->bStealable = 0;
+#endif
+#ifdef SCDL_MODES
+	hScdl->ptMode = SCDL_MODE_ALL;
+	hScdl->bModeSwitch = 0;
+#endif
+}
+#endif
+
+#ifdef SCDL_MULTI_INSTANCE
+/*! **********************************************************************************
+ * @fn		vScdlInit
+ *
+ * @brief	Initialize an instance and register it for vScdlTickAll, call it once
+ * 			for every instance including SCDL_DEFAULT before tasks are created
+ *
+ * @param	hScdl instance
+ *
+ */
+void vScdlInit(scdlHandle_t hScdl)
+{
+	struct typScheduler *ptInstance;
+	scdlIrqState_t tIrqState;
+
+	vScdlReset(hScdl);
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	for(ptInstance = g_ptScdlInstances; ptInstance; ptInstance = ptInstance->ptNext)
+		SCDL_ASSERT(ptInstance != hScdl);
+	hScdl->ptNext = g_ptScdlInstances;
+	g_ptScdlInstances = hScdl;
+	SCDL_EXIT_CRITICAL(tIrqState);
+}
+#endif
+
+#ifdef SCDL_WORK_STEALING
+/*! **********************************************************************************
+ * @fn		vScdlSetStealable
+ *
+ * @brief	Allow idle instances to run ready tasks of this instance. Its tasks may
+ * 			then run in parallel to each other and on any thread, so they must not
+ * 			rely on the cooperative scheduling for mutual exclusion.
+ *
+ * @param	hScdl instance
+ *
+ * 			bStealable 1 to allow, 0 to forbid
+ *
+ */
+void vScdlSetStealable(scdlHandle_t hScdl, unsigned char bStealable)
+{
+	hScdl->bStealable = bStealable;
+}
+#endif
+
+#ifndef SCDL_STATIC_TASKS
+/*! **********************************************************************************
+ * @fn		tidScdlCreateTask
+ *
+ * @brief	Create a Task. First task created has highest priority.
+ *
+ * @param	hScdl instance, SCDL_DEFAULT for tidCreateTask
+ *
+ * 			vTaskFunc the "TASK"
+ *
+ * 			ulPeriod period for cyclic calls in ticks. SCDL_INF_PERIOD for single call.
+ *
+ * @return	TaskHandle-ID, unique within the instance
+ */
+taskID_t tidScdlCreateTask(scdlHandle_t hScdl, void (*vTaskFunc)(void), unsigned long ulPeriod)
+{
+	struct typTask tTaskHandle;
+	taskID_t tidNew;
+#ifdef SCDL_MODES
+	scdlIrqState_t tIrqState;
+#endif
+
+	SCDL_ASSERT((ulPeriod > 0 && ulPeriod <= SCDL_MAX_TASK_PERIOD) || ulPeriod == SCDL_INF_PERIOD);
+	SCDL_ASSERT(hScdl->ucNumTasks < SCDL_MAX_NUM_TASKS);
+
+	tidNew = hScdl->ucNumTasks;
+	tTaskHandle.vTaskFunc = vTaskFunc;
+	tTaskHandle.ulTaskPeriod = ulPeriod;
+	tTaskHandle.eTaskState = OFF;
+	tTaskHandle.ulNextStartTime = 0;
+#if defined(SCDL_EDF) || defined(SCDL_AUTO_PRIO)
+	tTaskHandle.ulRelDeadline = 0;
+#endif
+#ifdef SCDL_URGENT_TASKS
+	tTaskHandle.bUrgent = 0;
+#endif
+#ifdef SCDL_TASK_CHAINS
+	tTaskHandle.tSuccessors = 0;
+	tTaskHandle.tPredecessors = 0;
+	tTaskHandle.tPredDone = 0;
+#endif
+
+	hScdl->atTask[tidNew] = tTaskHandle;
+#ifdef SCDL_AUTO_PRIO
+	hScdl->atidPrioOrder[tidNew] = tidNew;
+#endif
+
+	hScdl->ucNumTasks += 1;
+
+#ifdef SCDL_AUTO_PRIO
+	/* appended with the lowest priority, move it to its place */
+	vScdlReorderSafe(hScdl, tidNew);
+#endif
+
+#ifdef SCDL_MODES
+	/* new tasks are ready to run if in the current mode, else the switch to a mode with them releases them */
+	SCDL_ENTER_CRITICAL(tIrqState);
+	if(SCDL_IN_MODE(hScdl, tidNew))
+		vScdlSetState(hScdl, tidNew, READY);
+	SCDL_EXIT_CRITICAL(tIrqState);
+#else
+	/* new tasks are ready to run */
+	vScdlSetStateSafe(hScdl, tidNew, READY);
+#endif
+
+	return tidNew;
+}
+#endif
+
+/*! **********************************************************************************
+ * @fn		vScdlTaskSetState
+ *
+ * @brief	Set Task state
+ *
+ * @param	hScdl instance, SCDL_DEFAULT for vTaskSetState
+ *
+ * 			taskID unique TASK-ID
+ *
+ * 			eState OFF,	READY, (ACTIVE not allowed), BLOCKED
+ *
+ */
+void vScdlTaskSetState(scdlHandle_t hScdl, taskID_t taskID, enum etypTaskStates eState)
+{
+#ifdef SCDL_MODES
+	scdlIrqState_t tIrqState;
+#endif
+
+	/* we have a cooperative scheduler, so directly setting to active is not allowed */
+	SCDL_ASSERT(eState != ACTIVE);
+
+	/* is id initialized */
+	SCDL_ASSERT(taskID != SCDL_NA);
+
+	if(taskID < SCDL_NUM_TASKS(hScdl))
+	{
+		/* a non periodic task has no start time to wait for */
+		if(eState == BLOCKED && SCDL_TASK_PERIOD(hScdl, taskID) == SCDL_INF_PERIOD)
+			eState = OFF;
+
+#ifdef SCDL_MODES
+		/* tasks outside the current mode are not released, checked atomically with the switch */
+		SCDL_ENTER_CRITICAL(tIrqState);
+		if(eState == READY && !SCDL_IN_MODE(hScdl, taskID))
+			eState = OFF;
+		else
+			vScdlSetState(hScdl, taskID, eState);
+		SCDL_EXIT_CRITICAL(tIrqState);
+#else
+		vScdlSetStateSafe(hScdl, taskID, eState);
+#endif
+
+#ifdef SCDL_URGENT_TASKS
+		if(eState == READY && hScdl->atTask[taskID].bUrgent)
+			SCDL_PORT_PEND_URGENT();
+#endif
+	}
+}
+
+#ifdef SCDL_URGENT_TASKS
+/*! **********************************************************************************
+ * @fn		vScdlTaskSetUrgent
+ *
+ * @brief	Move a task to the urgent tier or back, before the scheduler is started
+ * 			or while the task is not ACTIVE. A ready urgent task is started by the next tick.
+ *
+ * @param	hScdl instance, SCDL_DEFAULT for vTaskSetUrgent
+ *
+ * 			taskID unique TASK-ID
+ *
+ * 			bUrgent 1 to run the task from the urgent software interrupt
+ *
+ */
+void vScdlTaskSetUrgent(scdlHandle_t hScdl, taskID_t taskID, unsigned char bUrgent)
+{
+	SCDL_ASSERT(taskID < SCDL_NUM_TASKS(hScdl));
+
+	hScdl->atTask[taskID].bUrgent = bUrgent;
+}
+#endif
+
+#ifdef SCDL_TASK_CHAINS
+/*! **********************************************************************************
+ * @fn		vScdlTaskChain
+ *
+ * @brief	Release a task whenever another one completes. Chaining a task to several
+ * 			predecessors makes it wait for all of them.
+ *
+ * @param	hScdl instance of both tasks, SCDL_DEFAULT for vTaskChain
+ *
+ * 			tidPred predecessor
+ *
+ * 			tidSucc successor, released once all its predecessors completed
+ *
+ */
+void vScdlTaskChain(scdlHandle_t hScdl, taskID_t tidPred, taskID_t tidSucc)
+{
+	scdlIrqState_t tIrqState;
+
+	SCDL_ASSERT(tidPred < SCDL_NUM_TASKS(hScdl));
+	SCDL_ASSERT(tidSucc < SCDL_NUM_TASKS(hScdl));
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	hScdl->atTask[tidPred].tSuccessors |= SCDL_TASK_BIT(tidSucc);
+	hScdl->atTask[tidSucc].tPredecessors |= SCDL_TASK_BIT(tidPred);
+	SCDL_EXIT_CRITICAL(tIrqState);
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlTaskUnchain
+ *
+ * @brief	Remove a link set by vScdlTaskChain, a join waiting for the removed
+ * 			predecessor only is released on the completion of its next predecessor
+ *
+ * @param	hScdl instance of both tasks, SCDL_DEFAULT for vTaskUnchain
+ *
+ * 			tidPred predecessor
+ *
+ * 			tidSucc successor
+ *
+ */
+void vScdlTaskUnchain(scdlHandle_t hScdl, taskID_t tidPred, taskID_t tidSucc)
+{
+	scdlIrqState_t tIrqState;
+
+	SCDL_ASSERT(tidPred < SCDL_NUM_TASKS(hScdl));
+	SCDL_ASSERT(tidSucc < SCDL_NUM_TASKS(hScdl));
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	hScdl->atTask[tidPred].tSuccessors &= ~SCDL_TASK_BIT(tidSucc);
+	hScdl->atTask[tidSucc].tPredecessors &= ~SCDL_TASK_BIT(tidPred);
+	hScdl->atTask[tidSucc].tPredDone &= ~SCDL_TASK_BIT(tidPred);
+	SCDL_EXIT_CRITICAL(tIrqState);
+}
+#endif
+
+/*! **********************************************************************************
+ * @fn		vScdlSwitchAllTasksOff
+ *
+ * @brief	set states of each task to OFF, be careful that you activate at least one task after this call to prevent a dead lock
+ *
+ * @param	hScdl instance, SCDL_DEFAULT for vSwitchAllTasksOff
+ *
+ */
+void vScdlSwitchAllTasksOff(scdlHandle_t hScdl)
+{
+	unsigned short i;
+	for (i = 0; i < SCDL_NUM_TASKS(hScdl); i++)
+	{
+		vScdlSetStateSafe(hScdl, i, OFF);
+	}
+}
+
+#ifdef SCDL_MODES
+/*! **********************************************************************************
+ * @fn		vScdlSetMode
+ *
+ * @brief	Request a mode switch, O(1), may be called from tasks and ISRs. The next tick
+ * 			switches, of several requests before it the last one counts.
+ *
+ * @param	hScdl instance, SCDL_DEFAULT for vSetMode
+ *
+ * 			ptMode mode, must stay valid while it is in effect, SCDL_MODE_ALL for all tasks
+ *
+ */
+void vScdlSetMode(scdlHandle_t hScdl, const struct typScdlMode *ptMode)
+{
+	scdlIrqState_t tIrqState;
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	hScdl->ptNextMode = ptMode;
+	hScdl->bModeSwitch = 1;
+	SCDL_EXIT_CRITICAL(tIrqState);
+}
+
+/*! **********************************************************************************
+ * @fn		ptScdlGetMode
+ *
+ * @brief	Get the mode in effect, a requested one shows up after the next tick
+ *
+ * @param	hScdl instance, SCDL_DEFAULT for ptGetMode
+ *
+ * @return	mode, SCDL_MODE_ALL before the first switch
+ */
+const struct typScdlMode *ptScdlGetMode(scdlHandle_t hScdl)
+{
+	return hScdl->ptMode;
+}
+#endif
+
+#if defined(SCDL_EDF) || defined(SCDL_AUTO_PRIO)
+/*! **********************************************************************************
+ * @fn		vScdlTaskSetDeadline
+ *
+ * @brief	Set the deadline of a task relative to its release, with SCDL_EDF used from the
+ * 			next release on, with SCDL_AUTO_PRIO the priority order is updated
+ *
+ * @param	hScdl instance, SCDL_DEFAULT for vTaskSetDeadline
+ *
+ * 			taskID unique TASK-ID
+ *
+ * 			ulDeadline relative deadline in ticks, 0 for the period
+ *
+ */
+void vScdlTaskSetDeadline(scdlHandle_t hScdl, taskID_t taskID, unsigned long ulDeadline)
+{
+	SCDL_ASSERT(taskID < SCDL_NUM_TASKS(hScdl));
+	SCDL_ASSERT(ulDeadline <= SCDL_MAX_TASK_PERIOD);
+
+	hScdl->atTask[taskID].ulRelDeadline = ulDeadline;
+#ifdef SCDL_AUTO_PRIO
+	vScdlReorderSafe(hScdl, taskID);
+#endif
+}
+#endif
+
+#if !(defined(SCDL_STATIC_TASKS) && defined(SCDL_CONST_PERIODS))
+/*! **********************************************************************************
+ * @fn		vScdlTaskSetPeriod
+ *
+ * @brief	Set Task period in ticks
+ *
+ * @param	hScdl instance, SCDL_DEFAULT for vTaskSetPeriod
+ *
+ * 			taskID unique TASK-ID
+ *
+ * 			ulPeriod period in ticks, SCDL_INF_PERIOD for single call
+ *
+ */
+void vScdlTaskSetPeriod(scdlHandle_t hScdl, taskID_t taskID, unsigned long ulPeriod)
+{
+	/* check if ID is okay */
+	SCDL_ASSERT(taskID < SCDL_NUM_TASKS(hScdl));
+	SCDL_ASSERT((ulPeriod > 0 && ulPeriod <= SCDL_MAX_TASK_PERIOD) || ulPeriod == SCDL_INF_PERIOD);
+
+	hScdl->atTask[taskID].ulTaskPeriod = ulPeriod;
+#ifdef SCDL_AUTO_PRIO
+	vScdlReorderSafe(hScdl, taskID);
+#endif
+}
+#endif
+
+/*! **********************************************************************************
+ * @fn		vScdlTaskInvokeDelayed
+ *
+ * @brief	Start task later
+ *
+ * @param	hScdl instance, SCDL_DEFAULT for vTaskInvokeDelayed
+ *
+ * 			taskID unique TASK-ID
+ *
+ * 			delay in ticks
+ *
+ */
+void vScdlTaskInvokeDelayed(scdlHandle_t hScdl, taskID_t taskID, unsigned long ulDelay)
+{
+
+	scdlTicks_t ulNextStart;
+	scdlIrqState_t tIrqState;
+
+	/* check if ID is okay */
+	SCDL_ASSERT(taskID < SCDL_NUM_TASKS(hScdl));
+	/* start time must be within half the counter range */
+	SCDL_ASSERT(ulDelay <= SCDL_MAX_TASK_PERIOD);
+
+	if(taskID < SCDL_NUM_TASKS(hScdl))
+	{
+		/* start time and state must not be seen half written by the tick */
+		SCDL_ENTER_CRITICAL(tIrqState);
+		ulNextStart = hScdl->ulSystemTicks + ulDelay;
+		hScdl->atTask[taskID].ulNextStartTime = ulNextStart;
+		/* switch on if not active yet, a non periodic task delaying itself would be
+		   switched off after it returns */
+		if(hScdl->atTask[taskID].eTaskState == OFF || (hScdl->atTask[taskID].eTaskState == ACTIVE
+				&& SCDL_TASK_PERIOD(hScdl, taskID) == SCDL_INF_PERIOD))
+			vScdlSetState(hScdl, taskID, BLOCKED);
+		SCDL_EXIT_CRITICAL(tIrqState);
+	}
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlTaskSetPhase
+ *
+ * @brief	Delay the first release of a task, tasks with the same phase are released
+ * 			on the same tick. Phase 0 is the first tick, like a newly created task.
+ *
+ * @param	hScdl instance, SCDL_DEFAULT for vTaskSetPhase
+ *
+ * 			taskID unique TASK-ID
+ *
+ * 			ulPhase offset in ticks, less than the period
+ *
+ */
+void vScdlTaskSetPhase(scdlHandle_t hScdl, taskID_t taskID, unsigned long ulPhase)
+{
+	scdlIrqState_t tIrqState;
+
+	SCDL_ASSERT(taskID < SCDL_NUM_TASKS(hScdl));
+	SCDL_ASSERT(ulPhase <= SCDL_MAX_TASK_PERIOD);
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	hScdl->atTask[taskID].ulNextStartTime = hScdl->ulSystemTicks + 1 + ulPhase;
+	/* an OFF task keeps its phase for vTaskSetState(id, BLOCKED) */
+	if(hScdl->atTask[taskID].eTaskState == READY)
+		vScdlSetState(hScdl, taskID, BLOCKED);
+	SCDL_EXIT_CRITICAL(tIrqState);
+}
+
+#ifdef SCDL_AUTO_PHASE
+static unsigned long ulScdlGcd(unsigned long a, unsigned long b)
+{
+	unsigned long t;
+
+	while(b)
+	{
+		t = a % b;
+		a = b;
+		b = t;
+	}
+
+	return a;
+}
+
+/*
+ * periodic tasks which will be released, phases are only assigned to these
+ */
+static unsigned char bScdlIsPhased(struct typScheduler *ptScdl, taskID_t tid)
+{
+	return SCDL_TASK_PERIOD(ptScdl, tid) != SCDL_INF_PERIOD &&
+			(ptScdl->atTask[tid].eTaskState == READY || ptScdl->atTask[tid].eTaskState == BLOCKED);
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlAutoPhase
+ *
+ * @brief	Assign phase offsets to all periodic, not switched off tasks in priority
+ * 			order. Two tasks with periods Ti, Tj and phases oi, oj are released together
+ * 			at some time exactly if oi = oj modulo gcd(Ti, Tj). Each task gets the
+ * 			smallest phase colliding with the fewest tasks placed before it, the result
+ * 			can be checked with ucScdlPeakReleases.
+ *
+ * @param	hScdl instance
+ *
+ */
+void vScdlAutoPhase(scdlHandle_t hScdl)
+{
+	unsigned long aulPhase[SCDL_MAX_NUM_TASKS];
+	unsigned long ulPeriod, ulGcd, ulRepeat, ulPhase, ulBest;
+	unsigned char ucCost, ucBestCost;
+	unsigned char k, m;
+	taskID_t i, j;
+
+	for(k = 0; k < SCDL_NUM_TASKS(hScdl); k++)
+	{
+		i = SCDL_PRIO_TASK(hScdl, k);
+		if(!bScdlIsPhased(hScdl, i))
+			continue;
+
+		ulPeriod = SCDL_TASK_PERIOD(hScdl, i);
+
+		/* the collision pattern repeats with the lcm of the gcds, never beyond the period */
+		ulRepeat = 1;
+		for(m = 0; m < k; m++)
+		{
+			j = SCDL_PRIO_TASK(hScdl, m);
+			if(!bScdlIsPhased(hScdl, j))
+				continue;
+			ulGcd = ulScdlGcd(ulPeriod, SCDL_TASK_PERIOD(hScdl, j));
+			ulGcd = ulGcd / ulScdlGcd(ulRepeat, ulGcd);
+			ulRepeat = (ulRepeat > ulPeriod / ulGcd) ? ulPeriod : ulRepeat * ulGcd;
+		}
+
+		ulBest = 0;
+		ucBestCost = SCDL_NA;
+		for(ulPhase = 0; ulPhase < ulRepeat && ucBestCost; ulPhase++)
+		{
+			ucCost = 0;
+			for(m = 0; m < k; m++)
+			{
+				j = SCDL_PRIO_TASK(hScdl, m);
+				if(!bScdlIsPhased(hScdl, j))
+					continue;
+				ulGcd = ulScdlGcd(ulPeriod, SCDL_TASK_PERIOD(hScdl, j));
+				if(ulPhase % ulGcd == aulPhase[m] % ulGcd)
+					ucCost++;
+			}
+			if(ucCost < ucBestCost)
+			{
+				ucBestCost = ucCost;
+				ulBest = ulPhase;
+			}
+		}
+
+		aulPhase[k] = ulBest;
+		vScdlTaskSetPhase(hScdl, i, ulBest);
+	}
+}
+
+/*! **********************************************************************************
+ * @fn		ucScdlPeakReleases
+ *
+ * @brief	Largest number of tasks released on the same tick within the next ulWindow
+ * 			ticks, derived from the next start times. Use the hyperperiod (lcm of all
+ * 			periods) as window for an exact result. Runs in O(ulWindow * tasks), meant
+ * 			for start up checks and host simulations.
+ *
+ * @param	hScdl instance
+ *
+ * 			ulWindow number of ticks to check
+ *
+ * @return	peak number of simultaneous releases
+ */
+unsigned char ucScdlPeakReleases(scdlHandle_t hScdl, unsigned long ulWindow)
+{
+	scdlTicks_t ulTime, ulFirst;
+	unsigned long ulSince;
+	unsigned char ucCount, ucPeak = 0;
+	unsigned char i;
+
+	for(ulTime = hScdl->ulSystemTicks + 1; ulWindow; ulTime++, ulWindow--)
+	{
+		ucCount = 0;
+		for(i = 0; i < SCDL_NUM_TASKS(hScdl); i++)
+		{
+			if(!bScdlIsPhased(hScdl, i))
+				continue;
+
+			/* a ready task is released on the next tick */
+			ulFirst = (hScdl->atTask[i].eTaskState == READY) ?
+					hScdl->ulSystemTicks + 1 : hScdl->atTask[i].ulNextStartTime;
+			if(!SCDL_TIME_REACHED(ulTime, ulFirst))
+				continue;
+
+			ulSince = ulTime - ulFirst;
+			if(ulSince % SCDL_TASK_PERIOD(hScdl, i) == 0)
+				ucCount++;
+		}
+		if(ucCount > ucPeak)
+			ucPeak = ucCount;
+	}
+
+	return ucPeak;
+}
+#endif
+
+/*
+ * release blocked tasks whose start time is reached, only called from the tick
+ * because time does not change anywhere else
+ */
+static void vScdlRelease(struct typScheduler *ptScdl)
+{
+	struct typTask *ptTaskHandle;
+	unsigned char i;
+	unsigned char numTasks = SCDL_NUM_TASKS(ptScdl);
+	scdlTicks_t ulNow = ptScdl->ulSystemTicks;
+#ifdef SCDL_URGENT_TASKS
+	unsigned char bUrgent = 0;
+#endif
+#ifdef SCDL_MODES
+	scdlTaskMask_t tEntering = 0;
+
+	/* the switch point, nothing of this tick has been released or started yet */
+	if(ptScdl->bModeSwitch)
+	{
+		tEntering = ~SCDL_MODE_TASKS(ptScdl);
+		ptScdl->ptMode = ptScdl->ptNextMode;
+		ptScdl->bModeSwitch = 0;
+		tEntering &= SCDL_MODE_TASKS(ptScdl);
+	}
+#endif
+
+	for(i = 0; i < numTasks; i++)
+	{
+		ptTaskHandle = &ptScdl->atTask[i];
+
+#ifdef SCDL_MODES
+		if(!SCDL_IN_MODE(ptScdl, i))
+		{
+			/* also catches tasks made ready before the switch */
+			if(ptTaskHandle->eTaskState == READY)
+				vScdlSetState(ptScdl, i, OFF);
+			continue;
+		}
+		if((tEntering & SCDL_TASK_BIT(i)) && ptTaskHandle->eTaskState != ACTIVE &&
+				SCDL_TASK_PERIOD(ptScdl, i) != SCDL_INF_PERIOD)
+			vScdlSetState(ptScdl, i, READY);
+#endif
+
+		/* check if a blocked task reached its next start time, wrap safe */
+		if(ptTaskHandle->eTaskState == BLOCKED && SCDL_TIME_REACHED(ulNow, ptTaskHandle->ulNextStartTime))
+			vScdlSetState(ptScdl, i, READY);
+
+#ifdef SCDL_URGENT_TASKS
+		/* also catches tasks made ready before the port was running */
+		if(ptTaskHandle->bUrgent && ptTaskHandle->eTaskState == READY)
+			bUrgent = 1;
+#endif
+	}
+
+#ifdef SCDL_URGENT_TASKS
+	/* runs when the tick ISR returns */
+	if(bUrgent)
+		SCDL_PORT_PEND_URGENT();
+#endif
+}
+
+/*
+ * find the ready task with the highest priority, only reads the task list.
+ * Urgent tasks are left to vScdlUrgentDispatch.
+ */
+static taskID_t tidScdlFindReady(struct typScheduler *ptScdl)
+{
+#ifdef SCDL_EDF
+	/* earliest deadline on top of the heap */
+	return ptScdl->ucNumReady ? ptScdl->atidReadyHeap[0] : SCDL_NA;
+#else
+	unsigned char i;
+	taskID_t tid;
+	unsigned char numTasks = SCDL_NUM_TASKS(ptScdl);
+
+	for(i = 0; i < numTasks; i++)
+	{
+		tid = SCDL_PRIO_TASK(ptScdl, i);
+#ifdef SCDL_URGENT_TASKS
+		if(ptScdl->atTask[tid].eTaskState == READY && !ptScdl->atTask[tid].bUrgent)
+#else
+		if(ptScdl->atTask[tid].eTaskState == READY)
+#endif
+			return tid;
+	}
+
+	return SCDL_NA;
+#endif
+}
+
+/*
+ * set a ready task active and calculate its next start, interrupts must be disabled
+ */
+static void vScdlMarkActive(struct typScheduler *ptScdl, taskID_t tidReadyTaskID)
+{
+	struct typTask *ptTaskHandle;
+
+	/* set pointer on active task handle */
+	ptTaskHandle = &ptScdl->atTask[tidReadyTaskID];
+	/* set state to active*/
+	vScdlSetState(ptScdl, tidReadyTaskID, ACTIVE);
+	/* set the next start time of a periodic task, the counter may wrap in between */
+	if( SCDL_TASK_PERIOD(ptScdl, tidReadyTaskID) != SCDL_INF_PERIOD)
+		ptTaskHandle->ulNextStartTime = ptScdl->ulSystemTicks + SCDL_TASK_PERIOD(ptScdl, tidReadyTaskID);
+}
+
+/*
+ * make a ready task the active one, interrupts must be disabled
+ */
+static void vScdlActivate(struct typScheduler *ptScdl, taskID_t tidReadyTaskID)
+{
+	/* switch to active --> start Task*/
+	ptScdl->tidActiveTask = tidReadyTaskID;
+	vScdlMarkActive(ptScdl, tidReadyTaskID);
+}
+
+#ifdef SCDL_TASK_CHAINS
+/*
+ * a task completed: release those successors whose predecessors have all completed now.
+ * Interrupts must be disabled.
+ */
+static void vScdlChainDone(struct typScheduler *ptScdl, taskID_t tidTask)
+{
+	scdlTaskMask_t tSuccessors = ptScdl->atTask[tidTask].tSuccessors;
+	struct typTask *ptSucc;
+	taskID_t tidSucc;
+
+	for(tidSucc = 0; tSuccessors; tidSucc++, tSuccessors >>= 1)
+	{
+		if(!(tSuccessors & 1))
+			continue;
+
+		ptSucc = &ptScdl->atTask[tidSucc];
+		ptSucc->tPredDone |= SCDL_TASK_BIT(tidTask);
+		if((ptSucc->tPredDone & ptSucc->tPredecessors) != ptSucc->tPredecessors)
+			continue;
+#ifdef SCDL_MODES
+		if(!SCDL_IN_MODE(ptScdl, tidSucc))
+			continue;
+#endif
+
+		ptSucc->tPredDone = 0;
+		vScdlSetState(ptScdl, tidSucc, READY);
+#ifdef SCDL_URGENT_TASKS
+		if(ptSucc->bUrgent)
+			SCDL_PORT_PEND_URGENT();
+#endif
+	}
+}
+#endif
+
+/*
+ * after funcall set back to blocked, if still active (could be changed from inside),
+ * a non periodic task has nothing to wait for and is switched off. Chained successors
+ * are released here, before the next task is searched. Interrupts must be disabled.
+ */
+static void vScdlMarkDone(struct typScheduler *ptScdl, taskID_t tidTask)
+{
+	if(ptScdl->atTask[tidTask].eTaskState == ACTIVE)
+		vScdlSetState(ptScdl, tidTask, (SCDL_TASK_PERIOD(ptScdl, tidTask) == SCDL_INF_PERIOD) ? OFF : BLOCKED);
+#ifdef SCDL_TASK_CHAINS
+	if(ptScdl->atTask[tidTask].tSuccessors)
+		vScdlChainDone(ptScdl, tidTask);
+#endif
+}
+
+/*
+ * scheduler pass of the tick ISR: release due tasks and start one if none is active
+ */
+static void vScheduler(struct typScheduler *ptScdl)
+{
+	taskID_t tidReadyTaskID;
+
+	vScdlRelease(ptScdl);
+
+	if(ptScdl->tidActiveTask != SCDL_NA)/* there is an active task */
+		return;
+
+	tidReadyTaskID = tidScdlFindReady(ptScdl);
+	if(tidReadyTaskID != SCDL_NA)/* there is a ready task */
+		vScdlActivate(ptScdl, tidReadyTaskID);
+}
+
+#ifdef SCDL_URGENT_TASKS
+/*! **********************************************************************************
+ * @fn		vScdlUrgentDispatch
+ *
+ * @brief	run all ready urgent tasks in priority order, called by the port from the
+ * 			urgent software interrupt with interrupts enabled
+ *
+ */
+void vScdlUrgentDispatch(void)
+{
+	struct typScheduler *ptScdl = SCDL_DEFAULT;
+	unsigned char i;
+	taskID_t tidTask;
+	scdlIrqState_t tIrqState;
+
+	do
+	{
+		tidTask = SCDL_NA;
+
+		SCDL_ENTER_CRITICAL(tIrqState);
+		for(i = 0; i < SCDL_NUM_TASKS(ptScdl); i++)
+		{
+			if(ptScdl->atTask[SCDL_PRIO_TASK(ptScdl, i)].bUrgent &&
+					ptScdl->atTask[SCDL_PRIO_TASK(ptScdl, i)].eTaskState == READY)
+			{
+				tidTask = SCDL_PRIO_TASK(ptScdl, i);
+				vScdlMarkActive(ptScdl, tidTask);
+				break;
+			}
+		}
+		SCDL_EXIT_CRITICAL(tIrqState);
+
+		if(tidTask != SCDL_NA)
+		{
+			SCDL_HOOK_TASK_START(ptScdl, tidTask);
+			SCDL_TASK_FUNC(ptScdl, tidTask)();
+			SCDL_HOOK_TASK_STOP(ptScdl, tidTask);
+
+			SCDL_ENTER_CRITICAL(tIrqState);
+			vScdlMarkDone(ptScdl, tidTask);
+			SCDL_EXIT_CRITICAL(tIrqState);
+		}
+	} while(tidTask != SCDL_NA);
+}
+#endif
+
+#ifdef SCDL_WORK_STEALING
+/*
+ * run one ready task of another stealable instance on this thread. The task is
+ * ACTIVE in its own instance meanwhile, so it is neither dispatched there nor
+ * stolen twice, the owner keeps its own active task.
+ */
+static unsigned char bScdlSteal(struct typScheduler *ptScdl)
+{
+	struct typScheduler *ptVictim;
+	taskID_t tidTask;
+	unsigned char bTaken;
+	scdlIrqState_t tIrqState;
+
+	for(ptVictim = g_ptScdlInstances; ptVictim; ptVictim = ptVictim->ptNext)
+	{
+		if(ptVictim == ptScdl || !ptVictim->bStealable)
+			continue;
+
+		/* search unlocked, the lock is only taken for a candidate */
+		tidTask = tidScdlFindReady(ptVictim);
+		if(tidTask == SCDL_NA)
+			continue;
+
+		SCDL_ENTER_CRITICAL(tIrqState);
+		bTaken = (ptVictim->atTask[tidTask].eTaskState == READY);
+		if(bTaken)
+			vScdlMarkActive(ptVictim, tidTask);
+		SCDL_EXIT_CRITICAL(tIrqState);
+
+		if(!bTaken)
+			continue;
+
+		SCDL_HOOK_TASK_START(ptVictim, tidTask);
+		SCDL_TASK_FUNC(ptVictim, tidTask)();
+		SCDL_HOOK_TASK_STOP(ptVictim, tidTask);
+
+		SCDL_ENTER_CRITICAL(tIrqState);
+		vScdlMarkDone(ptVictim, tidTask);
+		SCDL_EXIT_CRITICAL(tIrqState);
+
+		return 1;
+	}
+
+	return 0;
+}
+#endif
+
+/*! **********************************************************************************
+ * @fn		vScdlRun
+ *
+ * @brief	run the scheduler of an instance -> does not return!
+ *
+ * @param	hScdl instance, SCDL_DEFAULT for vStartScheduler
+ *
+ */
+void vScdlRun(scdlHandle_t hScdl)
+{
+	volatile unsigned char tidActiveTask = SCDL_NA;
+	taskID_t tidReadyTask;
+	unsigned char bIdle = 0;
+	scdlIrqState_t tIrqState;
+#ifdef SCDL_MEASURE_ACTIVITY
+	unsigned long ulStart;
+#endif
+
+#if defined(SCDL_AUTO_PRIO) && defined(SCDL_STATIC_TASKS)
+	vScdlSortPrio(hScdl);
+#endif
+
+#ifdef SCDL_MEASURE_STACK
+	vScdlStackPaint();
+#endif
+
+#ifdef SCDL_BOOT_STAGES
+	/* fast boot, the first ready task does not wait for the first tick */
+	SCDL_ENTER_CRITICAL(tIrqState);
+	tidReadyTask = tidScdlFindReady(hScdl);
+	if(hScdl->tidActiveTask == SCDL_NA && tidReadyTask != SCDL_NA)
+		vScdlActivate(hScdl, tidReadyTask);
+	SCDL_EXIT_CRITICAL(tIrqState);
+	/* the boot task is ready at least, so the loop starts with a task */
+	if(hScdl->tidActiveTask != SCDL_NA)
+		vScdlBootFirstTask();
+#endif
+
+	for(;;)
+	{
+		tidActiveTask = hScdl->tidActiveTask;
+
+		/* check if theres an active task or not*/
+		if(tidActiveTask == SCDL_NA)
+		{
+			/* we are not in idle mode yet -> call the hook */
+			if(!bIdle)
+				SCDL_HOOK_IDLE_ENTER(hScdl);
+
+			/* set idle flag*/
+			bIdle = 1;
+
+#ifdef SCDL_WORK_STEALING
+			/* help busy instances before going to sleep */
+			if(bScdlSteal(hScdl))
+				continue;
+#endif
+
+#ifdef SCDL_IDLE_SLEEP
+			/* sleep until the next interrupt, recheck with interrupts off to not miss a wake up */
+			SCDL_PORT_DISABLE_INTERRUPTS();
+			if(hScdl->tidActiveTask == SCDL_NA)
+			{
+#ifdef SCDL_MEASURE_ACTIVITY
+				ulStart = ulScdlPortCycles();
+#endif
+				SCDL_PORT_IDLE_SLEEP();
+#ifdef SCDL_MEASURE_ACTIVITY
+				g_tScdlActivity.ulSleepCycles += ulScdlPortCycles() - ulStart;
+				g_tScdlActivity.ulWakeups++;
+				if(hScdl->tidActiveTask != SCDL_NA)
+					g_tScdlActivity.ulReleaseWakeups++;
+#endif
+			}
+			else
+			{
+				SCDL_PORT_ENABLE_INTERRUPTS();
+			}
+#endif
+		}
+		else
+		{
+			/* first task after idle */
+			if(bIdle)
+				SCDL_HOOK_IDLE_EXIT(hScdl);
+
+			/* reset idle flag */
+			bIdle = 0;
+
+			SCDL_HOOK_TASK_START(hScdl, tidActiveTask);
+
+			/* call task function */
+#ifdef SCDL_MEASURE_ACTIVITY
+			ulStart = ulScdlPortCycles();
+#endif
+			SCDL_TASK_FUNC(hScdl, tidActiveTask)();
+#ifdef SCDL_MEASURE_ACTIVITY
+			g_tScdlActivity.aulTaskCycles[tidActiveTask] += ulScdlPortCycles() - ulStart;
+			g_tScdlActivity.aulTaskRuns[tidActiveTask]++;
+#endif
+
+			SCDL_HOOK_TASK_STOP(hScdl, tidActiveTask);
+
+#ifdef SCDL_MEASURE_STACK
+			vScdlStackTaskDone(tidActiveTask, (unsigned char *)&tIrqState);
+#endif
+
+			/* critical, because Scheduler call from Tick-ISR could occur */
+			SCDL_ENTER_CRITICAL(tIrqState);
+
+			vScdlMarkDone(hScdl, tidActiveTask);
+
+			/* from here on the tick may start the next task itself */
+			hScdl->tidActiveTask = SCDL_NA;
+
+			SCDL_EXIT_CRITICAL(tIrqState);
+
+			/* we finished a task so lets look for the next one to fill the gap until the next tick,
+			   the search runs with interrupts enabled, only the hand over is locked */
+#ifdef SCDL_EDF
+			/* the heap top is a single read, take it under the lock to not miss an earlier release */
+			SCDL_ENTER_CRITICAL(tIrqState);
+			tidReadyTask = tidScdlFindReady(hScdl);
+			if(hScdl->tidActiveTask == SCDL_NA && tidReadyTask != SCDL_NA)
+				vScdlActivate(hScdl, tidReadyTask);
+			SCDL_EXIT_CRITICAL(tIrqState);
+#else
+			tidReadyTask = tidScdlFindReady(hScdl);
+			if(tidReadyTask != SCDL_NA)
+			{
+				SCDL_ENTER_CRITICAL(tIrqState);
+				/* the tick may have started a task meanwhile or the task may have been switched off */
+				if(hScdl->tidActiveTask == SCDL_NA && hScdl->atTask[tidReadyTask].eTaskState == READY)
+					vScdlActivate(hScdl, tidReadyTask);
+				SCDL_EXIT_CRITICAL(tIrqState);
+			}
+#endif
+		}
+	}
+
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlTickOf
+ *
+ * @brief	This function must be called from a systick interrupt every SCDL_TICK_US,
+ * 			vScdlTick does this for the default instance
+ *
+ * @param	hScdl instance
+ *
+ */
+void vScdlTickOf(scdlHandle_t hScdl)
+{
+#ifdef SCDL_MEASURE_IRQ_OFF
+	unsigned long ulStart = ulScdlPortCycles();
+#endif
+
+	hScdl->ulSystemTicks++;
+	SCDL_HOOK_TICK(hScdl);
+#ifdef SCDL_TIMERS
+	if(hScdl == SCDL_DEFAULT)
+		vScdlTimerTick(hScdl->ulSystemTicks);
+#endif
+	vScheduler(hScdl);
+
+#ifdef SCDL_MEASURE_IRQ_OFF
+	ulStart = ulScdlPortCycles() - ulStart;
+	if(ulStart > g_ulScdlTickMax)
+		g_ulScdlTickMax = ulStart;
+#endif
+}
+
+#ifdef SCDL_MULTI_INSTANCE
+/*! **********************************************************************************
+ * @fn		vScdlTickAll
+ *
+ * @brief	tick every instance registered by vScdlInit, for ports with a single
+ * 			tick source for all instances
+ *
+ */
+void vScdlTickAll(void)
+{
+	struct typScheduler *ptInstance;
+
+	for(ptInstance = g_ptScdlInstances; ptInstance; ptInstance = ptInstance->ptNext)
+		vScdlTickOf(ptInstance);
+}
+#endif
+
+#ifdef SCDL_MEASURE_ACTIVITY
+/*! **********************************************************************************
+ * @fn		vScdlGetActivity
+ *
+ * @brief	copy the activity counters, call it from a task
+ *
+ * @param	ptActivity destination
+ *
+ */
+void vScdlGetActivity(struct typScdlActivity *ptActivity)
+{
+	*ptActivity = g_tScdlActivity;
+	ptActivity->ulTicks = ulScdlGetTicks() - g_ulScdlActivityStartTick;
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlResetActivity
+ *
+ * @brief	restart the activity counters, call it from a task
+ *
+ */
+void vScdlResetActivity(void)
+{
+	unsigned char i;
+
+	g_tScdlActivity.ulWakeups = 0;
+	g_tScdlActivity.ulReleaseWakeups = 0;
+	g_tScdlActivity.ulSleepCycles = 0;
+	for(i = 0; i < SCDL_MAX_NUM_TASKS; i++)
+	{
+		g_tScdlActivity.aulTaskCycles[i] = 0;
+		g_tScdlActivity.aulTaskRuns[i] = 0;
+	}
+	g_ulScdlActivityStartTick = ulScdlGetTicks();
+}
+#endif
+
+#ifdef SCDL_MEASURE_IRQ_OFF
+/*
+ * called by SCDL_EXIT_CRITICAL of an outermost critical section
+ */
+void vScdlIrqOffEnd(void)
+{
+	unsigned long ulDuration = ulScdlPortCycles() - g_ulScdlIrqOffStart;
+
+	if(ulDuration > g_ulScdlIrqOffMax)
+		g_ulScdlIrqOffMax = ulDuration;
+}
+
+/*! **********************************************************************************
+ * @fn		ulScdlGetMaxIrqOff
+ *
+ * @brief	longest time interrupts were disabled by a critical section
+ *
+ * @return	duration in port cycles, see SCDL_PORT_CYCLES_PER_MS
+ */
+unsigned long ulScdlGetMaxIrqOff(void)
+{
+	return g_ulScdlIrqOffMax;
+}
+
+/*! **********************************************************************************
+ * @fn		ulScdlGetMaxTickDuration
+ *
+ * @brief	longest run time of the tick handler, interrupts are masked in there too
+ * 			unless the platform nests interrupts
+ *
+ * @return	duration in port cycles, see SCDL_PORT_CYCLES_PER_MS
+ */
+unsigned long ulScdlGetMaxTickDuration(void)
+{
+	return g_ulScdlTickMax;
+}
+
+/*! **********************************************************************************
+ * @fn		vScdlResetIrqOffStats
+ *
+ * @brief	restart the measurement, e.g. after a configuration change
+ *
+ */
+void vScdlResetIrqOffStats(void)
+{
+	scdlIrqState_t tIrqState;
+
+	SCDL_PORT_ENTER_CRITICAL(tIrqState);
+	g_ulScdlIrqOffMax = 0;
+	g_ulScdlTickMax = 0;
+	SCDL_PORT_EXIT_CRITICAL(tIrqState);
+}
+#endif
+
+/*! **********************************************************************************
+ * @fn		ulScdlGetTicksOf
+ *
+ * @brief	read the tick counter, tear free on cpus without atomic 32 bit loads
+ *
+ * @param	hScdl instance, SCDL_DEFAULT for ulScdlGetTicks
+ *
+ * @return	ticks since start, compare times with SCDL_TIME_REACHED
+ */
+scdlTicks_t ulScdlGetTicksOf(scdlHandle_t hScdl)
+{
+	scdlTicks_t ulTicks;
+
+	/* retry if the tick ISR changed the counter between the partial loads */
+	do
+	{
+		ulTicks = hScdl->ulSystemTicks;
+	} while(ulTicks != hScdl->ulSystemTicks);
+
+	return ulTicks;
+}
+
+/*! **********************************************************************************
+ * @fn		usScdlGetTicks16Of
+ *
+ * @brief	low 16 bits of the tick counter, a single load on 16 bit cpus like the MSP430
+ *
+ * @param	hScdl instance, SCDL_DEFAULT for usScdlGetTicks16
+ *
+ * @return	ticks since start modulo 2^16, compare times with SCDL_TIME16_REACHED
+ */
+unsigned short usScdlGetTicks16Of(scdlHandle_t hScdl)
+{
+	return (unsigned short)hScdl->ulSystemTicks;
+}
+
+unsigned char bSemaTake(sema_t *sema)
+{
+	if((*sema)){
+		(*sema) = 0;
+		return 1;
+	}
+	else
+		return 0;
+}
+
+unsigned char bSemaCntTake(sema_t *sema)
+{
+	if((*sema) > 0){
+		(*sema) -= 1;	
+		return 1;
+	}
+	else
+		return 0;
+}
@@ -0,0 +1,298 @@
+/**************************************************************************************************
+  Filename:       debounce.c
+  Author:         $Author: Menz $
+
+  Description:    Bit-sliced debouncer. Generalizes the 2 bit vertical counter of ButtonsPoll
+                  to any number of 32 bit input words and a configurable debounce depth.
+                  Edges are collected by ucDbncUpdate and handed to per-input callbacks by
+                  vDbncDispatch, which is meant to run as a scheduler task.
+
+**************************************************************************************************/
+
+
+/*! @file debounce.c */
+
+
+#include "inc/debounce.h"
+
+/*! **********************************************************************************
+ * @fn		vDbncInit
+ *
+ * @brief	Initialize a debouncer
+ *
+ * @param	ptDbnc debouncer handle
+ *
+ * 			ptWords memory for ucNumWords words
+ *
+ * 			ucNumWords number of 32 bit input words
+ *
+ * 			ucDepth consecutive samples needed for a state change (1..DBNC_MAX_DEPTH)
+ *
+ * 			pulInitial initial debounced state of each word, 0 for all inputs low
+ *
+ */
+void vDbncInit(struct typDebouncer *ptDbnc, struct typDbncWord *ptWords, unsigned char ucNumWords,
+		unsigned char ucDepth, const unsigned long *pulInitial)
+{
+	unsigned char i, k;
+
+	SCDL_ASSERT(ucDepth > 0 && ucDepth <= DBNC_MAX_DEPTH);
+
+	ptDbnc->ptWords = ptWords;
+	ptDbnc->pfnCallbacks = 0;
+	ptDbnc->ucNumWords = ucNumWords;
+	ptDbnc->ucDepth = ucDepth;
+	ptDbnc->tidDispatch = SCDL_NA;
+
+	for(i = 0; i < ucNumWords; i++)
+	{
+		ptWords[i].ulState = pulInitial ? pulInitial[i] : 0;
+		for(k = 0; k < DBNC_COUNTER_BITS; k++)
+			ptWords[i].aulCount[k] = 0;
+		ptWords[i].ulRise = 0;
+		ptWords[i].ulFall = 0;
+	}
+}
+
+/*! **********************************************************************************
+ * @fn		vDbncSetCallbacks
+ *
+ * @brief	Set the callback table and the task dispatching it
+ *
+ * @param	ptDbnc debouncer handle
+ *
+ * 			pfnCallbacks table with one entry per input, entries may be 0
+ *
+ * 			tidDispatch task calling vDbncDispatch, it is set READY when an edge occurs
+ *
+ */
+void vDbncSetCallbacks(struct typDebouncer *ptDbnc, tDbncCallback *pfnCallbacks, taskID_t tidDispatch)
+{
+	unsigned short i;
+
+	if(pfnCallbacks)
+	{
+		for(i = 0; i < ptDbnc->ucNumWords * DBNC_INPUTS_PER_WORD; i++)
+			pfnCallbacks[i] = 0;
+	}
+
+	ptDbnc->pfnCallbacks = pfnCallbacks;
+	ptDbnc->tidDispatch = tidDispatch;
+}
+
+/*! **********************************************************************************
+ * @fn		vDbncSetCallback
+ *
+ * @brief	Set the callback of one input
+ *
+ * @param	ptDbnc debouncer handle
+ *
+ * 			usInput input number, word * DBNC_INPUTS_PER_WORD + bit
+ *
+ * 			pfnCallback function called on every debounced edge of the input
+ *
+ */
+void vDbncSetCallback(struct typDebouncer *ptDbnc, unsigned short usInput, tDbncCallback pfnCallback)
+{
+	SCDL_ASSERT(ptDbnc->pfnCallbacks);
+	SCDL_ASSERT(usInput < ptDbnc->ucNumWords * DBNC_INPUTS_PER_WORD);
+
+	ptDbnc->pfnCallbacks[usInput] = pfnCallback;
+}
+
+/*! **********************************************************************************
+ * @fn		ucDbncUpdate
+ *
+ * @brief	Feed one sample of all inputs, must be called periodically
+ *
+ * 			All 32 inputs of a word are processed in parallel: the counters of inputs
+ * 			differing from the debounced state are incremented, all others are reset.
+ * 			An input whose counter reaches the depth takes over the sampled value.
+ *
+ * @param	ptDbnc debouncer handle
+ *
+ * 			pulRaw array of ucNumWords raw input words
+ *
+ * @return	1 if at least one debounced input changed, 0 otherwise
+ */
+unsigned char ucDbncUpdate(struct typDebouncer *ptDbnc, const unsigned long *pulRaw)
+{
+	struct typDbncWord *ptWord;
+	unsigned long ulDelta, ulCarry, ulNext, ulSettled, ulAny = 0;
+	unsigned char i, k;
+
+	for(i = 0; i < ptDbnc->ucNumWords; i++)
+	{
+		ptWord = &ptDbnc->ptWords[i];
+
+		/* inputs at a different state than the debounced state */
+		ulDelta = pulRaw[i] ^ ptWord->ulState;
+
+		/* nothing to do if all inputs are stable and no counter is running */
+		if(!ulDelta)
+		{
+			for(k = 0; k < DBNC_COUNTER_BITS; k++)
+				ptWord->aulCount[k] = 0;
+			continue;
+		}
+
+		/* increment the counters of the differing inputs, reset the others
+		   and compare every counter against the depth */
+		ulCarry = ulDelta;
+		ulSettled = ulDelta;
+		for(k = 0; k < DBNC_COUNTER_BITS; k++)
+		{
+			ulNext = ptWord->aulCount[k] & ulCarry;
+			ptWord->aulCount[k] = (ptWord->aulCount[k] ^ ulCarry) & ulDelta;
+			ulCarry = ulNext;
+
+			if((ptDbnc->ucDepth >> k) & 1)
+				ulSettled &= ptWord->aulCount[k];
+			else
+				ulSettled &= ~ptWord->aulCount[k];
+		}
+
+		if(!ulSettled)
+			continue;
+
+		/* take over the new state and restart the counters of the settled inputs */
+		ptWord->ulState ^= ulSettled;
+		for(k = 0; k < DBNC_COUNTER_BITS; k++)
+			ptWord->aulCount[k] &= ~ulSettled;
+
+		ptWord->ulRise |= ulSettled & ptWord->ulState;
+		ptWord->ulFall |= ulSettled & ~ptWord->ulState;
+		ulAny |= ulSettled;
+	}
+
+	if(ulAny && ptDbnc->tidDispatch != SCDL_NA)
+		vTaskSetState(ptDbnc->tidDispatch, READY);
+
+	return ulAny ? 1 : 0;
+}
+
+/*! **********************************************************************************
+ * @fn		ucDbncIsSettled
+ *
+ * @brief	Check if the last sample matched the debounced state of every input,
+ * 			i.e. no counter is running and sampling may be suspended
+ *
+ * @param	ptDbnc debouncer handle
+ *
+ * @return	1 if all inputs are settled, 0 otherwise
+ */
+unsigned char ucDbncIsSettled(struct typDebouncer *ptDbnc)
+{
+	unsigned char i, k;
+
+	for(i = 0; i < ptDbnc->ucNumWords; i++)
+	{
+		for(k = 0; k < DBNC_COUNTER_BITS; k++)
+		{
+			if(ptDbnc->ptWords[i].aulCount[k])
+				return 0;
+		}
+	}
+
+	return 1;
+}
+
+/*! **********************************************************************************
+ * @fn		ulDbncGetState
+ *
+ * @brief	Get the debounced state of one word
+ *
+ * @param	ptDbnc debouncer handle
+ *
+ * 			ucWord word index
+ *
+ * @return	debounced state, one bit per input
+ */
+unsigned long ulDbncGetState(struct typDebouncer *ptDbnc, unsigned char ucWord)
+{
+	SCDL_ASSERT(ucWord < ptDbnc->ucNumWords);
+
+	return ptDbnc->ptWords[ucWord].ulState;
+}
+
+/*! **********************************************************************************
+ * @fn		ulDbncTakeEdges
+ *
+ * @brief	Get and clear the pending edges of one word, for use without callbacks
+ *
+ * @param	ptDbnc debouncer handle
+ *
+ * 			ucWord word index
+ *
+ * 			pulFall receives the falling edges, may be 0
+ *
+ * @return	rising edges
+ */
+unsigned long ulDbncTakeEdges(struct typDebouncer *ptDbnc, unsigned char ucWord, unsigned long *pulFall)
+{
+	struct typDbncWord *ptWord;
+	unsigned long ulRise;
+
+	SCDL_ASSERT(ucWord < ptDbnc->ucNumWords);
+
+	ptWord = &ptDbnc->ptWords[ucWord];
+	ulRise = ptWord->ulRise;
+	if(pulFall)
+		*pulFall = ptWord->ulFall;
+	ptWord->ulRise = 0;
+	ptWord->ulFall = 0;
+
+	return ulRise;
+}
+
+/*! **********************************************************************************
+ * @fn		vDbncDispatch
+ *
+ * @brief	Call the callbacks of all pending edges, call it from the dispatch task
+ *
+ * @param	ptDbnc debouncer handle
+ *
+ */
+void vDbncDispatch(struct typDebouncer *ptDbnc)
+{
+	unsigned long ulRise, ulFall, ulState;
+	unsigned short usInput;
+	unsigned char i;
+	tDbncCallback pfnCallback;
+
+	for(i = 0; i < ptDbnc->ucNumWords; i++)
+	{
+		ulRise = ulDbncTakeEdges(ptDbnc, i, &ulFall);
+		ulState = ptDbnc->ptWords[i].ulState;
+
+		if(!ptDbnc->pfnCallbacks)
+			continue;
+
+		for(usInput = i * DBNC_INPUTS_PER_WORD; ulRise | ulFall; usInput++)
+		{
+			pfnCallback = ptDbnc->pfnCallbacks[usInput];
+			if(pfnCallback)
+			{
+				/* an input may have toggled twice since the last dispatch,
+				   the edge to the current state comes last */
+				if(ulState & 1)
+				{
+					if(ulFall & 1)
+						pfnCallback(usInput, 0);
+					if(ulRise & 1)
+						pfnCallback(usInput, 1);
+				}
+				else
+				{
+					if(ulRise & 1)
+						pfnCallback(usInput, 1);
+					if(ulFall & 1)
+						pfnCallback(usInput, 0);
+				}
+			}
+			ulRise >>= 1;
+			ulFall >>= 1;
+			ulState >>= 1;
+		}
+	}
+}
@@ -0,0 +1,66 @@
+/*
+ * debounce.h
+ *
+ *  Bit-sliced debouncer for an arbitrary number of digital inputs.
+ */
+
+/*! @file */
+
+#ifndef DEBOUNCE_H_
+#define DEBOUNCE_H_
+
+#include "inc/scheduler.h"
+
+/** number of bit planes of the vertical counters, limits the debounce depth */
+#define DBNC_COUNTER_BITS		(3)
+/** maximum number of consecutive equal samples required for a state change */
+#define DBNC_MAX_DEPTH			((1 << DBNC_COUNTER_BITS) - 1)
+/** inputs handled in parallel by one word */
+#define DBNC_INPUTS_PER_WORD	(32)
+
+/** callback for a debounced edge, ucState is 1 for a rising edge, 0 for a falling edge */
+typedef void (*tDbncCallback)(unsigned short usInput, unsigned char ucState);
+
+/*!
+ * state of 32 inputs, one bit per input in every member
+ */
+struct typDbncWord
+{
+	/** debounced state */
+	unsigned long ulState;
+	/** vertical counters, bit k of the counter of input n is bit n of aulCount[k] */
+	unsigned long aulCount[DBNC_COUNTER_BITS];
+	/** rising edges not yet dispatched */
+	unsigned long ulRise;
+	/** falling edges not yet dispatched */
+	unsigned long ulFall;
+};
+
+/*!
+ * debouncer handle, memory for words and callbacks is provided by the caller
+ */
+struct typDebouncer
+{
+	/** array of ucNumWords words */
+	struct typDbncWord *ptWords;
+	/** array of ucNumWords * DBNC_INPUTS_PER_WORD callbacks, may be 0 */
+	tDbncCallback *pfnCallbacks;
+	/** number of words */
+	unsigned char ucNumWords;
+	/** consecutive samples needed to accept a new state (1..DBNC_MAX_DEPTH) */
+	unsigned char ucDepth;
+	/** task which dispatches the callbacks, SCDL_NA if none */
+	taskID_t tidDispatch;
+};
+
+void vDbncInit(struct typDebouncer *ptDbnc, struct typDbncWord *ptWords, unsigned char ucNumWords,
+		unsigned char ucDepth, const unsigned long *pulInitial);
+void vDbncSetCallbacks(struct typDebouncer *ptDbnc, tDbncCallback *pfnCallbacks, taskID_t tidDispatch);
+void vDbncSetCallback(struct typDebouncer *ptDbnc, unsigned short usInput, tDbncCallback pfnCallback);
+unsigned char ucDbncUpdate(struct typDebouncer *ptDbnc, const unsigned long *pulRaw);
+unsigned char ucDbncIsSettled(struct typDebouncer *ptDbnc);
+unsigned long ulDbncGetState(struct typDebouncer *ptDbnc, unsigned char ucWord);
+unsigned long ulDbncTakeEdges(struct typDebouncer *ptDbnc, unsigned char ucWord, unsigned long *pulFall);
+void vDbncDispatch(struct typDebouncer *ptDbnc);
+
+#endif /* DEBOUNCE_H_ */
@@ -0,0 +1,29 @@
+/*
+ * inputs.h
+ *
+ *  Interrupt driven, debounced board buttons.
+ */
+
+/*! @file */
+
+#ifndef INPUTS_H_
+#define INPUTS_H_
+
+#include "inc/scheduler.h"
+#include "inc/debounce.h"
+
+/** sample period of the debounce task while inputs are bouncing, ticks */
+#define INPUTS_SAMPLE_PERIOD	SCDL_MS_TO_TICKS(10)
+/** consecutive equal samples for a state change */
+#define INPUTS_DEBOUNCE_DEPTH	(4)
+
+void vInputsInit(taskID_t tidSample, taskID_t tidEvents);
+void vInputsSetCallback(unsigned char ucPin, tDbncCallback pfnCallback);
+unsigned long ulInputsGetState(void);
+
+void vTaskInputSample(void);
+void vTaskInputEvents(void);
+
+void GPIOPortFIntHandler(void);
+
+#endif /* INPUTS_H_ */
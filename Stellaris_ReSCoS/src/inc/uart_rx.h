@@ -0,0 +1,58 @@
+/*
+ * uart_rx.h
+ *
+ *  UART0 receive in batches. The DMA fills one half of a ping-pong buffer
+ *  while the consumer task works on the other. A batch ends when its half
+ *  is full or when the line is idle for the receive timeout, then the
+ *  consumer is set READY and gets the whole batch at once. The half stays
+ *  with the consumer until vUartRxRelease, while both halves are held the
+ *  DMA stops and the hardware FIFO is the only buffer left.
+ *
+ *  	vUartRxInit(tidCreateTask(vTaskRx, SCDL_INF_PERIOD));
+ *
+ *  	vTaskRx:	while((usLen = usUartRxGet(&pucData)) != 0)
+ *  				{
+ *  					... pucData[0 .. usLen - 1] ...
+ *  					vUartRxRelease();
+ *  				}
+ */
+
+/*! @file */
+
+#ifndef UART_RX_H_
+#define UART_RX_H_
+
+#include "inc/scheduler.h"
+#include "inc/uart_rx_hw.h"
+
+/** bytes per half, a multiple of UART_RX_HW_BURST */
+#ifndef UART_RX_BATCH_LEN
+#define UART_RX_BATCH_LEN		(64)
+#endif
+#if (UART_RX_BATCH_LEN % UART_RX_HW_BURST)
+#error UART_RX_BATCH_LEN must be a multiple of UART_RX_HW_BURST
+#endif
+
+/*!
+ * receive statistics, counters saturate at 0xFFFF
+ */
+struct typUartRxStats
+{
+	unsigned long ulBytes;
+	unsigned long ulBatches;
+	/** batches ended by the receive timeout before their half was full */
+	unsigned short usTimeouts;
+	/** times the DMA stopped because the consumer held both halves */
+	unsigned short usStalls;
+	/** overrun errors, each lost at least one byte because the hardware FIFO was full */
+	unsigned short usOverruns;
+};
+
+void vUartRxInit(taskID_t tidConsumer);
+unsigned short usUartRxGet(const unsigned char **ppucData);
+void vUartRxRelease(void);
+void vUartRxGetStats(struct typUartRxStats *ptStats);
+
+void vUartRxIntHandler(void);
+
+#endif /* UART_RX_H_ */
@@ -0,0 +1,34 @@
+/*
+ * uart_rx_hw.h
+ *
+ *  Driver layer below uart_rx.c: UART0 receive by uDMA in ping-pong mode
+ *  into two halves, half 0 on the primary and half 1 on the alternate
+ *  control structure. The DMA only moves bursts of UART_RX_HW_BURST bytes,
+ *  fewer bytes stay in the FIFO until the receive timeout. uart_rx_hw.c
+ *  implements it with driverlib, a host mock can replace it.
+ */
+
+/*! @file */
+
+#ifndef UART_RX_HW_H_
+#define UART_RX_HW_H_
+
+/** bytes per DMA burst, the receive FIFO level */
+#define UART_RX_HW_BURST		(8)
+
+/** events of ucUartRxHwEvents */
+#define UART_RX_HW_TIMEOUT		(0x01)
+#define UART_RX_HW_OVERRUN		(0x02)
+
+void vUartRxHwInit(void);
+void vUartRxHwArm(unsigned char ucHalf, unsigned char *pucBuf, unsigned short usLen);
+unsigned char bUartRxHwDone(unsigned char ucHalf);
+unsigned short usUartRxHwCut(unsigned char ucHalf);
+void vUartRxHwResume(unsigned char ucHalf);
+unsigned char bUartRxHwRunning(void);
+unsigned short usUartRxHwDrain(unsigned char *pucDst, unsigned short usMax);
+unsigned char ucUartRxHwEvents(void);
+void vUartRxHwTimeout(unsigned char bEnable);
+void vUartRxHwIrqEnable(void);
+
+#endif /* UART_RX_HW_H_ */
@@ -0,0 +1,147 @@
+/**************************************************************************************************
+  Filename:       inputs.c
+  Author:         $Author: Menz $
+
+  Description:    Interrupt driven, debounced board buttons. The sample task is OFF while the
+                  buttons are idle. An edge on any button wakes it from the GPIO interrupt, it
+                  then samples every INPUTS_SAMPLE_PERIOD ticks until all inputs are settled and
+                  switches itself off again.
+
+**************************************************************************************************/
+
+
+/*! @file inputs.c */
+
+
+/* low level */
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_ints.h"
+/* driverlib */
+#include "driverlib/interrupt.h"
+#include "driverlib/gpio.h"
+/* addons */
+#include "boards/ek-lm4f120xl/drivers/buttons.h"
+/* project */
+#include "inc/inputs.h"
+
+
+static struct typDebouncer g_tInputs;
+static struct typDbncWord g_tInputWord;
+static tDbncCallback g_pfnInputCallbacks[DBNC_INPUTS_PER_WORD];
+
+static volatile taskID_t g_tidInputSample = SCDL_NA;
+
+static unsigned long ulInputsRead(void)
+{
+	/* buttons are low active */
+	return ~GPIOPinRead(BUTTONS_GPIO_BASE, ALL_BUTTONS) & ALL_BUTTONS;
+}
+
+/*! **********************************************************************************
+ * @fn		vInputsInit
+ *
+ * @brief	Initialize debouncer and edge interrupt, ButtonsInit must have been called
+ *
+ * @param	tidSample task calling vTaskInputSample, period INPUTS_SAMPLE_PERIOD
+ *
+ * 			tidEvents task calling vTaskInputEvents, period SCDL_INF_PERIOD
+ *
+ */
+void vInputsInit(taskID_t tidSample, taskID_t tidEvents)
+{
+	unsigned long ulInitial = ulInputsRead();
+
+	vDbncInit(&g_tInputs, &g_tInputWord, 1, INPUTS_DEBOUNCE_DEPTH, &ulInitial);
+	vDbncSetCallbacks(&g_tInputs, g_pfnInputCallbacks, tidEvents);
+
+	/* sleep until the first edge */
+	g_tidInputSample = tidSample;
+	vTaskSetState(tidSample, OFF);
+
+	GPIOIntTypeSet(BUTTONS_GPIO_BASE, ALL_BUTTONS, GPIO_BOTH_EDGES);
+	GPIOPinIntClear(BUTTONS_GPIO_BASE, ALL_BUTTONS);
+	GPIOPinIntEnable(BUTTONS_GPIO_BASE, ALL_BUTTONS);
+	IntEnable(INT_GPIOF);
+}
+
+/*! **********************************************************************************
+ * @fn		vInputsSetCallback
+ *
+ * @brief	Set the handler for debounced edges of one button
+ *
+ * @param	ucPin pin number on the button port (0..7)
+ *
+ * 			pfnCallback handler, called from the event task
+ *
+ */
+void vInputsSetCallback(unsigned char ucPin, tDbncCallback pfnCallback)
+{
+	vDbncSetCallback(&g_tInputs, ucPin, pfnCallback);
+}
+
+/*! **********************************************************************************
+ * @fn		ulInputsGetState
+ *
+ * @brief	Get debounced button state
+ *
+ * @return	bit mask of pressed buttons
+ */
+unsigned long ulInputsGetState(void)
+{
+	return ulDbncGetState(&g_tInputs, 0);
+}
+
+/*! **********************************************************************************
+ * @fn		vTaskInputSample
+ *
+ * @brief	debounce task, only runs between an edge and settling of the inputs
+ *
+ */
+void vTaskInputSample(void)
+{
+	unsigned long ulRaw = ulInputsRead();
+
+	ucDbncUpdate(&g_tInputs, &ulRaw);
+
+	if(!ucDbncIsSettled(&g_tInputs))
+		return;
+
+	/* all inputs stable -> go to sleep and wait for the next edge */
+	vTaskSetState(g_tidInputSample, OFF);
+	GPIOPinIntClear(BUTTONS_GPIO_BASE, ALL_BUTTONS);
+	GPIOPinIntEnable(BUTTONS_GPIO_BASE, ALL_BUTTONS);
+
+	/* an edge between the last sample and arming the interrupt would be lost,
+	   keep on sampling in that case */
+	if(ulInputsRead() != ulDbncGetState(&g_tInputs, 0))
+	{
+		GPIOPinIntDisable(BUTTONS_GPIO_BASE, ALL_BUTTONS);
+		vTaskInvokeDelayed(g_tidInputSample, INPUTS_SAMPLE_PERIOD);
+	}
+}
+
+/*! **********************************************************************************
+ * @fn		vTaskInputEvents
+ *
+ * @brief	calls the button callbacks, set READY by the debouncer on an edge
+ *
+ */
+void vTaskInputEvents(void)
+{
+	vDbncDispatch(&g_tInputs);
+}
+
+/*! **********************************************************************************
+ * @fn		GPIOPortFIntHandler
+ *
+ * @brief	edge on a button, wake the debounce task and mask further edges while sampling
+ *
+ */
+void GPIOPortFIntHandler(void)
+{
+	GPIOPinIntDisable(BUTTONS_GPIO_BASE, ALL_BUTTONS);
+	GPIOPinIntClear(BUTTONS_GPIO_BASE, ALL_BUTTONS);
+
+	vTaskSetState(g_tidInputSample, READY);
+}
@@ -7,7 +7,6 @@
 #include "inc/hw_memmap.h"
 #include "inc/hw_types.h"
 /* driverlib */
-#include "driverlib/systick.h"
 #include "driverlib/interrupt.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/gpio.h"
@@ -17,27 +16,42 @@
 #include "boards/ek-lm4f120xl/drivers/buttons.h"
 /* project */
 #include "inc/scheduler.h"
+#include "inc/inputs.h"
+#include "inc/uart_rx.h"
+#include "inc/scdl_boot.h"
+#include "scdl_port.h"
 
 
 
-#define TICKS_PER_SECOND 		1000
-
 void init(void);
+void InitConsole(void);
 void vTaskLED1(void);
 void vTaskLED2(void);
 void vTaskLED3(void);
-void vTaskButton(void);
 void vTaskUARTReceive(void);
+void vInitUART(void);
+void vInitButtons(void);
+static void vOnBootDone(const struct typScdlBootTimes *ptTimes);
 
 int main(void) {
 
+	vScdlBootInit();
+
+	/* only what the LED tasks need */
 	init();
 
-	tidCreateTask(vTaskLED1,1000);
-	tidCreateTask(vTaskLED2,500);
-	tidCreateTask(vTaskLED3,2000);
-	tidCreateTask(vTaskButton,25);
-	tidCreateTask(vTaskUARTReceive,50);
+	tidCreateTask(vTaskLED1,SCDL_MS_TO_TICKS(1000));
+	tidCreateTask(vTaskLED2,SCDL_MS_TO_TICKS(500));
+	tidCreateTask(vTaskLED3,SCDL_MS_TO_TICKS(2000));
+
+	/* the rest is brought up in this order by the boot task once the LEDs run */
+	vScdlBootDefer(InitConsole);
+	vScdlBootDefer(vInitUART);
+	vScdlBootDefer(vInitButtons);
+	vScdlBootStart(tidCreateTask(vTaskScdlBoot,SCDL_INF_PERIOD), vOnBootDone);
+
+	/* spread the releases of the 500/1000/2000 ms tasks */
+	vScdlAutoPhase(SCDL_DEFAULT);
 
 	vStartScheduler();
 	return 0;
@@ -59,38 +73,70 @@ void vTaskLED3(void)
 	GPIO_PORTF_DATA_R ^= 0x08;
 }
 
-void vTaskButton(void)
+static void vOnButton(unsigned short usInput, unsigned char ucPressed)
 {
-	static unsigned char delta, state;
-	unsigned long bstate = ButtonsPoll(&delta,&state);
+	if(!ucPressed)
+		return;
 
-	if(delta & bstate & LEFT_BUTTON)
+	if((1UL << usInput) == LEFT_BUTTON)
 	{
 		UARTprintf("Left\n");
 	}
-	else if(delta & bstate & RIGHT_BUTTON)
+	else if((1UL << usInput) == RIGHT_BUTTON)
 	{
 		UARTprintf("Right\n");
 	}
 }
 
+void vInitButtons(void)
+{
+	ButtonsInit();
+
+	/* sample task sleeps until a button edge occurs */
+	vInputsInit(tidCreateTask(vTaskInputSample,INPUTS_SAMPLE_PERIOD),
+				tidCreateTask(vTaskInputEvents,SCDL_INF_PERIOD));
+	vInputsSetCallback(0, vOnButton);	/* RIGHT_BUTTON, PF0 */
+	vInputsSetCallback(4, vOnButton);	/* LEFT_BUTTON, PF4 */
+}
+
+void vInitUART(void)
+{
+	/* woken by the UART0 interrupt with a whole batch */
+	vUartRxInit(tidCreateTask(vTaskUARTReceive,SCDL_INF_PERIOD));
+}
+
 void vTaskUARTReceive(void)
 {
-	unsigned char rxb;
+	const unsigned char *pucBatch;
+	unsigned short usLen, i;
 
-	while(UARTCharsAvail(UART0_BASE))
+	while((usLen = usUartRxGet(&pucBatch)) != 0)
 	{
-		rxb = UARTCharGet(UART0_BASE);
-		switch(rxb)
+		for(i = 0; i < usLen; i++)
 		{
-		case '1':
-			UARTprintf("Hello\n");
-			break;
+			switch(pucBatch[i])
+			{
+			case '1':
+				UARTprintf("Hello\n");
+				break;
 
+			}
 		}
+		vUartRxRelease();
 	}
 }
 
+static void vOnBootDone(const struct typScdlBootTimes *ptTimes)
+{
+	unsigned char i;
+
+	UARTprintf("boot: main %u us, scheduler %u us, first task %u us, initialized %u us\n",
+			SCDL_BOOT_CYCLES_TO_US(ptTimes->ulMain), SCDL_BOOT_CYCLES_TO_US(ptTimes->ulStart),
+			SCDL_BOOT_CYCLES_TO_US(ptTimes->ulFirstTask), SCDL_BOOT_CYCLES_TO_US(ptTimes->ulInitialized));
+	for(i = 0; i < ptTimes->ucStages; i++)
+		UARTprintf("boot: stage %u %u us\n", i, SCDL_BOOT_CYCLES_TO_US(ptTimes->aulStage[i]));
+}
+
 void InitConsole(void)
 {
 
@@ -125,23 +171,10 @@ void init(void)
     SysCtlClockSet(SYSCTL_SYSDIV_1 | SYSCTL_USE_OSC | SYSCTL_OSC_MAIN |
                    SYSCTL_XTAL_16MHZ);
 
-    InitConsole();
-
     vInitLED();
 
-    ButtonsInit();
-
-    SysTickPeriodSet(SysCtlClockGet()/TICKS_PER_SECOND);
-
     IntMasterEnable();
 
-    SysTickIntEnable();
-
-    SysTickEnable();
+    vScdlPortTickInit();
 }
 
-
-void SysTickIntHandler(void)
-{
-	vScdlTick1ms();
-}
@@ -0,0 +1,216 @@
+/**************************************************************************************************
+  Filename:       uart_rx.c
+  Author:         $Author: Menz $
+
+  Description:    Batched UART0 receive on the ping-pong DMA of uart_rx_hw.h. The interrupt hands
+                  full halves to the consumer task, at the receive timeout it cuts the active half
+                  short, appends the bytes still in the FIFO and lets the DMA go on in the other
+                  half. Halves are handed over strictly alternating, so the oldest batch is always
+                  the one after the last released. No hardware access here, the host simulation in
+                  ReSCoS/bench links it against a mock of the driver.
+
+**************************************************************************************************/
+
+
+/*! @file uart_rx.c */
+
+
+#include "inc/scdl_critical.h"
+#include "inc/uart_rx.h"
+
+
+#define UART_RX_HALF(i)			(1 << (i))
+
+static unsigned char g_aaucRxBuf[2][UART_RX_BATCH_LEN];
+/* length of the batch in each half, valid while the half is with the consumer */
+static unsigned short g_ausRxLen[2];
+
+/* halves with the consumer, the others are armed for the DMA */
+static volatile unsigned char g_ucRxHeld = 0;
+/* half the DMA writes to, and the oldest half of the consumer */
+static volatile unsigned char g_ucRxActive = 0;
+static volatile unsigned char g_ucRxHead = 0;
+/* the DMA stopped because both halves are held */
+static volatile unsigned char g_bRxStopped = 0;
+/* receive timeout masked until the next release, there was no half to go on with */
+static volatile unsigned char g_bRxTimeoutOff = 0;
+
+static volatile taskID_t g_tidRxConsumer = SCDL_NA;
+static struct typUartRxStats g_tRxStats;
+
+/*
+ * hand the active half to the consumer and move on to the other one, interrupts must be disabled
+ */
+static void vUartRxHandOver(unsigned short usLen)
+{
+	g_ausRxLen[g_ucRxActive] = usLen;
+	g_ucRxHeld |= UART_RX_HALF(g_ucRxActive);
+	g_ucRxActive ^= 1;
+
+	g_tRxStats.ulBytes += usLen;
+	g_tRxStats.ulBatches++;
+
+	if(g_ucRxHeld & UART_RX_HALF(g_ucRxActive))
+	{
+		/* the consumer is two batches behind */
+		g_bRxStopped = 1;
+		if(g_tRxStats.usStalls < 0xFFFF)
+			g_tRxStats.usStalls++;
+	}
+
+	vTaskSetState(g_tidRxConsumer, READY);
+}
+
+/*! **********************************************************************************
+ * @fn		vUartRxInit
+ *
+ * @brief	Start receiving, UART0 must have been configured by InitConsole
+ *
+ * @param	tidConsumer task calling usUartRxGet, period SCDL_INF_PERIOD
+ *
+ */
+void vUartRxInit(taskID_t tidConsumer)
+{
+	g_tidRxConsumer = tidConsumer;
+	g_ucRxHeld = 0;
+	g_ucRxActive = 0;
+	g_ucRxHead = 0;
+	g_bRxStopped = 0;
+	g_bRxTimeoutOff = 0;
+	g_tRxStats.ulBytes = 0;
+	g_tRxStats.ulBatches = 0;
+	g_tRxStats.usTimeouts = 0;
+	g_tRxStats.usStalls = 0;
+	g_tRxStats.usOverruns = 0;
+
+	vUartRxHwInit();
+	vUartRxHwArm(0, g_aaucRxBuf[0], UART_RX_BATCH_LEN);
+	vUartRxHwArm(1, g_aaucRxBuf[1], UART_RX_BATCH_LEN);
+	vUartRxHwResume(0);
+	vUartRxHwTimeout(1);
+	/* the console received since boot, an overrun may be pending, the ISR needs both halves armed */
+	vUartRxHwIrqEnable();
+}
+
+/*! **********************************************************************************
+ * @fn		usUartRxGet
+ *
+ * @brief	Get the oldest received batch. It stays valid and is returned again until
+ * 			vUartRxRelease.
+ *
+ * @param	ppucData set to the first byte of the batch
+ *
+ * @return	bytes in the batch, 0 if nothing was received
+ */
+unsigned short usUartRxGet(const unsigned char **ppucData)
+{
+	unsigned short usLen = 0;
+	scdlIrqState_t tIrqState;
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	if(g_ucRxHeld & UART_RX_HALF(g_ucRxHead))
+	{
+		*ppucData = g_aaucRxBuf[g_ucRxHead];
+		usLen = g_ausRxLen[g_ucRxHead];
+	}
+	SCDL_EXIT_CRITICAL(tIrqState);
+
+	return usLen;
+}
+
+/*! **********************************************************************************
+ * @fn		vUartRxRelease
+ *
+ * @brief	Return the batch of usUartRxGet to the DMA
+ *
+ */
+void vUartRxRelease(void)
+{
+	unsigned char ucHalf;
+	scdlIrqState_t tIrqState;
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	ucHalf = g_ucRxHead;
+	SCDL_ASSERT(g_ucRxHeld & UART_RX_HALF(ucHalf));
+
+	g_ucRxHeld &= ~UART_RX_HALF(ucHalf);
+	g_ucRxHead ^= 1;
+	vUartRxHwArm(ucHalf, g_aaucRxBuf[ucHalf], UART_RX_BATCH_LEN);
+
+	/* the DMA stops at a held half, possibly before the interrupt told us */
+	if(g_bRxStopped || !bUartRxHwRunning())
+	{
+		/* then it waits for exactly this half */
+		g_bRxStopped = 0;
+		vUartRxHwResume(ucHalf);
+	}
+	if(g_bRxTimeoutOff)
+	{
+		g_bRxTimeoutOff = 0;
+		vUartRxHwTimeout(1);
+	}
+	SCDL_EXIT_CRITICAL(tIrqState);
+}
+
+/*! **********************************************************************************
+ * @fn		vUartRxGetStats
+ *
+ * @brief	Copy the receive statistics
+ *
+ * @param	ptStats destination
+ *
+ */
+void vUartRxGetStats(struct typUartRxStats *ptStats)
+{
+	scdlIrqState_t tIrqState;
+
+	SCDL_ENTER_CRITICAL(tIrqState);
+	*ptStats = g_tRxStats;
+	SCDL_EXIT_CRITICAL(tIrqState);
+}
+
+/*! **********************************************************************************
+ * @fn		vUartRxIntHandler
+ *
+ * @brief	UART0 interrupt, raised by the DMA completing a half, the receive timeout
+ * 			and overruns
+ *
+ */
+void vUartRxIntHandler(void)
+{
+	unsigned char ucEvents = ucUartRxHwEvents();
+	unsigned short usLen;
+
+	if((ucEvents & UART_RX_HW_OVERRUN) && g_tRxStats.usOverruns < 0xFFFF)
+		g_tRxStats.usOverruns++;
+
+	/* the DMA switched to the other half by itself, or stopped if that is held */
+	while(!g_bRxStopped && bUartRxHwDone(g_ucRxActive))
+		vUartRxHandOver(UART_RX_BATCH_LEN);
+
+	if(!(ucEvents & UART_RX_HW_TIMEOUT))
+		return;
+
+	if(g_bRxStopped || (g_ucRxHeld & UART_RX_HALF(g_ucRxActive ^ 1)))
+	{
+		/* no half to go on with, vUartRxRelease takes up the timeout again */
+		g_bRxTimeoutOff = 1;
+		vUartRxHwTimeout(0);
+		return;
+	}
+
+	/* idle line, the batch ends with the bytes the DMA left in the FIFO */
+	usLen = UART_RX_BATCH_LEN - usUartRxHwCut(g_ucRxActive);
+	usLen += usUartRxHwDrain(&g_aaucRxBuf[g_ucRxActive][usLen], UART_RX_BATCH_LEN - usLen);
+
+	if(usLen)
+	{
+		if(usLen < UART_RX_BATCH_LEN && g_tRxStats.usTimeouts < 0xFFFF)
+			g_tRxStats.usTimeouts++;
+		vUartRxHandOver(usLen);
+	}
+	else
+		vUartRxHwArm(g_ucRxActive, g_aaucRxBuf[g_ucRxActive], UART_RX_BATCH_LEN);
+
+	vUartRxHwResume(g_ucRxActive);
+}
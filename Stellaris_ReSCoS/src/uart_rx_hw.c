@@ -0,0 +1,223 @@
+/**************************************************************************************************
+  Filename:       uart_rx_hw.c
+  Author:         $Author: Menz $
+
+  Description:    uDMA driver of uart_rx_hw.h for UART0 on the LM4F120. Channel 8 moves the
+                  received bytes in bursts of 8 at the FIFO level 4/8, single requests are masked,
+                  so fewer bytes wait in the FIFO and raise the receive timeout. Completion of a
+                  ping-pong half is signalled on the UART0 interrupt.
+
+**************************************************************************************************/
+
+
+/*! @file uart_rx_hw.c */
+
+
+/* low level */
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_ints.h"
+#include "inc/hw_uart.h"
+/* driverlib */
+#include "driverlib/interrupt.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/uart.h"
+#include "driverlib/udma.h"
+/* project */
+#include "inc/uart_rx_hw.h"
+
+
+#define UART_RX_DMA_CHANNEL		UDMA_CHANNEL_UART0RX
+#define UART_RX_DMA_SELECT(h)	(UART_RX_DMA_CHANNEL | ((h) ? UDMA_ALT_SELECT : UDMA_PRI_SELECT))
+#define UART_RX_DMA_SRC			((void *)(UART0_BASE + UART_O_DR))
+
+/* control table of all channels, primary and alternate */
+#pragma DATA_ALIGN(g_aucDmaControl, 1024)
+static unsigned char g_aucDmaControl[1024];
+
+static unsigned char *g_apucHwBuf[2];
+
+/*! **********************************************************************************
+ * @fn		vUartRxHwInit
+ *
+ * @brief	Set up the DMA channel and the UART0 interrupt sources, the channel and the
+ * 			interrupt stay disabled
+ *
+ */
+void vUartRxHwInit(void)
+{
+	SysCtlPeripheralEnable(SYSCTL_PERIPH_UDMA);
+	uDMAEnable();
+	uDMAControlBaseSet(g_aucDmaControl);
+
+	uDMAChannelAssign(UDMA_CH8_UART0RX);
+	uDMAChannelAttributeDisable(UART_RX_DMA_CHANNEL, UDMA_ATTR_ALTSELECT | UDMA_ATTR_HIGH_PRIORITY |
+								UDMA_ATTR_REQMASK);
+	/* bursts only, the rest is left to the receive timeout */
+	uDMAChannelAttributeEnable(UART_RX_DMA_CHANNEL, UDMA_ATTR_USEBURST);
+	uDMAChannelControlSet(UART_RX_DMA_SELECT(0), UDMA_SIZE_8 | UDMA_SRC_INC_NONE | UDMA_DST_INC_8 | UDMA_ARB_8);
+	uDMAChannelControlSet(UART_RX_DMA_SELECT(1), UDMA_SIZE_8 | UDMA_SRC_INC_NONE | UDMA_DST_INC_8 | UDMA_ARB_8);
+
+	UARTFIFOLevelSet(UART0_BASE, UART_FIFO_TX4_8, UART_FIFO_RX4_8);
+	UARTDMAEnable(UART0_BASE, UART_DMA_RX);
+
+	UARTIntClear(UART0_BASE, UART_INT_RT | UART_INT_OE);
+	UARTIntEnable(UART0_BASE, UART_INT_OE);
+}
+
+/*! **********************************************************************************
+ * @fn		vUartRxHwIrqEnable
+ *
+ * @brief	Enable the UART0 interrupt, both halves must be armed, a pending overrun
+ * 			is taken at once
+ *
+ */
+void vUartRxHwIrqEnable(void)
+{
+	IntEnable(INT_UART0);
+}
+
+/*! **********************************************************************************
+ * @fn		vUartRxHwArm
+ *
+ * @brief	Give a half to the DMA, it is used when the other half is complete or by
+ * 			vUartRxHwResume
+ *
+ * @param	ucHalf 0 or 1
+ *
+ * 			pucBuf destination
+ *
+ * 			usLen bytes, a multiple of UART_RX_HW_BURST
+ *
+ */
+void vUartRxHwArm(unsigned char ucHalf, unsigned char *pucBuf, unsigned short usLen)
+{
+	g_apucHwBuf[ucHalf] = pucBuf;
+	uDMAChannelTransferSet(UART_RX_DMA_SELECT(ucHalf), UDMA_MODE_PINGPONG, UART_RX_DMA_SRC, pucBuf, usLen);
+}
+
+/*! **********************************************************************************
+ * @fn		bUartRxHwDone
+ *
+ * @brief	Check if the DMA completed an armed half
+ *
+ * @param	ucHalf 0 or 1
+ *
+ * @return	1 if the half is full
+ */
+unsigned char bUartRxHwDone(unsigned char ucHalf)
+{
+	return (uDMAChannelModeGet(UART_RX_DMA_SELECT(ucHalf)) == UDMA_MODE_STOP);
+}
+
+/*! **********************************************************************************
+ * @fn		usUartRxHwCut
+ *
+ * @brief	Stop the channel and take a half away from the DMA
+ *
+ * @param	ucHalf the active half
+ *
+ * @return	bytes the DMA did not write
+ */
+unsigned short usUartRxHwCut(unsigned char ucHalf)
+{
+	unsigned short usLeft;
+
+	uDMAChannelDisable(UART_RX_DMA_CHANNEL);
+	usLeft = (unsigned short)uDMAChannelSizeGet(UART_RX_DMA_SELECT(ucHalf));
+	/* not continued after the other half */
+	uDMAChannelTransferSet(UART_RX_DMA_SELECT(ucHalf), UDMA_MODE_STOP, UART_RX_DMA_SRC, g_apucHwBuf[ucHalf], 1);
+
+	return usLeft;
+}
+
+/*! **********************************************************************************
+ * @fn		vUartRxHwResume
+ *
+ * @brief	Let the DMA go on with a half, harmless if it runs there already
+ *
+ * @param	ucHalf armed half
+ *
+ */
+void vUartRxHwResume(unsigned char ucHalf)
+{
+	if(ucHalf)
+		uDMAChannelAttributeEnable(UART_RX_DMA_CHANNEL, UDMA_ATTR_ALTSELECT);
+	else
+		uDMAChannelAttributeDisable(UART_RX_DMA_CHANNEL, UDMA_ATTR_ALTSELECT);
+	uDMAChannelEnable(UART_RX_DMA_CHANNEL);
+}
+
+/*! **********************************************************************************
+ * @fn		bUartRxHwRunning
+ *
+ * @brief	Check if the channel is enabled, the DMA disables it at a half not armed
+ *
+ * @return	1 if enabled
+ */
+unsigned char bUartRxHwRunning(void)
+{
+	return uDMAChannelIsEnabled(UART_RX_DMA_CHANNEL) ? 1 : 0;
+}
+
+/*! **********************************************************************************
+ * @fn		usUartRxHwDrain
+ *
+ * @brief	Read the bytes left in the FIFO, the channel must be stopped
+ *
+ * @param	pucDst destination
+ *
+ * 			usMax space at pucDst
+ *
+ * @return	bytes read
+ */
+unsigned short usUartRxHwDrain(unsigned char *pucDst, unsigned short usMax)
+{
+	unsigned short usLen = 0;
+
+	while(usLen < usMax && UARTCharsAvail(UART0_BASE))
+		pucDst[usLen++] = (unsigned char)UARTCharGetNonBlocking(UART0_BASE);
+
+	return usLen;
+}
+
+/*! **********************************************************************************
+ * @fn		ucUartRxHwEvents
+ *
+ * @brief	Read and clear the pending interrupts, called once per interrupt
+ *
+ * @return	UART_RX_HW_TIMEOUT, UART_RX_HW_OVERRUN
+ */
+unsigned char ucUartRxHwEvents(void)
+{
+	unsigned long ulStatus = UARTIntStatus(UART0_BASE, true);
+	unsigned char ucEvents = 0;
+
+	UARTIntClear(UART0_BASE, ulStatus);
+
+	if(ulStatus & UART_INT_RT)
+		ucEvents |= UART_RX_HW_TIMEOUT;
+	if(ulStatus & UART_INT_OE)
+	{
+		UARTRxErrorClear(UART0_BASE);
+		ucEvents |= UART_RX_HW_OVERRUN;
+	}
+
+	return ucEvents;
+}
+
+/*! **********************************************************************************
+ * @fn		vUartRxHwTimeout
+ *
+ * @brief	Enable or mask the receive timeout interrupt
+ *
+ * @param	bEnable 1 to enable
+ *
+ */
+void vUartRxHwTimeout(unsigned char bEnable)
+{
+	if(bEnable)
+		UARTIntEnable(UART0_BASE, UART_INT_RT);
+	else
+		UARTIntDisable(UART0_BASE, UART_INT_RT);
+}